@@ -0,0 +1,221 @@
+//
+//  AllocTracker.cpp
+//  CloudSim
+//
+//  Heap allocation tracking per scheduler callback, for make simulator-alloc.
+//  Replaces the global operator new and delete, aligned forms included, and
+//  wraps the scheduler callbacks with -Wl,--wrap (CallbackWrap.h), so every allocation is
+//  charged to the innermost callback running when it happens. That includes
+//  what the simulator allocates inside the commands the callback issues, and
+//  the to_string temporaries of SimOutput messages that are never printed.
+//  Allocations outside any callback (the simulator's own event loop) are
+//  charged to "Simulator".
+//
+//  At the end of SimulationComplete it prints, on stderr, per callback: calls,
+//  allocations and bytes in total, per call on average, and the most in one
+//  call; then the run's peak live heap and its steady-state heap, the mean of
+//  the live heap sampled at the SchedulerCheck calls in the second half of the
+//  run. With CLOUDSIM_STATS the same figures are appended as "alloc.*" lines.
+//
+//  CLOUDSIM_ALLOC_LIMITS=HandleNewTask=0,SchedulerCheck=50 turns per-call
+//  limits into an invariant: if any single call of a listed callback made more
+//  allocations than its limit, the violations are printed and the simulator
+//  exits with status 3.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <malloc.h>
+#include <new>
+#include <vector>
+
+#include "CallbackWrap.h"
+
+#define ALLOC_SIMULATOR NUM_CALLBACKS           // Outside any callback
+#define ALLOC_SLOTS (NUM_CALLBACKS + 1)
+
+struct AllocCounters {
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t most_allocations = 0;              // In one call
+    uint64_t most_bytes = 0;
+};
+
+static AllocCounters counters[ALLOC_SLOTS];
+
+// The innermost callback's counts so far, or the simulator's for the whole run
+// outside callbacks; nested callbacks save and restore them
+static unsigned current = ALLOC_SIMULATOR;
+static uint64_t call_allocations = 0;
+static uint64_t call_bytes = 0;
+
+static uint64_t live_bytes = 0;
+static uint64_t peak_bytes = 0;
+static vector<pair<Time_t, uint64_t>> * samples = nullptr;     // (time, live) at SchedulerCheck
+static bool untracked = false;                                  // Set while the tracker allocates itself
+
+// alignment 0 for the default new alignment
+static void * Allocate(size_t size, size_t alignment = 0) {
+    if (size == 0) size = 1;
+    // aligned_alloc wants the size rounded up to the alignment
+    void * p = alignment ? aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : malloc(size);
+    if (p == nullptr) throw bad_alloc();
+    if (untracked) return p;
+    size_t usable = malloc_usable_size(p);
+    live_bytes += usable;
+    if (live_bytes > peak_bytes) peak_bytes = live_bytes;
+    call_allocations++;
+    call_bytes += size;
+    return p;
+}
+
+static void Release(void * p) {
+    if (p == nullptr) return;
+    if (!untracked) live_bytes -= malloc_usable_size(p);
+    free(p);
+}
+
+void * operator new(size_t size) { return Allocate(size); }
+void * operator new[](size_t size) { return Allocate(size); }
+void * operator new(size_t size, const nothrow_t &) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void * operator new[](size_t size, const nothrow_t &) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void * p) noexcept { Release(p); }
+void operator delete[](void * p) noexcept { Release(p); }
+void operator delete(void * p, size_t) noexcept { Release(p); }
+void operator delete[](void * p, size_t) noexcept { Release(p); }
+void * operator new(size_t size, align_val_t alignment) { return Allocate(size, size_t(alignment)); }
+void * operator new[](size_t size, align_val_t alignment) { return Allocate(size, size_t(alignment)); }
+void * operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    try { return Allocate(size, size_t(alignment)); } catch (...) { return nullptr; }
+}
+void * operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    try { return Allocate(size, size_t(alignment)); } catch (...) { return nullptr; }
+}
+void operator delete(void * p, align_val_t) noexcept { Release(p); }
+void operator delete[](void * p, align_val_t) noexcept { Release(p); }
+void operator delete(void * p, size_t, align_val_t) noexcept { Release(p); }
+void operator delete[](void * p, size_t, align_val_t) noexcept { Release(p); }
+
+static const char * SlotName(unsigned slot) {
+    return slot == ALLOC_SIMULATOR ? "Simulator" : CallbackName(SchedulerCallback_t(slot));
+}
+
+static void Report(Time_t end_time);
+
+// Charges what the callback allocates to it; at SchedulerCheck it first samples
+// the live heap, and the outermost SimulationComplete prints the report
+template <typename Call>
+static void Wrapped(SchedulerCallback_t callback, Time_t time, unsigned, Call call) {
+    if (callback == CB_SCHEDULER_CHECK) {
+        untracked = true;
+        if (samples == nullptr) samples = new vector<pair<Time_t, uint64_t>>();
+        samples->push_back({time, live_bytes});
+        untracked = false;
+    }
+    unsigned outer = current;
+    uint64_t outer_allocations = call_allocations, outer_bytes = call_bytes;
+    current = callback;
+    call_allocations = call_bytes = 0;
+    call();
+    AllocCounters & c = counters[callback];
+    c.calls++;
+    c.allocations += call_allocations;
+    c.bytes += call_bytes;
+    if (call_allocations > c.most_allocations) c.most_allocations = call_allocations;
+    if (call_bytes > c.most_bytes) c.most_bytes = call_bytes;
+    // The outer callback goes on counting from what it had
+    current = outer;
+    call_allocations = outer_allocations;
+    call_bytes = outer_bytes;
+    if (callback == CB_SIMULATION_COMPLETE && current == ALLOC_SIMULATOR) Report(time);
+}
+
+// "Name=limit,Name=limit"
+static vector<pair<unsigned, uint64_t>> ParseLimits(const char * text) {
+    vector<pair<unsigned, uint64_t>> limits;
+    string spec = text;
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == string::npos) end = spec.size();
+        string item = spec.substr(start, end - start);
+        size_t equals = item.find('=');
+        bool found = false;
+        for (unsigned c = 0; c < NUM_CALLBACKS && equals != string::npos; c++) {
+            if (item.compare(0, equals, CallbackName(SchedulerCallback_t(c))) == 0) {
+                limits.push_back({c, strtoull(item.c_str() + equals + 1, nullptr, 10)});
+                found = true;
+            }
+        }
+        if (!found) fprintf(stderr, "AllocTracker: ignoring CLOUDSIM_ALLOC_LIMITS entry \"%s\"\n", item.c_str());
+        start = end + 1;
+    }
+    return limits;
+}
+
+static void Report(Time_t end_time) {
+    untracked = true;
+    counters[ALLOC_SIMULATOR].allocations = call_allocations;
+    counters[ALLOC_SIMULATOR].bytes = call_bytes;
+
+    // Steady state: mean live heap at the SchedulerCheck calls of the second half
+    uint64_t steady = live_bytes, sum = 0, n = 0;
+    if (samples) {
+        for (auto & s : *samples) {
+            if (s.first * 2 < end_time) continue;
+            sum += s.second;
+            n++;
+        }
+        if (n) steady = sum / n;
+    }
+
+    fprintf(stderr, "Heap allocations per callback (bytes requested):\n");
+    fprintf(stderr, "  %-22s %10s %14s %16s %12s %12s %10s %12s\n", "Callback", "Calls", "Allocations", "Bytes",
+            "Allocs/call", "Bytes/call", "Most", "Most bytes");
+    for (unsigned s = 0; s < ALLOC_SLOTS; s++) {
+        const AllocCounters & c = counters[s];
+        if (c.allocations == 0 && c.calls == 0) continue;
+        double per = c.calls ? double(c.allocations) / c.calls : 0, bytes_per = c.calls ? double(c.bytes) / c.calls : 0;
+        fprintf(stderr, "  %-22s %10llu %14llu %16llu %12.2f %12.1f %10llu %12llu\n", SlotName(s), (unsigned long long) c.calls,
+                (unsigned long long) c.allocations, (unsigned long long) c.bytes, per, bytes_per,
+                (unsigned long long) c.most_allocations, (unsigned long long) c.most_bytes);
+    }
+    fprintf(stderr, "Peak heap %llu bytes, steady state %llu bytes, live at end %llu bytes\n",
+            (unsigned long long) peak_bytes, (unsigned long long) steady, (unsigned long long) live_bytes);
+
+    const char * stats = getenv("CLOUDSIM_STATS");
+    if (stats && *stats) {
+        ofstream out(stats, ios::app);
+        for (unsigned s = 0; s < ALLOC_SLOTS; s++) {
+            const AllocCounters & c = counters[s];
+            if (c.allocations == 0 && c.calls == 0) continue;
+            out << "alloc." << SlotName(s) << ".allocations " << c.allocations << endl;
+            out << "alloc." << SlotName(s) << ".bytes " << c.bytes << endl;
+            out << "alloc." << SlotName(s) << ".most_allocations " << c.most_allocations << endl;
+        }
+        out << "alloc.peak_bytes " << peak_bytes << endl;
+        out << "alloc.steady_bytes " << steady << endl;
+    }
+
+    const char * limits = getenv("CLOUDSIM_ALLOC_LIMITS");
+    if (limits && *limits) {
+        unsigned violations = 0;
+        for (auto & limit : ParseLimits(limits)) {
+            const AllocCounters & c = counters[limit.first];
+            if (c.most_allocations <= limit.second) continue;
+            fprintf(stderr, "AllocTracker: %s made %llu allocations in one call, limit %llu\n", SlotName(limit.first),
+                    (unsigned long long) c.most_allocations, (unsigned long long) limit.second);
+            violations++;
+        }
+        if (violations) exit(3);
+    }
+}
+
+DEFINE_CALLBACK_WRAPS
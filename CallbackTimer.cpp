@@ -0,0 +1,27 @@
+//
+//  CallbackTimer.cpp
+//  CloudSim
+//
+//  Measures the CPU time the scheduler spends in its callbacks without touching
+//  the scheduler source, so it works for any Algos/ variant. The variants
+//  predate the hooks and open no CallbackScope of their own; linking with
+//  CALLBACK_WRAP routes every call the simulator makes to a callback through
+//  the __wrap_ functions below (CallbackWrap.h), which open one around the
+//  real callback. The scope does the timing and, when CLOUDSIM_STATS names a
+//  file, writes scheduler_cpu_s with the rest of the callback profile
+//  (InterfaceHooks.h).
+//
+//  Only the policy matrix binaries (make algos) link this. The current
+//  Scheduler.cpp opens its own scopes, so simulator-current does not.
+//
+
+#include "CallbackWrap.h"
+#include "InterfaceHooks.h"
+
+template <typename Call>
+static void Wrapped(SchedulerCallback_t callback, Time_t time, unsigned subject, Call call) {
+    CallbackScope scope(callback, callback == CB_INIT ? (Now)() : time, subject);
+    call();
+}
+
+DEFINE_CALLBACK_WRAPS
@@ -0,0 +1,328 @@
+//
+//  CallbackTrace.cpp
+//  CloudSim
+//
+
+#include "CallbackTrace.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Varint.hpp"
+
+static const char magic[4] = {'C', 'S', 'C', 'T'};
+static const char version = 1;
+
+TraceResponse_t ResponseKind(InterfaceCall_t call) {
+    switch (call) {
+        case CALL_MACHINE_GET_INFO:             return RESPONSE_MACHINE;
+        case CALL_VM_GET_INFO:                  return RESPONSE_VM;
+        case CALL_GET_TASK_INFO:                return RESPONSE_TASK;
+        case CALL_MACHINE_GET_CLUSTER_ENERGY:
+        case CALL_GET_SLA_REPORT:               return RESPONSE_REAL;
+        case CALL_VM_CREATE:                    return RESPONSE_VALUE;
+        default:
+            return IsCommand(call) ? RESPONSE_NONE : RESPONSE_VALUE;
+    }
+}
+
+// Field-mask delta coding of the info structs. Each Put* writes the fields of
+// 'now' that differ from 'base' and then makes base equal to now; each Get*
+// applies such a record to base. Writer and reader keep identical bases.
+
+static void PutVector(string & out, const vector<unsigned> & v) {
+    PutVarint(out, v.size());
+    for (unsigned x : v) PutVarint(out, x);
+}
+
+static void GetVector(istream & in, vector<unsigned> & v) {
+    uint64_t size, x;
+    if (!GetVarint(in, size) || size > (1 << 20)) throw runtime_error("TraceReader: corrupt vector");
+    v.resize(size);
+    for (auto & item : v) {
+        if (!GetVarint(in, x)) throw runtime_error("TraceReader: truncated vector");
+        item = unsigned(x);
+    }
+}
+
+static uint64_t GetValue(istream & in) {
+    uint64_t value;
+    if (!GetVarint(in, value)) throw runtime_error("TraceReader: truncated record");
+    return value;
+}
+
+static void PutMachine(string & out, MachineInfo_t & base, const MachineInfo_t & now) {
+    uint64_t mask = 0;
+    if (now.num_cpus != base.num_cpus)          mask |= 1 << 0;
+    if (now.cpu != base.cpu)                    mask |= 1 << 1;
+    if (now.memory_size != base.memory_size)    mask |= 1 << 2;
+    if (now.memory_used != base.memory_used)    mask |= 1 << 3;
+    if (now.active_tasks != base.active_tasks)  mask |= 1 << 4;
+    if (now.active_vms != base.active_vms)      mask |= 1 << 5;
+    if (now.gpus != base.gpus)                  mask |= 1 << 6;
+    if (now.energy_consumed != base.energy_consumed) mask |= 1 << 7;
+    if (now.performance != base.performance)    mask |= 1 << 8;
+    if (now.c_states != base.c_states)          mask |= 1 << 9;
+    if (now.p_states != base.p_states)          mask |= 1 << 10;
+    if (now.s_states != base.s_states)          mask |= 1 << 11;
+    if (now.s_state != base.s_state)            mask |= 1 << 12;
+    if (now.p_state != base.p_state)            mask |= 1 << 13;
+    if (now.machine_id != base.machine_id)      mask |= 1 << 14;
+    PutVarint(out, mask);
+    if (mask & (1 << 0))  PutVarint(out, now.num_cpus);
+    if (mask & (1 << 1))  PutVarint(out, now.cpu);
+    if (mask & (1 << 2))  PutVarint(out, now.memory_size);
+    if (mask & (1 << 3))  PutVarint(out, now.memory_used);
+    if (mask & (1 << 4))  PutVarint(out, now.active_tasks);
+    if (mask & (1 << 5))  PutVarint(out, now.active_vms);
+    if (mask & (1 << 6))  PutVarint(out, now.gpus);
+    if (mask & (1 << 7))  PutVarint(out, now.energy_consumed);
+    if (mask & (1 << 8))  PutVector(out, now.performance);
+    if (mask & (1 << 9))  PutVector(out, now.c_states);
+    if (mask & (1 << 10)) PutVector(out, now.p_states);
+    if (mask & (1 << 11)) PutVector(out, now.s_states);
+    if (mask & (1 << 12)) PutVarint(out, now.s_state);
+    if (mask & (1 << 13)) PutVarint(out, now.p_state);
+    if (mask & (1 << 14)) PutVarint(out, now.machine_id);
+    base = now;
+}
+
+static bool GetMachine(istream & in, MachineInfo_t & base) {
+    uint64_t mask = GetValue(in);
+    if (mask & (1 << 0))  base.num_cpus = unsigned(GetValue(in));
+    if (mask & (1 << 1))  base.cpu = CPUType_t(GetValue(in));
+    if (mask & (1 << 2))  base.memory_size = unsigned(GetValue(in));
+    if (mask & (1 << 3))  base.memory_used = unsigned(GetValue(in));
+    if (mask & (1 << 4))  base.active_tasks = unsigned(GetValue(in));
+    if (mask & (1 << 5))  base.active_vms = unsigned(GetValue(in));
+    if (mask & (1 << 6))  base.gpus = GetValue(in) != 0;
+    if (mask & (1 << 7))  base.energy_consumed = GetValue(in);
+    if (mask & (1 << 8))  GetVector(in, base.performance);
+    if (mask & (1 << 9))  GetVector(in, base.c_states);
+    if (mask & (1 << 10)) GetVector(in, base.p_states);
+    if (mask & (1 << 11)) GetVector(in, base.s_states);
+    if (mask & (1 << 12)) base.s_state = MachineState_t(GetValue(in));
+    if (mask & (1 << 13)) base.p_state = CPUPerformance_t(GetValue(in));
+    if (mask & (1 << 14)) base.machine_id = MachineId_t(GetValue(in));
+    return mask != 0;
+}
+
+static void PutVM(string & out, VMInfo_t & base, const VMInfo_t & now) {
+    uint64_t mask = 0;
+    if (now.active_tasks != base.active_tasks)  mask |= 1 << 0;
+    if (now.cpu != base.cpu)                    mask |= 1 << 1;
+    if (now.machine_id != base.machine_id)      mask |= 1 << 2;
+    if (now.vm_id != base.vm_id)                mask |= 1 << 3;
+    if (now.vm_type != base.vm_type)            mask |= 1 << 4;
+    PutVarint(out, mask);
+    if (mask & (1 << 0)) PutVector(out, now.active_tasks);
+    if (mask & (1 << 1)) PutVarint(out, now.cpu);
+    if (mask & (1 << 2)) PutVarint(out, now.machine_id);
+    if (mask & (1 << 3)) PutVarint(out, now.vm_id);
+    if (mask & (1 << 4)) PutVarint(out, now.vm_type);
+    base = now;
+}
+
+static bool GetVM(istream & in, VMInfo_t & base) {
+    uint64_t mask = GetValue(in);
+    if (mask & (1 << 0)) GetVector(in, base.active_tasks);
+    if (mask & (1 << 1)) base.cpu = CPUType_t(GetValue(in));
+    if (mask & (1 << 2)) base.machine_id = MachineId_t(GetValue(in));
+    if (mask & (1 << 3)) base.vm_id = VMId_t(GetValue(in));
+    if (mask & (1 << 4)) base.vm_type = VMType_t(GetValue(in));
+    return mask != 0;
+}
+
+static void PutTask(string & out, TaskInfo_t & base, const TaskInfo_t & now) {
+    uint64_t mask = 0;
+    if (now.completed != base.completed)                    mask |= 1 << 0;
+    if (now.total_instructions != base.total_instructions)  mask |= 1 << 1;
+    if (now.remaining_instructions != base.remaining_instructions) mask |= 1 << 2;
+    if (now.arrival != base.arrival)                        mask |= 1 << 3;
+    if (now.completion != base.completion)                  mask |= 1 << 4;
+    if (now.target_completion != base.target_completion)    mask |= 1 << 5;
+    if (now.gpu_capable != base.gpu_capable)                mask |= 1 << 6;
+    if (now.priority != base.priority)                      mask |= 1 << 7;
+    if (now.required_cpu != base.required_cpu)              mask |= 1 << 8;
+    if (now.required_memory != base.required_memory)        mask |= 1 << 9;
+    if (now.required_sla != base.required_sla)              mask |= 1 << 10;
+    if (now.required_vm != base.required_vm)                mask |= 1 << 11;
+    if (now.task_id != base.task_id)                        mask |= 1 << 12;
+    PutVarint(out, mask);
+    if (mask & (1 << 0))  PutVarint(out, now.completed);
+    if (mask & (1 << 1))  PutVarint(out, now.total_instructions);
+    if (mask & (1 << 2))  PutVarint(out, now.remaining_instructions);
+    if (mask & (1 << 3))  PutVarint(out, now.arrival);
+    if (mask & (1 << 4))  PutVarint(out, now.completion);
+    if (mask & (1 << 5))  PutVarint(out, now.target_completion);
+    if (mask & (1 << 6))  PutVarint(out, now.gpu_capable);
+    if (mask & (1 << 7))  PutVarint(out, now.priority);
+    if (mask & (1 << 8))  PutVarint(out, now.required_cpu);
+    if (mask & (1 << 9))  PutVarint(out, now.required_memory);
+    if (mask & (1 << 10)) PutVarint(out, now.required_sla);
+    if (mask & (1 << 11)) PutVarint(out, now.required_vm);
+    if (mask & (1 << 12)) PutVarint(out, now.task_id);
+    base = now;
+}
+
+static bool GetTask(istream & in, TaskInfo_t & base) {
+    uint64_t mask = GetValue(in);
+    if (mask & (1 << 0))  base.completed = GetValue(in) != 0;
+    if (mask & (1 << 1))  base.total_instructions = GetValue(in);
+    if (mask & (1 << 2))  base.remaining_instructions = GetValue(in);
+    if (mask & (1 << 3))  base.arrival = GetValue(in);
+    if (mask & (1 << 4))  base.completion = GetValue(in);
+    if (mask & (1 << 5))  base.target_completion = GetValue(in);
+    if (mask & (1 << 6))  base.gpu_capable = GetValue(in) != 0;
+    if (mask & (1 << 7))  base.priority = Priority_t(GetValue(in));
+    if (mask & (1 << 8))  base.required_cpu = CPUType_t(GetValue(in));
+    if (mask & (1 << 9))  base.required_memory = unsigned(GetValue(in));
+    if (mask & (1 << 10)) base.required_sla = SLAType_t(GetValue(in));
+    if (mask & (1 << 11)) base.required_vm = VMType_t(GetValue(in));
+    if (mask & (1 << 12)) base.task_id = TaskId_t(GetValue(in));
+    return mask != 0;
+}
+
+template <typename T>
+static T & BaseFor(vector<T> & bases, unsigned id) {
+    if (id >= bases.size()) bases.resize(size_t(id) + 1, T{});
+    return bases[id];
+}
+
+bool TraceWriter::Open(const string & filename) {
+    out.open(filename, ios::binary | ios::trunc);
+    if (!out) return false;
+    out.write(magic, sizeof(magic));
+    out.put(version);
+    return true;
+}
+
+void TraceWriter::Close() {
+    if (!out.is_open()) return;
+    Flush(true);
+    out.close();
+}
+
+void TraceWriter::Flush(bool force) {
+    if (force || buffer.size() >= (1 << 20)) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void TraceWriter::Begin(SchedulerCallback_t callback, Time_t time, unsigned subject) {
+    buffer.push_back('B');
+    buffer.push_back(char(callback));
+    PutSignedVarint(buffer, int64_t(time - last_time));
+    PutVarint(buffer, subject);
+    last_time = time;
+}
+
+void TraceWriter::End() {
+    buffer.push_back('E');
+    Flush(false);
+}
+
+void TraceWriter::Call(InterfaceCall_t call, unsigned a0, unsigned a1, unsigned a2) {
+    unsigned args[3] = {a0, a1, a2};
+    buffer.push_back('C');
+    buffer.push_back(char(call));
+    for (unsigned i = 0; i < InterfaceCallArgs(call); i++) PutVarint(buffer, args[i]);
+    pending_id = a0;
+}
+
+void TraceWriter::Value(uint64_t value) {
+    PutVarint(buffer, value);
+}
+
+void TraceWriter::Real(double value) {
+    char bytes[sizeof(double)];
+    memcpy(bytes, &value, sizeof(double));
+    buffer.append(bytes, sizeof(double));
+}
+
+void TraceWriter::Machine(const MachineInfo_t & info) {
+    PutMachine(buffer, BaseFor(machines, pending_id), info);
+}
+
+void TraceWriter::VM(const VMInfo_t & info) {
+    PutVM(buffer, BaseFor(vms, pending_id), info);
+}
+
+void TraceWriter::Task(const TaskInfo_t & info) {
+    PutTask(buffer, BaseFor(tasks, pending_id), info);
+}
+
+void TraceReader::Open(const string & filename) {
+    in.open(filename, ios::binary);
+    if (!in) throw runtime_error("TraceReader::Open(): could not open " + filename);
+    char header[5];
+    if (!in.read(header, sizeof(header)) || memcmp(header, magic, sizeof(magic)) != 0) {
+        throw runtime_error("TraceReader::Open(): " + filename + " is not a callback trace");
+    }
+    if (header[4] != version) {
+        throw runtime_error("TraceReader::Open(): " + filename + " has unsupported version " + to_string(int(header[4])));
+    }
+}
+
+bool TraceReader::Next(TraceEvent & e) {
+    int tag = in.get();
+    if (tag == EOF) return false;
+    if (tag == 'E') {
+        e.kind = TraceEvent::END;
+        return true;
+    }
+    if (tag == 'B') {
+        int callback = in.get();
+        int64_t delta;
+        if (callback == EOF || callback >= NUM_CALLBACKS || !GetSignedVarint(in, delta)) {
+            throw runtime_error("TraceReader::Next(): corrupt callback record");
+        }
+        e.kind = TraceEvent::BEGIN;
+        e.callback = SchedulerCallback_t(callback);
+        e.time = last_time += delta;
+        e.subject = unsigned(GetValue(in));
+        return true;
+    }
+    if (tag != 'C') throw runtime_error("TraceReader::Next(): corrupt trace, unknown tag " + to_string(tag));
+
+    int call = in.get();
+    if (call == EOF || call >= NUM_INTERFACE_CALLS) throw runtime_error("TraceReader::Next(): corrupt call record");
+    e.kind = TraceEvent::CALL;
+    e.call = InterfaceCall_t(call);
+    e.args[0] = e.args[1] = e.args[2] = 0;
+    for (unsigned i = 0; i < InterfaceCallArgs(e.call); i++) e.args[i] = unsigned(GetValue(in));
+
+    switch (ResponseKind(e.call)) {
+        case RESPONSE_NONE:
+            break;
+        case RESPONSE_VALUE:
+            e.value = GetValue(in);
+            break;
+        case RESPONSE_REAL: {
+            char bytes[sizeof(double)];
+            if (!in.read(bytes, sizeof(double))) throw runtime_error("TraceReader::Next(): truncated record");
+            memcpy(&e.real, bytes, sizeof(double));
+            break;
+        }
+        case RESPONSE_MACHINE: {
+            MachineInfo_t & base = BaseFor(machines, e.args[0]);
+            e.changed = GetMachine(in, base);
+            e.machine = base;
+            break;
+        }
+        case RESPONSE_VM: {
+            VMInfo_t & base = BaseFor(vms, e.args[0]);
+            e.changed = GetVM(in, base);
+            e.vm = base;
+            break;
+        }
+        case RESPONSE_TASK: {
+            TaskInfo_t & base = BaseFor(tasks, e.args[0]);
+            e.changed = GetTask(in, base);
+            e.task = base;
+            break;
+        }
+    }
+    return true;
+}
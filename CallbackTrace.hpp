@@ -0,0 +1,104 @@
+//
+//  CallbackTrace.hpp
+//  CloudSim
+//
+//  Binary trace of everything that crossed the scheduler boundary during a run:
+//  each callback the simulator delivered and, inside it, every Interfaces.h call
+//  the scheduler made together with the answer it got. Written when
+//  CLOUDSIM_CAPTURE names a file (see InterfaceHooks.h); read by tracebench,
+//  which replays it against a scheduler build without the simulator.
+//
+//  Format: the magic "CSCT", a version byte, then a stream of events:
+//      'B' callback byte, zigzag time delta, varint subject (task, VM or machine id)
+//      'E' end of the innermost open callback
+//      'C' call byte, varint arguments (InterfaceCallArgs()), then the response:
+//          MachineInfo_t, VMInfo_t and TaskInfo_t as a varint field mask plus the
+//          fields that differ from the previous answer for the same id; doubles
+//          as 8 raw bytes; everything else as a varint; commands other than
+//          VM_Create carry no response.
+//  Commands are written before they run, so callbacks the simulator delivers
+//  from inside a command appear nested right after it.
+//
+
+#ifndef CallbackTrace_hpp
+#define CallbackTrace_hpp
+
+#include <fstream>
+#include <string>
+
+#include "HookTypes.h"
+
+typedef enum {
+    RESPONSE_NONE,
+    RESPONSE_VALUE,
+    RESPONSE_REAL,
+    RESPONSE_MACHINE,
+    RESPONSE_VM,
+    RESPONSE_TASK
+} TraceResponse_t;
+
+TraceResponse_t ResponseKind(InterfaceCall_t call);
+
+struct TraceEvent {
+    typedef enum { BEGIN, END, CALL } Kind;
+    Kind kind;
+
+    // BEGIN
+    SchedulerCallback_t callback;
+    Time_t time;
+    unsigned subject;
+
+    // CALL
+    InterfaceCall_t call;
+    unsigned args[3];
+    uint64_t value;             // RESPONSE_VALUE
+    double real;                // RESPONSE_REAL
+    MachineInfo_t machine;      // RESPONSE_MACHINE
+    VMInfo_t vm;                // RESPONSE_VM
+    TaskInfo_t task;            // RESPONSE_TASK
+    bool changed;               // Struct responses: differs from the last answer for the same id
+};
+
+class TraceWriter {
+public:
+    bool Open(const string & filename);
+    bool IsOpen() const { return out.is_open(); }
+    void Close();
+
+    void Begin(SchedulerCallback_t callback, Time_t time, unsigned subject);
+    void End();
+
+    // A call is written with Call() followed by exactly the response its kind needs
+    void Call(InterfaceCall_t call, unsigned a0 = 0, unsigned a1 = 0, unsigned a2 = 0);
+    void Value(uint64_t value);
+    void Real(double value);
+    void Machine(const MachineInfo_t & info);
+    void VM(const VMInfo_t & info);
+    void Task(const TaskInfo_t & info);
+
+private:
+    void Flush(bool force);
+
+    ofstream out;
+    string buffer;
+    Time_t last_time = 0;
+    unsigned pending_id = 0;            // First argument of the last Call(), the id answered
+    vector<MachineInfo_t> machines;     // Last answer per id, the base of the next delta
+    vector<VMInfo_t> vms;
+    vector<TaskInfo_t> tasks;
+};
+
+class TraceReader {
+public:
+    // Throws runtime_error if the file is missing, not a trace, or corrupt
+    void Open(const string & filename);
+    bool Next(TraceEvent & event);
+private:
+    ifstream in;
+    Time_t last_time = 0;
+    vector<MachineInfo_t> machines;
+    vector<VMInfo_t> vms;
+    vector<TaskInfo_t> tasks;
+};
+
+#endif /* CallbackTrace_hpp */
@@ -0,0 +1,45 @@
+//
+//  CallbackWrap.h
+//  CloudSim
+//
+//  The scheduler callbacks as the linker's --wrap sees them, for the objects
+//  that interpose on every callback without touching the scheduler source
+//  (CallbackTimer.cpp, AllocTracker.cpp). The callbacks are C++ functions, so
+//  the wrapped names are the mangled ones. The Makefile reads them from
+//  CALLBACK_WRAPS into CALLBACK_WRAP, so this is the only list.
+//
+//  A file using it defines
+//      template <typename Call>
+//      static void Wrapped(SchedulerCallback_t callback, Time_t time, unsigned subject, Call call);
+//  which runs call() once, and then writes DEFINE_CALLBACK_WRAPS at file scope.
+//  InitScheduler has no time argument and gets 0.
+//
+
+#ifndef CallbackWrap_h
+#define CallbackWrap_h
+
+#include "HookTypes.h"
+
+// X(callback, mangled name, parameters, arguments, time, subject)
+#define CALLBACK_WRAPS(X) \
+    X(CB_INIT, _Z13InitSchedulerv, (), (), 0, 0) \
+    X(CB_NEW_TASK, _Z13HandleNewTaskmj, (Time_t time, TaskId_t task_id), (time, task_id), time, task_id) \
+    X(CB_TASK_COMPLETION, _Z20HandleTaskCompletionmj, (Time_t time, TaskId_t task_id), (time, task_id), time, task_id) \
+    X(CB_MEMORY_WARNING, _Z13MemoryWarningmj, (Time_t time, MachineId_t machine_id), (time, machine_id), time, machine_id) \
+    X(CB_MIGRATION_DONE, _Z13MigrationDonemj, (Time_t time, VMId_t vm_id), (time, vm_id), time, vm_id) \
+    X(CB_SCHEDULER_CHECK, _Z14SchedulerCheckm, (Time_t time), (time), time, 0) \
+    X(CB_SIMULATION_COMPLETE, _Z18SimulationCompletem, (Time_t time), (time), time, 0) \
+    X(CB_SLA_WARNING, _Z10SLAWarningmj, (Time_t time, TaskId_t task_id), (time, task_id), time, task_id) \
+    X(CB_STATE_CHANGE_COMPLETE, _Z19StateChangeCompletemj, (Time_t time, MachineId_t machine_id), (time, machine_id), time, machine_id)
+
+#define CALLBACK_REAL(callback, name, params, args, time, subject) void __real_##name params;
+#define CALLBACK_WRAP(callback, name, params, args, time, subject) \
+    void __wrap_##name params { Wrapped(callback, time, subject, [&] { __real_##name args; }); }
+
+#define DEFINE_CALLBACK_WRAPS \
+    extern "C" { \
+    CALLBACK_WRAPS(CALLBACK_REAL) \
+    CALLBACK_WRAPS(CALLBACK_WRAP) \
+    }
+
+#endif /* CallbackWrap_h */
@@ -0,0 +1,125 @@
+//
+//  DecisionLog.cpp
+//  CloudSim
+//
+
+#include "DecisionLog.hpp"
+
+#include <stdexcept>
+
+#include "Varint.hpp"
+
+static const char magic[4] = {'C', 'S', 'D', 'L'};
+static const char version = 1;
+
+unsigned CommandArgs(Command_t command) {
+    switch (command) {
+        case CMD_VM_CREATE:                     return 3;
+        case CMD_VM_ATTACH:                     return 2;
+        case CMD_VM_ADD_TASK:                   return 3;
+        case CMD_VM_MIGRATE:                    return 2;
+        case CMD_VM_REMOVE_TASK:                return 2;
+        case CMD_VM_SHUTDOWN:                   return 1;
+        case CMD_MACHINE_SET_STATE:             return 2;
+        case CMD_MACHINE_SET_CORE_PERFORMANCE:  return 3;
+        case CMD_SET_TASK_PRIORITY:             return 2;
+    }
+    return 0;
+}
+
+string CommandName(Command_t command) {
+    switch (command) {
+        case CMD_VM_CREATE:                     return "VM_Create";
+        case CMD_VM_ATTACH:                     return "VM_Attach";
+        case CMD_VM_ADD_TASK:                   return "VM_AddTask";
+        case CMD_VM_MIGRATE:                    return "VM_Migrate";
+        case CMD_VM_REMOVE_TASK:                return "VM_RemoveTask";
+        case CMD_VM_SHUTDOWN:                   return "VM_Shutdown";
+        case CMD_MACHINE_SET_STATE:             return "Machine_SetState";
+        case CMD_MACHINE_SET_CORE_PERFORMANCE:  return "Machine_SetCorePerformance";
+        case CMD_SET_TASK_PRIORITY:             return "SetTaskPriority";
+    }
+    return "Unknown(" + to_string(command) + ")";
+}
+
+bool Decision::operator==(const Decision & other) const {
+    if (callback != other.callback || time != other.time || command != other.command) return false;
+    for (unsigned i = 0; i < CommandArgs(command); i++) {
+        if (args[i] != other.args[i]) return false;
+    }
+    return true;
+}
+
+string FormatDecision(const Decision & d) {
+    string s = "callback " + to_string(d.callback) + " t=" + to_string(d.time) + " " + CommandName(d.command) + "(";
+    unsigned n = CommandArgs(d.command);
+    // VM_Create's last argument is the id it returned
+    unsigned shown = d.command == CMD_VM_CREATE ? 2 : n;
+    for (unsigned i = 0; i < shown; i++) {
+        if (i) s += ", ";
+        s += to_string(d.args[i]);
+    }
+    s += ")";
+    if (d.command == CMD_VM_CREATE) s += " -> " + to_string(d.args[2]);
+    return s;
+}
+
+bool DecisionWriter::Open(const string & filename) {
+    out.open(filename, ios::binary | ios::trunc);
+    if (!out) return false;
+    out.write(magic, sizeof(magic));
+    out.put(version);
+    return true;
+}
+
+void DecisionWriter::Write(const Decision & d) {
+    PutSignedVarint(buffer, int64_t(d.callback - last_callback));
+    PutSignedVarint(buffer, int64_t(d.time - last_time));
+    buffer.push_back(char(d.command));
+    for (unsigned i = 0; i < CommandArgs(d.command); i++) {
+        PutVarint(buffer, d.args[i]);
+    }
+    last_callback = d.callback;
+    last_time = d.time;
+    if (buffer.size() >= (1 << 16)) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void DecisionWriter::Close() {
+    if (!out.is_open()) return;
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+    out.close();
+}
+
+void DecisionReader::Open(const string & filename) {
+    in.open(filename, ios::binary);
+    if (!in) throw runtime_error("DecisionReader::Open(): could not open " + filename);
+    char header[5];
+    if (!in.read(header, sizeof(header)) || string(header, 4) != string(magic, 4)) {
+        throw runtime_error("DecisionReader::Open(): " + filename + " is not a decision log");
+    }
+    if (header[4] != version) {
+        throw runtime_error("DecisionReader::Open(): " + filename + " has unsupported version " + to_string(int(header[4])));
+    }
+}
+
+bool DecisionReader::Next(Decision & d) {
+    int64_t callback_delta, time_delta;
+    if (!GetSignedVarint(in, callback_delta)) return false;
+    if (!GetSignedVarint(in, time_delta)) throw runtime_error("DecisionReader::Next(): truncated record");
+    int command = in.get();
+    if (command == EOF || command >= NUM_COMMANDS) throw runtime_error("DecisionReader::Next(): bad command");
+    d.callback = last_callback += callback_delta;
+    d.time = last_time += time_delta;
+    d.command = Command_t(command);
+    d.args[0] = d.args[1] = d.args[2] = 0;
+    for (unsigned i = 0; i < CommandArgs(d.command); i++) {
+        uint64_t value;
+        if (!GetVarint(in, value)) throw runtime_error("DecisionReader::Next(): truncated record");
+        d.args[i] = unsigned(value);
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+//
+//  DecisionLog.hpp
+//  CloudSim
+//
+//  Binary log of every command the scheduler issues to the simulator, in order.
+//  Written when CLOUDSIM_RECORD names a file (see InterfaceHooks.h), replayed by
+//  simulator-replay and compared by Tools/bin/decisiondiff.
+//
+//  Format: the magic "CSDL", a version byte, then one record per command:
+//      varint  callback number delta, zigzag (callbacks are numbered from 1 in delivery
+//              order, InitScheduler first; a command issued after a nested callback
+//              returns belongs to the outer one again)
+//      varint  simulated time delta, zigzag
+//      byte    command
+//      varint  arguments, as many as the command takes (see CommandArgs())
+//
+
+#ifndef DecisionLog_hpp
+#define DecisionLog_hpp
+
+#include <fstream>
+#include <string>
+
+#include "SimTypes.h"
+
+typedef enum {
+    CMD_VM_CREATE,                      // vm_type, cpu, returned vm_id
+    CMD_VM_ATTACH,                      // vm_id, machine_id
+    CMD_VM_ADD_TASK,                    // vm_id, task_id, priority
+    CMD_VM_MIGRATE,                     // vm_id, machine_id
+    CMD_VM_REMOVE_TASK,                 // vm_id, task_id
+    CMD_VM_SHUTDOWN,                    // vm_id
+    CMD_MACHINE_SET_STATE,              // machine_id, s_state
+    CMD_MACHINE_SET_CORE_PERFORMANCE,   // machine_id, core_id, p_state
+    CMD_SET_TASK_PRIORITY               // task_id, priority
+} Command_t;
+#define NUM_COMMANDS 9
+
+struct Decision {
+    uint64_t callback;
+    Time_t time;
+    Command_t command;
+    unsigned args[3];
+
+    bool operator==(const Decision & other) const;
+    bool operator!=(const Decision & other) const { return !(*this == other); }
+};
+
+unsigned CommandArgs(Command_t command);
+string CommandName(Command_t command);
+string FormatDecision(const Decision & decision);
+
+class DecisionWriter {
+public:
+    bool Open(const string & filename);
+    bool IsOpen() const { return out.is_open(); }
+    void Write(const Decision & decision);
+    void Close();
+private:
+    ofstream out;
+    string buffer;
+    uint64_t last_callback = 0;
+    Time_t last_time = 0;
+};
+
+class DecisionReader {
+public:
+    // Throws runtime_error if the file is missing or not a decision log
+    void Open(const string & filename);
+    bool Next(Decision & decision);
+private:
+    ifstream in;
+    uint64_t last_callback = 0;
+    Time_t last_time = 0;
+};
+
+#endif /* DecisionLog_hpp */
@@ -0,0 +1,137 @@
+//
+//  HookTypes.h
+//  CloudSim
+//
+//  Names for the scheduler callbacks and the Interfaces.h functions the
+//  scheduler calls, shared by the hooks (InterfaceHooks.h), the logs they write
+//  and the tools that read them. Unlike InterfaceHooks.h this header defines no
+//  macros, so code implementing the interfaces can include it.
+//
+
+#ifndef HookTypes_h
+#define HookTypes_h
+
+#include "SimTypes.h"
+
+typedef enum {
+    CB_INIT,
+    CB_NEW_TASK,
+    CB_TASK_COMPLETION,
+    CB_MEMORY_WARNING,
+    CB_MIGRATION_DONE,
+    CB_SCHEDULER_CHECK,
+    CB_SIMULATION_COMPLETE,
+    CB_SLA_WARNING,
+    CB_STATE_CHANGE_COMPLETE
+} SchedulerCallback_t;
+#define NUM_CALLBACKS 9
+
+typedef enum {
+    // Queries
+    CALL_MACHINE_GET_CPU_TYPE,
+    CALL_MACHINE_GET_ENERGY,
+    CALL_MACHINE_GET_CLUSTER_ENERGY,
+    CALL_MACHINE_GET_INFO,
+    CALL_MACHINE_GET_TOTAL,
+    CALL_GET_SLA_REPORT,
+    CALL_NOW,
+    CALL_GET_NUM_TASKS,
+    CALL_GET_TASK_INFO,
+    CALL_GET_TASK_MEMORY,
+    CALL_GET_TASK_PRIORITY,
+    CALL_IS_SLA_VIOLATED,
+    CALL_IS_TASK_COMPLETED,
+    CALL_IS_TASK_GPU_CAPABLE,
+    CALL_REQUIRED_CPU_TYPE,
+    CALL_REQUIRED_SLA,
+    CALL_REQUIRED_VM_TYPE,
+    CALL_VM_GET_INFO,
+    // Commands
+    CALL_VM_CREATE,
+    CALL_VM_ATTACH,
+    CALL_VM_ADD_TASK,
+    CALL_VM_MIGRATE,
+    CALL_VM_REMOVE_TASK,
+    CALL_VM_SHUTDOWN,
+    CALL_MACHINE_SET_STATE,
+    CALL_MACHINE_SET_CORE_PERFORMANCE,
+    CALL_SET_TASK_PRIORITY
+} InterfaceCall_t;
+#define NUM_INTERFACE_CALLS 27
+
+inline const char * CallbackName(SchedulerCallback_t callback) {
+    switch (callback) {
+        case CB_INIT:                   return "InitScheduler";
+        case CB_NEW_TASK:               return "HandleNewTask";
+        case CB_TASK_COMPLETION:        return "HandleTaskCompletion";
+        case CB_MEMORY_WARNING:         return "MemoryWarning";
+        case CB_MIGRATION_DONE:         return "MigrationDone";
+        case CB_SCHEDULER_CHECK:        return "SchedulerCheck";
+        case CB_SIMULATION_COMPLETE:    return "SimulationComplete";
+        case CB_SLA_WARNING:            return "SLAWarning";
+        case CB_STATE_CHANGE_COMPLETE:  return "StateChangeComplete";
+    }
+    return "Unknown";
+}
+
+inline const char * InterfaceCallName(InterfaceCall_t call) {
+    switch (call) {
+        case CALL_MACHINE_GET_CPU_TYPE:         return "Machine_GetCPUType";
+        case CALL_MACHINE_GET_ENERGY:           return "Machine_GetEnergy";
+        case CALL_MACHINE_GET_CLUSTER_ENERGY:   return "Machine_GetClusterEnergy";
+        case CALL_MACHINE_GET_INFO:             return "Machine_GetInfo";
+        case CALL_MACHINE_GET_TOTAL:            return "Machine_GetTotal";
+        case CALL_GET_SLA_REPORT:               return "GetSLAReport";
+        case CALL_NOW:                          return "Now";
+        case CALL_GET_NUM_TASKS:                return "GetNumTasks";
+        case CALL_GET_TASK_INFO:                return "GetTaskInfo";
+        case CALL_GET_TASK_MEMORY:              return "GetTaskMemory";
+        case CALL_GET_TASK_PRIORITY:            return "GetTaskPriority";
+        case CALL_IS_SLA_VIOLATED:              return "IsSLAViolated";
+        case CALL_IS_TASK_COMPLETED:            return "IsTaskCompleted";
+        case CALL_IS_TASK_GPU_CAPABLE:          return "IsTaskGPUCapable";
+        case CALL_REQUIRED_CPU_TYPE:            return "RequiredCPUType";
+        case CALL_REQUIRED_SLA:                 return "RequiredSLA";
+        case CALL_REQUIRED_VM_TYPE:             return "RequiredVMType";
+        case CALL_VM_GET_INFO:                  return "VM_GetInfo";
+        case CALL_VM_CREATE:                    return "VM_Create";
+        case CALL_VM_ATTACH:                    return "VM_Attach";
+        case CALL_VM_ADD_TASK:                  return "VM_AddTask";
+        case CALL_VM_MIGRATE:                   return "VM_Migrate";
+        case CALL_VM_REMOVE_TASK:               return "VM_RemoveTask";
+        case CALL_VM_SHUTDOWN:                  return "VM_Shutdown";
+        case CALL_MACHINE_SET_STATE:            return "Machine_SetState";
+        case CALL_MACHINE_SET_CORE_PERFORMANCE: return "Machine_SetCorePerformance";
+        case CALL_SET_TASK_PRIORITY:            return "SetTaskPriority";
+    }
+    return "Unknown";
+}
+
+// Number of arguments each call takes (VM_Create's returned id is a response, not an argument)
+inline unsigned InterfaceCallArgs(InterfaceCall_t call) {
+    switch (call) {
+        case CALL_MACHINE_GET_CLUSTER_ENERGY:
+        case CALL_MACHINE_GET_TOTAL:
+        case CALL_NOW:
+        case CALL_GET_NUM_TASKS:
+            return 0;
+        case CALL_VM_CREATE:
+        case CALL_VM_ATTACH:
+        case CALL_VM_MIGRATE:
+        case CALL_VM_REMOVE_TASK:
+        case CALL_MACHINE_SET_STATE:
+        case CALL_SET_TASK_PRIORITY:
+            return 2;
+        case CALL_VM_ADD_TASK:
+        case CALL_MACHINE_SET_CORE_PERFORMANCE:
+            return 3;
+        default:
+            return 1;
+    }
+}
+
+inline bool IsCommand(InterfaceCall_t call) {
+    return call >= CALL_VM_CREATE;
+}
+
+#endif /* HookTypes_h */
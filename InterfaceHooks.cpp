@@ -0,0 +1,546 @@
+//
+//  InterfaceHooks.cpp
+//  CloudSim
+//
+
+#include "InterfaceHooks.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+#include "CallbackTrace.hpp"
+#include "DecisionLog.hpp"
+#include "LatencyHistogram.hpp"
+#include "LiveMetrics.hpp"
+#include "Snapshot.hpp"
+#include "Telemetry.hpp"
+
+static uint64_t callbacks_delivered = 0;
+static uint64_t callback_number = 0;       // Number of the innermost callback still running
+static Time_t callback_time = 0;
+static DecisionWriter recorder;
+static bool recording = false;
+static TraceWriter capture;
+static bool capturing = false;
+static string stats_file;
+static uint64_t callback_counts[NUM_CALLBACKS];
+static TelemetryRecorder telemetry;
+static string live_name;
+static LiveSegment * live = nullptr;
+static LiveCounters live_counters;
+static const uint64_t kLiveIntervalNs = 100000000;
+
+// Cluster snapshots. VMs and active tasks are followed here because the
+// interfaces cannot list them.
+struct SnapshotVMState {
+    bool attached = false;
+    MachineId_t migrating_to = SNAPSHOT_NONE;
+};
+static bool snapshotting = false;
+static string snapshot_prefix;
+static vector<Time_t> snapshot_times;                   // Still to take, latest first
+static bool snapshot_on_sla = false;
+static volatile sig_atomic_t snapshot_requested = 0;
+static map<VMId_t, SnapshotVMState> snapshot_vms;       // Created and not shut down
+static set<TaskId_t> snapshot_tasks;                    // Arrived and not completed
+static map<Time_t, unsigned> snapshot_counts;           // Per simulated time, for unique file names
+
+// Callback profile
+static LatencyHistogram latency[NUM_CALLBACKS];
+static uint64_t call_counts[NUM_CALLBACKS][NUM_INTERFACE_CALLS];
+static uint32_t call_max[NUM_CALLBACKS][NUM_INTERFACE_CALLS];      // Most in one callback
+static uint32_t * scope_calls = nullptr;                            // Counters of the innermost scope
+static double cpu_seconds[NUM_CALLBACKS];                           // Outermost scopes only
+
+static const double kPercentiles[] = {0.5, 0.9, 0.99, 0.999};
+static const char * kPercentileNames[] = {"p50", "p90", "p99", "p999"};
+
+static uint64_t NowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static double CpuNow() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline void Count(InterfaceCall_t call) {
+    if (scope_calls) scope_calls[call]++;
+}
+
+// Per callback: latency count, mean, percentiles and max, then each call made
+// from it with its total, mean and most per callback
+static void PrintProfile() {
+    ostringstream out;
+    out << "Callback profile (wall ns; calls made directly inside each callback):";
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        const LatencyHistogram & h = latency[c];
+        if (h.Count() == 0) continue;
+        out << endl << "  " << left << setw(22) << CallbackName(SchedulerCallback_t(c)) << right
+            << " n " << h.Count() << " mean " << uint64_t(h.Mean());
+        for (unsigned p = 0; p < 4; p++) out << " " << kPercentileNames[p] << " " << h.Percentile(kPercentiles[p]);
+        out << " max " << h.Max();
+        for (unsigned k = 0; k < NUM_INTERFACE_CALLS; k++) {
+            if (call_counts[c][k] == 0) continue;
+            out << endl << "      " << left << setw(28) << InterfaceCallName(InterfaceCall_t(k)) << right << setw(12) << call_counts[c][k]
+                << fixed << setprecision(2) << setw(10) << double(call_counts[c][k]) / h.Count() << "/call  max " << call_max[c][k];
+            out.unsetf(ios::fixed);
+        }
+    }
+    SimOutput(out.str(), 1);
+}
+
+// One "name value" line per figure, for tools that run the simulator as a black box
+static void WriteStats(Time_t time) {
+    ofstream out(stats_file);
+    if (!out) ThrowException("CallbackScope: could not write statistics to ", stats_file);
+    out << "callbacks " << callbacks_delivered << endl;
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        out << "callbacks." << CallbackName(SchedulerCallback_t(c)) << " " << callback_counts[c] << endl;
+    }
+    out << "simulated_us " << time << endl;
+    double cpu_total = 0;
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) cpu_total += cpu_seconds[c];
+    out << "scheduler_cpu_s " << cpu_total << endl;
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        out << "scheduler_cpu_s." << CallbackName(SchedulerCallback_t(c)) << " " << cpu_seconds[c] << endl;
+    }
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        const LatencyHistogram & h = latency[c];
+        if (h.Count() == 0) continue;
+        string name = CallbackName(SchedulerCallback_t(c));
+        out << "latency_ns." << name << ".mean " << h.Mean() << endl;
+        for (unsigned p = 0; p < 4; p++) out << "latency_ns." << name << "." << kPercentileNames[p] << " " << h.Percentile(kPercentiles[p]) << endl;
+        out << "latency_ns." << name << ".max " << h.Max() << endl;
+        for (unsigned k = 0; k < NUM_INTERFACE_CALLS; k++) {
+            if (call_counts[c][k] == 0) continue;
+            out << "calls." << name << "." << InterfaceCallName(InterfaceCall_t(k)) << " " << call_counts[c][k] << endl;
+            out << "calls_max." << name << "." << InterfaceCallName(InterfaceCall_t(k)) << " " << call_max[c][k] << endl;
+        }
+    }
+}
+
+// Every machine's state, with the real queries so the sampling stays out of logs and counts
+static void SampleTelemetry(Time_t time, bool force) {
+    if (!telemetry.IsOpen() || !telemetry.Begin(time, force)) return;
+    unsigned machines = (Machine_GetTotal)();
+    for (unsigned m = 0; m < machines; m++) telemetry.Add((Machine_GetInfo)(m));
+    telemetry.End();
+}
+
+// Run counters for livetop, with the real queries like the telemetry
+static void PublishLiveCounters(uint64_t wall_ns, bool finished) {
+    LiveCounters & c = live_counters;
+    c.wall_ns = wall_ns;
+    c.simulated_us = callback_time;
+    c.events = callbacks_delivered;
+    c.tasks_arrived = callback_counts[CB_NEW_TASK];
+    c.tasks_completed = callback_counts[CB_TASK_COMPLETION];
+    c.sla_warnings = callback_counts[CB_SLA_WARNING];
+    c.machines = (Machine_GetTotal)();
+    c.machines_awake = 0;
+    for (unsigned m = 0; m < c.machines; m++) {
+        if ((Machine_GetInfo)(m).s_state == S0) c.machines_awake++;
+    }
+    c.energy_kwh = (Machine_GetClusterEnergy)();
+    for (unsigned s = SLA0; s < SLA3; s++) c.sla_violations[s] = (GetSLAReport)(SLAType_t(s));
+    c.finished = finished;
+    PublishLive(live, c);
+}
+
+static void RequestSnapshot(int) {
+    snapshot_requested = 1;
+}
+
+// CLOUDSIM_SNAPSHOT_AT: simulated seconds and "sla", comma separated
+static void ParseSnapshotTriggers(const string & spec) {
+    istringstream in(spec);
+    string item;
+    while (getline(in, item, ',')) {
+        if (item.empty()) continue;
+        if (item == "sla") {
+            snapshot_on_sla = true;
+            continue;
+        }
+        char * end = nullptr;
+        double seconds = strtod(item.c_str(), &end);
+        if (*end != 0 || seconds < 0) ThrowException("CallbackScope: CLOUDSIM_SNAPSHOT_AT takes seconds and sla, not ", item);
+        snapshot_times.push_back(Time_t(seconds * 1000000 + 0.5));
+    }
+    sort(snapshot_times.rbegin(), snapshot_times.rend());
+}
+
+// The whole cluster, with the real queries so the snapshot stays out of logs and counts
+static void TakeSnapshot(Time_t time, const string & reason) {
+    ClusterSnapshot snapshot;
+    snapshot.time = time;
+    snapshot.reason = reason;
+    unsigned machines = (Machine_GetTotal)();
+    for (unsigned m = 0; m < machines; m++) {
+        MachineInfo_t info = (Machine_GetInfo)(m);
+        snapshot.machines.push_back({m, info.cpu, info.num_cpus, info.gpus, info.s_state, info.p_state, info.memory_used,
+                                     info.memory_size, info.energy_consumed, {}, {}});
+    }
+    // A task can finish before its completion callback arrives (an SLA warning
+    // at the same instant, say); it is no longer active, so it is left out
+    vector<TaskInfo_t> tasks;
+    set<TaskId_t> finished_tasks;
+    for (TaskId_t task : snapshot_tasks) {
+        TaskInfo_t info = (GetTaskInfo)(task);
+        if (info.remaining_instructions == 0 || (IsTaskCompleted)(task)) finished_tasks.insert(task);
+        else tasks.push_back(info);
+    }
+    auto done = [&](TaskId_t task) { return finished_tasks.count(task) > 0; };
+    map<TaskId_t, VMId_t> placed;
+    for (auto & vm : snapshot_vms) {
+        VMInfo_t info = (VM_GetInfo)(vm.first);
+        info.active_tasks.erase(remove_if(info.active_tasks.begin(), info.active_tasks.end(), done), info.active_tasks.end());
+        MachineId_t host = vm.second.attached ? info.machine_id : SNAPSHOT_NONE;
+        snapshot.vms.push_back({vm.first, info.vm_type, info.cpu, host, vm.second.migrating_to, info.active_tasks});
+        if (host < machines) {
+            SnapshotMachine & m = snapshot.machines[host];
+            m.vms.push_back(vm.first);
+            m.tasks.insert(m.tasks.end(), info.active_tasks.begin(), info.active_tasks.end());
+        }
+        for (TaskId_t task : info.active_tasks) placed[task] = vm.first;
+    }
+    for (auto & m : snapshot.machines) sort(m.tasks.begin(), m.tasks.end());
+    for (auto & info : tasks) {
+        TaskId_t task = info.task_id;
+        auto vm = placed.find(task);
+        snapshot.tasks.push_back({task, vm == placed.end() ? SNAPSHOT_NONE : vm->second, info.remaining_instructions,
+                                  info.total_instructions, info.arrival, info.target_completion, info.priority, info.required_sla,
+                                  info.required_cpu, info.required_vm, info.required_memory, info.gpu_capable,
+                                  time > info.target_completion});
+    }
+
+    string filename = snapshot_prefix + "." + to_string(time);
+    unsigned taken = snapshot_counts[time]++;
+    if (taken) filename += "-" + to_string(taken + 1);
+    filename += ".json";
+    try {
+        WriteSnapshot(snapshot, filename);
+    } catch (const exception & e) {
+        ThrowException("CallbackScope: ", e.what());
+    }
+    SimOutput("Snapshot (" + reason + ") written to " + filename, 1);
+}
+
+// Snapshots are taken as a callback begins, before the scheduler acts on it.
+// Times and signals are served by the first callback at or after them.
+static void TakeDueSnapshots(SchedulerCallback_t callback, Time_t time, unsigned subject) {
+    if (callback == CB_NEW_TASK) snapshot_tasks.insert(subject);
+    else if (callback == CB_TASK_COMPLETION) snapshot_tasks.erase(subject);
+    else if (callback == CB_MIGRATION_DONE) {
+        auto vm = snapshot_vms.find(subject);
+        if (vm != snapshot_vms.end()) vm->second.migrating_to = SNAPSHOT_NONE;
+    }
+    string reason;
+    if (!snapshot_times.empty() && time >= snapshot_times.back()) {
+        reason = "time";
+        while (!snapshot_times.empty() && time >= snapshot_times.back()) snapshot_times.pop_back();
+    }
+    if (snapshot_requested) {
+        snapshot_requested = 0;
+        reason += string(reason.empty() ? "" : ",") + "signal";
+    }
+    if (snapshot_on_sla && callback == CB_SLA_WARNING) {
+        snapshot_on_sla = false;
+        reason += string(reason.empty() ? "" : ",") + "sla_warning task " + to_string(subject);
+    }
+    if (!reason.empty()) TakeSnapshot(time, reason);
+}
+
+CallbackScope::CallbackScope(SchedulerCallback_t callback, Time_t time, unsigned subject)
+    : callback(callback), outer_number(callback_number), outer_time(callback_time), outer_calls(scope_calls) {
+    if (callback == CB_INIT) {
+        const char * record = getenv("CLOUDSIM_RECORD");
+        if (record && *record) {
+            recording = recorder.Open(record);
+            if (!recording) ThrowException("CallbackScope: could not open decision log ", record);
+        }
+        const char * trace = getenv("CLOUDSIM_CAPTURE");
+        if (trace && *trace) {
+            capturing = capture.Open(trace);
+            if (!capturing) ThrowException("CallbackScope: could not open callback trace ", trace);
+        }
+        const char * stats = getenv("CLOUDSIM_STATS");
+        if (stats) stats_file = stats;
+        const char * series = getenv("CLOUDSIM_TELEMETRY");
+        if (series && *series) {
+            const char * mb = getenv("CLOUDSIM_TELEMETRY_MB");
+            telemetry.Open(series, size_t((mb && *mb ? atof(mb) : 32) * 1048576));
+        }
+        const char * live_env = getenv("CLOUDSIM_LIVE");
+        if (live_env && *live_env) {
+            string error;
+            live_name = live_env;
+            live = CreateLiveSegment(live_name, error);
+            if (!live) ThrowException("CallbackScope: ", error);
+            live_counters.pid = getpid();
+            live_counters.wall_start_ns = NowNs();
+            live_counters.tasks_total = (GetNumTasks)();
+        }
+        const char * snapshot = getenv("CLOUDSIM_SNAPSHOT");
+        if (snapshot && *snapshot) {
+            snapshotting = true;
+            snapshot_prefix = snapshot;
+            const char * triggers = getenv("CLOUDSIM_SNAPSHOT_AT");
+            if (triggers) ParseSnapshotTriggers(triggers);
+            struct sigaction action = {};
+            action.sa_handler = RequestSnapshot;
+            action.sa_flags = SA_RESTART;
+            sigaction(SIGUSR1, &action, nullptr);
+        }
+    }
+    callback_counts[callback]++;
+    callback_number = ++callbacks_delivered;
+    callback_time = time;
+    if (capturing) capture.Begin(callback, time, subject);
+    if (callback == CB_SCHEDULER_CHECK) SampleTelemetry(time, false);
+    if (snapshotting) TakeDueSnapshots(callback, time, subject);
+    scope_calls = calls;
+    if (outer_number == 0 && !stats_file.empty()) start_cpu_s = CpuNow();
+    start_ns = NowNs();
+}
+
+CallbackScope::~CallbackScope() {
+    uint64_t end_ns = NowNs();
+    latency[callback].Record(end_ns - start_ns);
+    if (outer_number == 0 && !stats_file.empty()) cpu_seconds[callback] += CpuNow() - start_cpu_s;
+    for (unsigned k = 0; k < NUM_INTERFACE_CALLS; k++) {
+        call_counts[callback][k] += calls[k];
+        if (calls[k] > call_max[callback][k]) call_max[callback][k] = calls[k];
+    }
+    scope_calls = outer_calls;
+    if (capturing) capture.End();
+    if (callback == CB_SIMULATION_COMPLETE && recording) {
+        recorder.Close();
+        recording = false;
+    }
+    if (callback == CB_SIMULATION_COMPLETE && capturing) {
+        capture.Close();
+        capturing = false;
+    }
+    if (callback == CB_SIMULATION_COMPLETE && telemetry.IsOpen()) {
+        SampleTelemetry(callback_time, true);
+        try {
+            telemetry.Close();
+        } catch (const exception & e) {
+            ThrowException("CallbackScope: ", e.what());
+        }
+    }
+    if (live && (callback == CB_SIMULATION_COMPLETE || end_ns - live_counters.wall_ns >= kLiveIntervalNs)) {
+        PublishLiveCounters(end_ns, callback == CB_SIMULATION_COMPLETE);
+    }
+    if (callback == CB_SIMULATION_COMPLETE && live) {
+        // Readers that have it mapped keep the final counters
+        UnlinkLiveSegment(live_name);
+        live = nullptr;
+    }
+    if (callback == CB_SIMULATION_COMPLETE) PrintProfile();
+    if (callback == CB_SIMULATION_COMPLETE && !stats_file.empty()) WriteStats(callback_time);
+    // The simulator can call back from inside a command (Machine_SetState during
+    // InitScheduler, for instance); what follows belongs to the outer callback again.
+    callback_number = outer_number;
+    callback_time = outer_time;
+}
+
+static_assert(CALL_SET_TASK_PRIORITY - CALL_VM_CREATE == CMD_SET_TASK_PRIORITY,
+              "InterfaceCall_t commands must follow Command_t order");
+
+// Commands are written to the trace before they run, so that callbacks the
+// simulator delivers from inside them appear nested after the command.
+static void Record(Command_t command, unsigned a0, unsigned a1 = 0, unsigned a2 = 0) {
+    Count(InterfaceCall_t(CALL_VM_CREATE + command));
+    if (capturing && command != CMD_VM_CREATE) {
+        capture.Call(InterfaceCall_t(CALL_VM_CREATE + command), a0, a1, a2);
+    }
+    if (!recording) return;
+    recorder.Write({callback_number, callback_time, command, {a0, a1, a2}});
+}
+
+// Queries
+
+CPUType_t Hooked_Machine_GetCPUType(MachineId_t machine_id) {
+    CPUType_t cpu = (Machine_GetCPUType)(machine_id);
+    Count(CALL_MACHINE_GET_CPU_TYPE);
+    if (capturing) { capture.Call(CALL_MACHINE_GET_CPU_TYPE, machine_id); capture.Value(cpu); }
+    return cpu;
+}
+
+uint64_t Hooked_Machine_GetEnergy(MachineId_t machine_id) {
+    uint64_t energy = (Machine_GetEnergy)(machine_id);
+    Count(CALL_MACHINE_GET_ENERGY);
+    if (capturing) { capture.Call(CALL_MACHINE_GET_ENERGY, machine_id); capture.Value(energy); }
+    return energy;
+}
+
+double Hooked_Machine_GetClusterEnergy() {
+    double energy = (Machine_GetClusterEnergy)();
+    Count(CALL_MACHINE_GET_CLUSTER_ENERGY);
+    if (capturing) { capture.Call(CALL_MACHINE_GET_CLUSTER_ENERGY); capture.Real(energy); }
+    return energy;
+}
+
+MachineInfo_t Hooked_Machine_GetInfo(MachineId_t machine_id) {
+    MachineInfo_t info = (Machine_GetInfo)(machine_id);
+    Count(CALL_MACHINE_GET_INFO);
+    if (capturing) { capture.Call(CALL_MACHINE_GET_INFO, machine_id); capture.Machine(info); }
+    return info;
+}
+
+unsigned Hooked_Machine_GetTotal() {
+    unsigned total = (Machine_GetTotal)();
+    Count(CALL_MACHINE_GET_TOTAL);
+    if (capturing) { capture.Call(CALL_MACHINE_GET_TOTAL); capture.Value(total); }
+    return total;
+}
+
+double Hooked_GetSLAReport(SLAType_t sla) {
+    double report = (GetSLAReport)(sla);
+    Count(CALL_GET_SLA_REPORT);
+    if (capturing) { capture.Call(CALL_GET_SLA_REPORT, sla); capture.Real(report); }
+    return report;
+}
+
+Time_t Hooked_Now() {
+    Time_t now = (Now)();
+    Count(CALL_NOW);
+    if (capturing) { capture.Call(CALL_NOW); capture.Value(now); }
+    return now;
+}
+
+unsigned Hooked_GetNumTasks() {
+    unsigned tasks = (GetNumTasks)();
+    Count(CALL_GET_NUM_TASKS);
+    if (capturing) { capture.Call(CALL_GET_NUM_TASKS); capture.Value(tasks); }
+    return tasks;
+}
+
+TaskInfo_t Hooked_GetTaskInfo(TaskId_t task_id) {
+    TaskInfo_t info = (GetTaskInfo)(task_id);
+    Count(CALL_GET_TASK_INFO);
+    if (capturing) { capture.Call(CALL_GET_TASK_INFO, task_id); capture.Task(info); }
+    return info;
+}
+
+unsigned Hooked_GetTaskMemory(TaskId_t task_id) {
+    unsigned memory = (GetTaskMemory)(task_id);
+    Count(CALL_GET_TASK_MEMORY);
+    if (capturing) { capture.Call(CALL_GET_TASK_MEMORY, task_id); capture.Value(memory); }
+    return memory;
+}
+
+unsigned Hooked_GetTaskPriority(TaskId_t task_id) {
+    unsigned priority = (GetTaskPriority)(task_id);
+    Count(CALL_GET_TASK_PRIORITY);
+    if (capturing) { capture.Call(CALL_GET_TASK_PRIORITY, task_id); capture.Value(priority); }
+    return priority;
+}
+
+bool Hooked_IsTaskCompleted(TaskId_t task_id) {
+    bool completed = (IsTaskCompleted)(task_id);
+    Count(CALL_IS_TASK_COMPLETED);
+    if (capturing) { capture.Call(CALL_IS_TASK_COMPLETED, task_id); capture.Value(completed); }
+    return completed;
+}
+
+bool Hooked_IsTaskGPUCapable(TaskId_t task_id) {
+    bool gpu = (IsTaskGPUCapable)(task_id);
+    Count(CALL_IS_TASK_GPU_CAPABLE);
+    if (capturing) { capture.Call(CALL_IS_TASK_GPU_CAPABLE, task_id); capture.Value(gpu); }
+    return gpu;
+}
+
+CPUType_t Hooked_RequiredCPUType(TaskId_t task_id) {
+    CPUType_t cpu = (RequiredCPUType)(task_id);
+    Count(CALL_REQUIRED_CPU_TYPE);
+    if (capturing) { capture.Call(CALL_REQUIRED_CPU_TYPE, task_id); capture.Value(cpu); }
+    return cpu;
+}
+
+SLAType_t Hooked_RequiredSLA(TaskId_t task_id) {
+    SLAType_t sla = (RequiredSLA)(task_id);
+    Count(CALL_REQUIRED_SLA);
+    if (capturing) { capture.Call(CALL_REQUIRED_SLA, task_id); capture.Value(sla); }
+    return sla;
+}
+
+VMType_t Hooked_RequiredVMType(TaskId_t task_id) {
+    VMType_t vm_type = (RequiredVMType)(task_id);
+    Count(CALL_REQUIRED_VM_TYPE);
+    if (capturing) { capture.Call(CALL_REQUIRED_VM_TYPE, task_id); capture.Value(vm_type); }
+    return vm_type;
+}
+
+VMInfo_t Hooked_VM_GetInfo(VMId_t vm_id) {
+    VMInfo_t info = (VM_GetInfo)(vm_id);
+    Count(CALL_VM_GET_INFO);
+    if (capturing) { capture.Call(CALL_VM_GET_INFO, vm_id); capture.VM(info); }
+    return info;
+}
+
+// Commands
+
+VMId_t Hooked_VM_Create(VMType_t vm_type, CPUType_t cpu) {
+    VMId_t vm_id = (VM_Create)(vm_type, cpu);
+    if (capturing) { capture.Call(CALL_VM_CREATE, vm_type, cpu); capture.Value(vm_id); }
+    Record(CMD_VM_CREATE, vm_type, cpu, vm_id);
+    if (snapshotting) snapshot_vms[vm_id];
+    return vm_id;
+}
+
+void Hooked_VM_Attach(VMId_t vm_id, MachineId_t machine_id) {
+    Record(CMD_VM_ATTACH, vm_id, machine_id);
+    (VM_Attach)(vm_id, machine_id);
+    if (snapshotting) snapshot_vms[vm_id].attached = true;
+}
+
+void Hooked_VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    Record(CMD_VM_ADD_TASK, vm_id, task_id, priority);
+    (VM_AddTask)(vm_id, task_id, priority);
+}
+
+void Hooked_VM_Migrate(VMId_t vm_id, MachineId_t machine_id) {
+    Record(CMD_VM_MIGRATE, vm_id, machine_id);
+    (VM_Migrate)(vm_id, machine_id);
+    if (snapshotting) snapshot_vms[vm_id].migrating_to = machine_id;
+}
+
+void Hooked_VM_RemoveTask(VMId_t vm_id, TaskId_t task_id) {
+    Record(CMD_VM_REMOVE_TASK, vm_id, task_id);
+    (VM_RemoveTask)(vm_id, task_id);
+}
+
+void Hooked_VM_Shutdown(VMId_t vm_id) {
+    Record(CMD_VM_SHUTDOWN, vm_id);
+    (VM_Shutdown)(vm_id);
+    if (snapshotting) snapshot_vms.erase(vm_id);
+}
+
+void Hooked_Machine_SetState(MachineId_t machine_id, MachineState_t s_state) {
+    Record(CMD_MACHINE_SET_STATE, machine_id, s_state);
+    (Machine_SetState)(machine_id, s_state);
+}
+
+void Hooked_Machine_SetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state) {
+    Record(CMD_MACHINE_SET_CORE_PERFORMANCE, machine_id, core_id, p_state);
+    (Machine_SetCorePerformance)(machine_id, core_id, p_state);
+}
+
+void Hooked_SetTaskPriority(TaskId_t task_id, Priority_t priority) {
+    Record(CMD_SET_TASK_PRIORITY, task_id, priority);
+    (SetTaskPriority)(task_id, priority);
+}
@@ -0,0 +1,123 @@
+//
+//  InterfaceHooks.h
+//  CloudSim
+//
+//  Interposes on the scheduler's side of Interfaces.h. Scheduler.hpp includes
+//  this after Interfaces.h, so every query and command the scheduler issues goes
+//  through a Hooked_ function that forwards to the simulator and can record it.
+//  Each public scheduler entry point opens a CallbackScope, which numbers
+//  callbacks and tells the hooks which simulated time the calls belong to.
+//
+//  Environment:
+//      CLOUDSIM_RECORD=file    write every command to a decision log (DecisionLog.hpp)
+//      CLOUDSIM_CAPTURE=file   write every callback, query and command with its
+//                              answer to a callback trace (CallbackTrace.hpp)
+//      CLOUDSIM_TELEMETRY=file sample every machine at each SchedulerCheck into a
+//                              compact time series (Telemetry.hpp); .csv for text
+//      CLOUDSIM_TELEMETRY_MB=n memory bound of that series, default 32
+//      CLOUDSIM_LIVE=name      publish run progress in the shared memory segment
+//                              name for Tools/bin/livetop (LiveMetrics.hpp)
+//      CLOUDSIM_SNAPSHOT=prefix
+//                              write the whole cluster to prefix.<simulated us>.json
+//                              (Snapshot.hpp) on SIGUSR1 and the triggers below
+//      CLOUDSIM_SNAPSHOT_AT=list
+//                              simulated seconds to snapshot at, and "sla" for
+//                              the first SLA warning, e.g. 10,30.5,sla
+//      CLOUDSIM_STATS=file     write callback counts, the simulated time, the
+//                              callback profile and the scheduler's CPU time, one
+//                              "name value" line each, when the simulation completes
+//
+//  The callback profile is always on: each scope records its wall time in a
+//  latency histogram per callback (LatencyHistogram.hpp) and counts the
+//  Interfaces.h calls made directly inside it, per callback and call. The
+//  cost is two clock reads per callback and an increment per call. At the end
+//  of SimulationComplete the profile is printed at verbosity 1 (-v 1). With
+//  CLOUDSIM_STATS, callbacks not nested in another one also read the process
+//  CPU clock, for scheduler_cpu_s.
+//
+//  Files implementing the hooks call the real functions with the name in
+//  parentheses, e.g. (VM_Create)(vm_type, cpu), which the macros do not match.
+//
+
+#ifndef InterfaceHooks_h
+#define InterfaceHooks_h
+
+#include "HookTypes.h"
+#include "Interfaces.h"
+
+class CallbackScope {
+public:
+    // subject is the task, VM or machine the callback is about, if any
+    CallbackScope(SchedulerCallback_t callback, Time_t time, unsigned subject = 0);
+    ~CallbackScope();
+    CallbackScope(const CallbackScope &) = delete;
+    CallbackScope & operator=(const CallbackScope &) = delete;
+private:
+    SchedulerCallback_t callback;
+    uint64_t outer_number;
+    Time_t outer_time;
+    uint32_t * outer_calls;
+    uint64_t start_ns;
+    double start_cpu_s = 0;                       // Outermost scopes only, with CLOUDSIM_STATS
+    uint32_t calls[NUM_INTERFACE_CALLS] = {};     // Calls made in this scope, nested callbacks excluded
+};
+
+// Queries (IsSLAViolated is declared in Interfaces.h but the simulator does not
+// implement it, so it is left alone)
+extern CPUType_t        Hooked_Machine_GetCPUType(MachineId_t machine_id);
+extern uint64_t         Hooked_Machine_GetEnergy(MachineId_t machine_id);
+extern double           Hooked_Machine_GetClusterEnergy();
+extern MachineInfo_t    Hooked_Machine_GetInfo(MachineId_t machine_id);
+extern unsigned         Hooked_Machine_GetTotal();
+extern double           Hooked_GetSLAReport(SLAType_t sla);
+extern Time_t           Hooked_Now();
+extern unsigned         Hooked_GetNumTasks();
+extern TaskInfo_t       Hooked_GetTaskInfo(TaskId_t task_id);
+extern unsigned         Hooked_GetTaskMemory(TaskId_t task_id);
+extern unsigned         Hooked_GetTaskPriority(TaskId_t task_id);
+extern bool             Hooked_IsTaskCompleted(TaskId_t task_id);
+extern bool             Hooked_IsTaskGPUCapable(TaskId_t task_id);
+extern CPUType_t        Hooked_RequiredCPUType(TaskId_t task_id);
+extern SLAType_t        Hooked_RequiredSLA(TaskId_t task_id);
+extern VMType_t         Hooked_RequiredVMType(TaskId_t task_id);
+extern VMInfo_t         Hooked_VM_GetInfo(VMId_t vm_id);
+
+// Commands
+extern VMId_t   Hooked_VM_Create(VMType_t vm_type, CPUType_t cpu);
+extern void     Hooked_VM_Attach(VMId_t vm_id, MachineId_t machine_id);
+extern void     Hooked_VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority);
+extern void     Hooked_VM_Migrate(VMId_t vm_id, MachineId_t machine_id);
+extern void     Hooked_VM_RemoveTask(VMId_t vm_id, TaskId_t task_id);
+extern void     Hooked_VM_Shutdown(VMId_t vm_id);
+extern void     Hooked_Machine_SetState(MachineId_t machine_id, MachineState_t s_state);
+extern void     Hooked_Machine_SetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state);
+extern void     Hooked_SetTaskPriority(TaskId_t task_id, Priority_t priority);
+
+#define Machine_GetCPUType(machine_id)                      Hooked_Machine_GetCPUType(machine_id)
+#define Machine_GetEnergy(machine_id)                       Hooked_Machine_GetEnergy(machine_id)
+#define Machine_GetClusterEnergy()                          Hooked_Machine_GetClusterEnergy()
+#define Machine_GetInfo(machine_id)                         Hooked_Machine_GetInfo(machine_id)
+#define Machine_GetTotal()                                  Hooked_Machine_GetTotal()
+#define GetSLAReport(sla)                                   Hooked_GetSLAReport(sla)
+#define Now()                                               Hooked_Now()
+#define GetNumTasks()                                       Hooked_GetNumTasks()
+#define GetTaskInfo(task_id)                                Hooked_GetTaskInfo(task_id)
+#define GetTaskMemory(task_id)                              Hooked_GetTaskMemory(task_id)
+#define GetTaskPriority(task_id)                            Hooked_GetTaskPriority(task_id)
+#define IsTaskCompleted(task_id)                            Hooked_IsTaskCompleted(task_id)
+#define IsTaskGPUCapable(task_id)                           Hooked_IsTaskGPUCapable(task_id)
+#define RequiredCPUType(task_id)                            Hooked_RequiredCPUType(task_id)
+#define RequiredSLA(task_id)                                Hooked_RequiredSLA(task_id)
+#define RequiredVMType(task_id)                             Hooked_RequiredVMType(task_id)
+#define VM_GetInfo(vm_id)                                   Hooked_VM_GetInfo(vm_id)
+#define VM_Create(vm_type, cpu)                             Hooked_VM_Create(vm_type, cpu)
+#define VM_Attach(vm_id, machine_id)                        Hooked_VM_Attach(vm_id, machine_id)
+#define VM_AddTask(vm_id, task_id, priority)                Hooked_VM_AddTask(vm_id, task_id, priority)
+#define VM_Migrate(vm_id, machine_id)                       Hooked_VM_Migrate(vm_id, machine_id)
+#define VM_RemoveTask(vm_id, task_id)                       Hooked_VM_RemoveTask(vm_id, task_id)
+#define VM_Shutdown(vm_id)                                  Hooked_VM_Shutdown(vm_id)
+#define Machine_SetState(machine_id, s_state)               Hooked_Machine_SetState(machine_id, s_state)
+#define Machine_SetCorePerformance(machine_id, core, p)     Hooked_Machine_SetCorePerformance(machine_id, core, p)
+#define SetTaskPriority(task_id, priority)                  Hooked_SetTaskPriority(task_id, priority)
+
+#endif /* InterfaceHooks_h */
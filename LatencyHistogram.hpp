@@ -0,0 +1,74 @@
+//
+//  LatencyHistogram.hpp
+//  CloudSim
+//
+//  Fixed-size log-linear histogram in the style of HdrHistogram: every power
+//  of two is split into 32 equal sub-buckets, so a recorded value is known to
+//  within about 3% from 1 ns to ~18 minutes in 4.5 KB, and recording is a shift,
+//  a couple of compares and an increment. Used by the callback profile in
+//  InterfaceHooks.cpp.
+//
+
+#ifndef LatencyHistogram_hpp
+#define LatencyHistogram_hpp
+
+#include <cstdint>
+
+class LatencyHistogram {
+public:
+    static const unsigned kSubBits = 5;
+    static const unsigned kSubBuckets = 1u << kSubBits;    // Per power of two
+    static const unsigned kMaxBits = 40;                    // Larger values share the last bucket
+    static const unsigned kBuckets = kSubBuckets * (kMaxBits - kSubBits + 1);
+
+    void Record(uint64_t value) {
+        counts[Bucket(value)]++;
+        count++;
+        total += value;
+        if (value > max) max = value;
+    }
+
+    uint64_t Count() const { return count; }
+    uint64_t Max() const { return max; }
+    double Mean() const { return count ? double(total) / count : 0; }
+
+    // Upper edge of the bucket holding the q-quantile (q in [0, 1]), capped at the maximum
+    uint64_t Percentile(double q) const {
+        if (count == 0) return 0;
+        uint64_t rank = uint64_t(q * count + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (unsigned b = 0; b + 1 < kBuckets; b++) {
+            seen += counts[b];
+            if (seen >= rank) {
+                uint64_t edge = Lowest(b + 1) - 1;
+                return edge < max ? edge : max;
+            }
+        }
+        return max;
+    }
+
+private:
+    // Values below 2 * kSubBuckets get a bucket each; above, a value of L bits
+    // falls in one of kSubBuckets buckets 2^(L - kSubBits - 1) wide
+    static unsigned Bucket(uint64_t value) {
+        if (value < 2 * kSubBuckets) return unsigned(value);
+        unsigned shift = 64 - __builtin_clzll(value) - kSubBits - 1;
+        if (shift + kSubBits + 1 > kMaxBits) return kBuckets - 1;
+        return kSubBuckets * shift + unsigned(value >> shift);
+    }
+
+    // Smallest value that falls in bucket b
+    static uint64_t Lowest(unsigned b) {
+        if (b < 2 * kSubBuckets) return b;
+        unsigned shift = b / kSubBuckets - 1;
+        return uint64_t(b % kSubBuckets + kSubBuckets) << shift;
+    }
+
+    uint32_t counts[kBuckets] = {};
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+};
+
+#endif /* LatencyHistogram_hpp */
@@ -0,0 +1,79 @@
+//
+//  LiveMetrics.cpp
+//  CloudSim
+//
+
+#include "LiveMetrics.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static string SegmentName(const string & name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+LiveSegment * CreateLiveSegment(const string & name, string & error) {
+    string path = SegmentName(name);
+    int fd = shm_open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof(LiveSegment)) != 0) {
+        error = "could not create shared memory " + path + ": " + strerror(errno);
+        if (fd >= 0) close(fd);
+        return nullptr;
+    }
+    void * p = mmap(nullptr, sizeof(LiveSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        error = "could not map " + path + ": " + strerror(errno);
+        return nullptr;
+    }
+    LiveSegment * segment = new (p) LiveSegment();
+    segment->sequence.store(1, memory_order_relaxed);
+    segment->counters = {};
+    segment->magic = LIVE_METRICS_MAGIC;
+    segment->version = LIVE_METRICS_VERSION;
+    segment->sequence.store(2, memory_order_release);
+    return segment;
+}
+
+const LiveSegment * OpenLiveSegment(const string & name, string & error) {
+    string path = SegmentName(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = "no run is publishing " + path + ": " + strerror(errno);
+        return nullptr;
+    }
+    void * p = mmap(nullptr, sizeof(LiveSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        error = "could not map " + path + ": " + strerror(errno);
+        return nullptr;
+    }
+    return static_cast<const LiveSegment *>(p);
+}
+
+void UnlinkLiveSegment(const string & name) {
+    shm_unlink(SegmentName(name).c_str());
+}
+
+void PublishLive(LiveSegment * segment, const LiveCounters & counters) {
+    uint64_t sequence = segment->sequence.load(memory_order_relaxed);
+    segment->sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&segment->counters, &counters, sizeof(counters));
+    segment->sequence.store(sequence + 2, memory_order_release);
+}
+
+bool ReadLive(const LiveSegment * segment, LiveCounters & counters) {
+    if (segment->magic != LIVE_METRICS_MAGIC || segment->version != LIVE_METRICS_VERSION) return false;
+    for (;;) {
+        uint64_t before = segment->sequence.load(memory_order_acquire);
+        if (before & 1) continue;
+        memcpy(&counters, &segment->counters, sizeof(counters));
+        atomic_thread_fence(memory_order_acquire);
+        if (segment->sequence.load(memory_order_relaxed) == before) return true;
+    }
+}
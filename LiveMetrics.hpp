@@ -0,0 +1,61 @@
+//
+//  LiveMetrics.hpp
+//  CloudSim
+//
+//  Counters of a run in progress, published in a POSIX shared-memory segment
+//  so another process can watch it without slowing it down or using the
+//  network. The simulator publishes when CLOUDSIM_LIVE names the segment (see
+//  InterfaceHooks.h), at most every 100 ms of wall time, and removes the name
+//  once the simulation completes; Tools/bin/livetop reads it.
+//
+//  The segment holds one LiveCounters behind a sequence number: the writer
+//  makes it odd, copies the counters in and makes it even again, and a reader
+//  copies them out and retries if the number was odd or changed meanwhile.
+//
+
+#ifndef LiveMetrics_hpp
+#define LiveMetrics_hpp
+
+#include <atomic>
+#include <string>
+
+#include "SimTypes.h"
+
+#define LIVE_METRICS_MAGIC   0x56494c43u        // "CLIV"
+#define LIVE_METRICS_VERSION 1
+
+struct LiveCounters {
+    int32_t pid;
+    uint32_t finished;                          // Set by the last publication
+    uint64_t wall_start_ns;                     // CLOCK_MONOTONIC, when InitScheduler ran
+    uint64_t wall_ns;                           // ... and when this was published
+    Time_t simulated_us;
+    uint64_t events;                            // Callbacks delivered
+    uint64_t tasks_total;                       // GetNumTasks() at InitScheduler
+    uint64_t tasks_arrived;
+    uint64_t tasks_completed;
+    uint64_t sla_warnings;
+    uint32_t machines;
+    uint32_t machines_awake;                    // In S0
+    double energy_kwh;                          // Machine_GetClusterEnergy()
+    double sla_violations[NUM_SLAS];            // GetSLAReport(), percent so far
+};
+
+struct LiveSegment {
+    uint32_t magic;
+    uint32_t version;
+    atomic<uint64_t> sequence;
+    LiveCounters counters;
+};
+
+// Segment names get a leading '/' if they have none. Both return nullptr and
+// set error when the segment cannot be created or opened.
+LiveSegment * CreateLiveSegment(const string & name, string & error);
+const LiveSegment * OpenLiveSegment(const string & name, string & error);
+void UnlinkLiveSegment(const string & name);
+
+void PublishLive(LiveSegment * segment, const LiveCounters & counters);
+// False if the segment is not a live metrics segment of this version
+bool ReadLive(const LiveSegment * segment, LiveCounters & counters);
+
+#endif /* LiveMetrics_hpp */
@@ -0,0 +1,91 @@
+//
+//  PlacementAudit.cpp
+//  CloudSim
+//
+
+#include "PlacementAudit.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+static const char * kSiteNames[] = {"best_vm", "new_vm"};
+static const char * kFilterNames[NUM_PLACEMENT_FILTERS] = {"state", "cpu", "vm_type", "memory"};
+
+static unsigned EnvUnsigned(const char * name, unsigned fallback) {
+    const char * value = getenv(name);
+    if (value == nullptr || *value == 0) return fallback;
+    long n = atol(value);
+    return n > 0 ? unsigned(n) : fallback;
+}
+
+void PlacementAudit::Configure() {
+    const char * file = getenv("CLOUDSIM_AUDIT");
+    if (file == nullptr || *file == 0) return;
+    filename = file;
+    sample = EnvUnsigned("CLOUDSIM_AUDIT_SAMPLE", 1);
+    capacity = EnvUnsigned("CLOUDSIM_AUDIT_ENTRIES", 4096);
+    topk = min(EnvUnsigned("CLOUDSIM_AUDIT_TOPK", 5), unsigned(PLACEMENT_MAX_TOPK));
+    ring.reserve(capacity);
+}
+
+void PlacementAudit::Start(Time_t time, TaskId_t task, PlacementSite_t site) {
+    current = {};
+    current.time = time;
+    current.task = task;
+    current.site = site;
+    current.chosen_vm = VMId_t(-1);
+    current.chosen_machine = MachineId_t(-1);
+}
+
+// Insertion into the top k, lowest score first; ties keep the earlier candidate as the scheduler does
+void PlacementAudit::Rank(const PlacementCandidate & candidate) {
+    current.candidates++;
+    unsigned at = current.top_count;
+    while (at > 0 && candidate.score < current.top[at - 1].score) at--;
+    if (at >= topk) return;
+    unsigned last = min(current.top_count, topk - 1);
+    for (unsigned i = last; i > at; i--) current.top[i] = current.top[i - 1];
+    current.top[at] = candidate;
+    if (current.top_count < topk) current.top_count++;
+}
+
+void PlacementAudit::Keep() {
+    bool sampled = decisions++ % sample == 0;
+    if (!sampled && current.chosen_vm != VMId_t(-1)) return;
+    if (ring.size() < capacity) ring.push_back(current);
+    else ring[next] = current;
+    next = (next + 1) % capacity;
+    kept++;
+}
+
+void PlacementAudit::Write() {
+    if (!IsOn()) return;
+    ofstream out(filename);
+    if (!out) throw runtime_error("PlacementAudit: could not write " + filename);
+    out << "{\"decisions\":" << decisions << ",\"kept\":" << kept << ",\"in_file\":" << ring.size()
+        << ",\"sample\":" << sample << ",\"topk\":" << topk << "}\n";
+    // Oldest first: once the ring has wrapped that is the slot about to be overwritten
+    size_t start = ring.size() < capacity ? 0 : next;
+    for (size_t i = 0; i < ring.size(); i++) {
+        const PlacementRecord & r = ring[(start + i) % ring.size()];
+        out << "{\"time\":" << r.time << ",\"task\":" << r.task << ",\"site\":\"" << kSiteNames[r.site]
+            << "\",\"candidates\":" << r.candidates << ",\"rejected\":{";
+        for (unsigned f = 0; f < NUM_PLACEMENT_FILTERS; f++) {
+            out << (f ? "," : "") << "\"" << kFilterNames[f] << "\":" << r.rejected[f];
+        }
+        out << "},\"top\":[";
+        for (unsigned c = 0; c < r.top_count; c++) {
+            const PlacementCandidate & p = r.top[c];
+            out << (c ? "," : "") << "{\"vm\":" << p.vm << ",\"machine\":" << p.machine << ",\"load\":" << p.load;
+            if (p.scored) out << ",\"speed_ratio\":" << p.speed_ratio << ",\"gpu_factor\":" << p.gpu_factor << ",\"score\":" << p.score << "}";
+            else out << ",\"speed_ratio\":null,\"gpu_factor\":null,\"score\":null,\"reason\":\"first_fit\"}";
+        }
+        out << "],\"chosen\":";
+        if (r.chosen_vm == VMId_t(-1)) out << "null";
+        else out << "{\"vm\":" << r.chosen_vm << ",\"machine\":" << r.chosen_machine << "}";
+        out << "}\n";
+    }
+    filename.clear();
+}
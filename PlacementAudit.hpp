@@ -0,0 +1,126 @@
+//
+//  PlacementAudit.hpp
+//  CloudSim
+//
+//  Optional record of why each task went where it did. Scheduler.cpp reports
+//  each placement decision here: the VMs (or machines, for the new-VM fallback
+//  in NewTask) it considered, the filter that rejected each one, and the score
+//  components of the ones that passed. The audit keeps the k best-scoring
+//  candidates and the choice.
+//
+//  Environment, read at Scheduler::Init():
+//      CLOUDSIM_AUDIT=file         turn the audit on; written when the simulation completes
+//      CLOUDSIM_AUDIT_SAMPLE=n     keep one decision in n (default 1, all of them)
+//      CLOUDSIM_AUDIT_ENTRIES=n    ring buffer size in decisions (default 4096);
+//                                  older ones are overwritten, so memory stays fixed
+//      CLOUDSIM_AUDIT_TOPK=n       candidates kept per decision (default 5, at most 8)
+//  Decisions that place nothing are always kept, sampled or not.
+//
+//  The file is JSON lines: a summary line with the decision counts, then one line
+//  per kept decision, oldest first:
+//      {"time":..,"task":..,"site":"best_vm","candidates":24,
+//       "rejected":{"state":0,"cpu":16,"vm_type":0,"memory":0},
+//       "top":[{"vm":..,"machine":..,"load":..,"speed_ratio":..,"gpu_factor":..,"score":..}],
+//       "chosen":{"vm":..,"machine":..}}
+//  "chosen" is null when nothing was placed. The fallback takes the first
+//  machine that fits without scoring, so its "top" is that machine with its
+//  load, null speed_ratio, gpu_factor and score, and "reason":"first_fit".
+//
+//  When the audit is off every call returns after one branch.
+//
+
+#ifndef PlacementAudit_hpp
+#define PlacementAudit_hpp
+
+#include <string>
+#include <vector>
+
+#include "SimTypes.h"
+
+typedef enum {
+    PLACE_BEST_VM,                      // Scheduler::AssignTaskToBestVM()
+    PLACE_NEW_VM                        // The fallback in Scheduler::NewTask() that creates a VM
+} PlacementSite_t;
+
+typedef enum {
+    REJECT_STATE,                       // Machine not in S0
+    REJECT_CPU,
+    REJECT_VM_TYPE,
+    REJECT_MEMORY
+} PlacementFilter_t;
+#define NUM_PLACEMENT_FILTERS 4
+
+#define PLACEMENT_MAX_TOPK 8
+
+struct PlacementCandidate {
+    VMId_t vm;
+    MachineId_t machine;
+    double load;
+    double speed_ratio;
+    double gpu_factor;
+    double score;
+    bool scored = true;                 // False for the fallback's first fit, which has only a load
+};
+
+struct PlacementRecord {
+    Time_t time;
+    TaskId_t task;
+    PlacementSite_t site;
+    unsigned candidates;
+    unsigned rejected[NUM_PLACEMENT_FILTERS];
+    unsigned top_count;
+    PlacementCandidate top[PLACEMENT_MAX_TOPK];     // Best score first
+    VMId_t chosen_vm;
+    MachineId_t chosen_machine;
+};
+
+class PlacementAudit {
+public:
+    // Reads the environment; the audit stays off without CLOUDSIM_AUDIT
+    void Configure();
+    bool IsOn() const { return !filename.empty(); }
+
+    // One decision is Begin(), a Reject(), Candidate() or FirstFit() per candidate, Choose()
+    // if something was placed, then End()
+    void Begin(Time_t time, TaskId_t task, PlacementSite_t site) {
+        if (IsOn()) Start(time, task, site);
+    }
+    void Reject(PlacementFilter_t filter) {
+        if (!IsOn()) return;
+        current.candidates++;
+        current.rejected[filter]++;
+    }
+    void Candidate(const PlacementCandidate & candidate) {
+        if (IsOn()) Rank(candidate);
+    }
+    // The fallback's pick, taken as the first that fits and never scored
+    void FirstFit(VMId_t vm, MachineId_t machine, double load) {
+        if (IsOn()) Rank({vm, machine, load, 0, 0, 0, false});
+    }
+    void Choose(VMId_t vm, MachineId_t machine) {
+        current.chosen_vm = vm;
+        current.chosen_machine = machine;
+    }
+    void End() {
+        if (IsOn()) Keep();
+    }
+
+    // Writes the file; throws runtime_error if it cannot
+    void Write();
+
+private:
+    void Start(Time_t time, TaskId_t task, PlacementSite_t site);
+    void Rank(const PlacementCandidate & candidate);
+    void Keep();
+
+    string filename;
+    unsigned sample = 1;
+    unsigned topk = 5;
+    PlacementRecord current = {};
+    vector<PlacementRecord> ring;
+    size_t capacity = 4096;
+    size_t next = 0;                    // Ring slot the next kept decision goes to
+    uint64_t decisions = 0, kept = 0;
+};
+
+#endif /* PlacementAudit_hpp */
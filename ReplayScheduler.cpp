@@ -0,0 +1,117 @@
+//
+//  ReplayScheduler.cpp
+//  CloudSim
+//
+//  A scheduler with no policy of its own: it reads a decision log recorded with
+//  CLOUDSIM_RECORD and issues the same commands during the same callbacks.
+//  Linked in place of Scheduler.o by 'make simulator-replay'.
+//
+//  Usage: CLOUDSIM_REPLAY=run.dlog ./simulator-replay workload.md
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+#include "DecisionLog.hpp"
+#include "Interfaces.h"
+
+static vector<Decision> decisions;          // Sorted by callback, recorded order within a callback
+static unordered_map<VMId_t, VMId_t> vm_ids;// Recorded VM id -> VM id in this run
+static uint64_t callbacks_delivered = 0;
+static uint64_t replayed = 0;
+static bool diverged = false;
+
+static VMId_t MapVM(VMId_t recorded) {
+    auto it = vm_ids.find(recorded);
+    return it == vm_ids.end() ? recorded : it->second;
+}
+
+static void Apply(const Decision & d) {
+    switch (d.command) {
+        case CMD_VM_CREATE:
+            vm_ids[d.args[2]] = VM_Create(VMType_t(d.args[0]), CPUType_t(d.args[1]));
+            break;
+        case CMD_VM_ATTACH:
+            VM_Attach(MapVM(d.args[0]), d.args[1]);
+            break;
+        case CMD_VM_ADD_TASK:
+            VM_AddTask(MapVM(d.args[0]), d.args[1], Priority_t(d.args[2]));
+            break;
+        case CMD_VM_MIGRATE:
+            VM_Migrate(MapVM(d.args[0]), d.args[1]);
+            break;
+        case CMD_VM_REMOVE_TASK:
+            VM_RemoveTask(MapVM(d.args[0]), d.args[1]);
+            break;
+        case CMD_VM_SHUTDOWN:
+            VM_Shutdown(MapVM(d.args[0]));
+            break;
+        case CMD_MACHINE_SET_STATE:
+            Machine_SetState(d.args[0], MachineState_t(d.args[1]));
+            break;
+        case CMD_MACHINE_SET_CORE_PERFORMANCE:
+            Machine_SetCorePerformance(d.args[0], d.args[1], CPUPerformance_t(d.args[2]));
+            break;
+        case CMD_SET_TASK_PRIORITY:
+            SetTaskPriority(d.args[0], Priority_t(d.args[1]));
+            break;
+    }
+    replayed++;
+}
+
+// Issues the commands recorded for the next callback. Re-entrant: a command can
+// make the simulator deliver a nested callback, which replays its own commands.
+static void Replay(Time_t now) {
+    uint64_t number = ++callbacks_delivered;
+    auto first = lower_bound(decisions.begin(), decisions.end(), number,
+                             [](const Decision & d, uint64_t n) { return d.callback < n; });
+    for (auto it = first; it != decisions.end() && it->callback == number; ++it) {
+        if (it->time != now && !diverged) {
+            diverged = true;
+            SimOutput("Replay(): callback " + to_string(number) + " arrived at " + to_string(now) +
+                      " but was recorded at " + to_string(it->time) + "; the run has diverged", 0);
+        }
+        Apply(*it);
+    }
+}
+
+void InitScheduler() {
+    const char * filename = getenv("CLOUDSIM_REPLAY");
+    if (filename == nullptr || *filename == '\0') {
+        ThrowException("InitScheduler(): set CLOUDSIM_REPLAY to the decision log to replay");
+    }
+    try {
+        DecisionReader reader;
+        reader.Open(filename);
+        Decision d;
+        while (reader.Next(d)) decisions.push_back(d);
+    } catch (const exception & e) {
+        ThrowException(e.what());
+    }
+    stable_sort(decisions.begin(), decisions.end(),
+                [](const Decision & a, const Decision & b) { return a.callback < b.callback; });
+    SimOutput("InitScheduler(): Replaying " + to_string(decisions.size()) + " decisions from " + filename, 1);
+    Replay(Now());
+}
+
+void HandleNewTask(Time_t time, TaskId_t task_id)               { Replay(time); }
+void HandleTaskCompletion(Time_t time, TaskId_t task_id)        { Replay(time); }
+void MemoryWarning(Time_t time, MachineId_t machine_id)         { Replay(time); }
+void MigrationDone(Time_t time, VMId_t vm_id)                   { Replay(time); }
+void SchedulerCheck(Time_t time)                                { Replay(time); }
+void SLAWarning(Time_t time, TaskId_t task_id)                  { Replay(time); }
+void StateChangeComplete(Time_t time, MachineId_t machine_id)   { Replay(time); }
+
+void SimulationComplete(Time_t time) {
+    cout << "SLA violation report" << endl;
+    cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
+    cout << "SLA1: " << GetSLAReport(SLA1) << "%" << endl;
+    cout << "SLA2: " << GetSLAReport(SLA2) << "%" << endl;
+    cout << "Total Energy " << Machine_GetClusterEnergy() << " KW-Hour" << endl;
+    cout << "Simulation run finished in " << double(time)/1000000 << " seconds" << endl;
+
+    Replay(time);
+    cout << "Replayed " << replayed << " of " << decisions.size() << " decisions"
+         << (diverged ? " (diverged)" : "") << endl;
+}
@@ -5,8 +5,9 @@
 #include <algorithm>
 #include <cfloat>
 
-
-static unsigned active_machines = 60;
+#ifdef STATIC_CLUSTER
+#include "StaticCluster.hpp"
+#endif
 
 VMType_t Scheduler::GetDefaultVMForCPU(CPUType_t cpu_type) {
     switch (cpu_type) {
@@ -24,21 +25,38 @@ VMType_t Scheduler::GetDefaultVMForCPU(CPUType_t cpu_type) {
 
 void Scheduler::Init() {
     SimOutput("Scheduler::Init(): Initializing scheduler with improved SLA-awareness", 1);
+
+    string params_file = SchedulerParamsFile();
+    if (!params_file.empty()) {
+        try {
+            params = ReadSchedulerParams(params_file);
+        } catch (const exception & e) {
+            ThrowException("Scheduler::Init(): ", e.what());
+        }
+        SimOutput("Scheduler::Init(): Using parameters from " + params_file, 1);
+    }
     
     unsigned total_machines = Machine_GetTotal();
     unordered_map<CPUType_t, vector<MachineId_t>> machine_groups;
 
+#ifdef STATIC_CLUSTER
+    StaticCluster::Verify();
+    for (unsigned i = 0; i < total_machines; i++) {
+        machine_groups[StaticCluster::CPU(MachineId_t(i))].push_back(MachineId_t(i));
+    }
+#else
     for (unsigned i = 0; i < total_machines; i++) {
         MachineInfo_t machine_info = Machine_GetInfo(MachineId_t(i));
         machine_groups[machine_info.cpu].push_back(MachineId_t(i));
     }
+#endif
 
     // New vms and machines base on groups
     for (auto &group : machine_groups) {
         CPUType_t cpu_type = group.first;
         vector<MachineId_t> &group_machines = group.second;
 
-        unsigned init_vms = std::min((unsigned)(group_machines.size()), (unsigned)(active_machines / (machine_groups.size())));
+        unsigned init_vms = std::min((unsigned)(group_machines.size()), (unsigned)(params.active_machines) / (unsigned)(machine_groups.size()));
         for (unsigned i = 0; i < init_vms; i++) {
             MachineId_t machine_id = group_machines[i];
             Machine_SetState(machine_id, S0);
@@ -57,6 +75,7 @@ void Scheduler::Init() {
         }
     }
 
+    audit.Configure();
     SimOutput("Scheduler::Init(): Completed initialization with SLA considerations", 1);
 }
 
@@ -80,24 +99,38 @@ void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
     VMId_t assigned_vm = AssignTaskToBestVM(task_id);
     if (assigned_vm == VMId_t(-1)) {
         // If we failed to find a good VM, try activating a new machine
-        
-for (MachineId_t machine_id : machines) {
-    MachineInfo_t machine_info = Machine_GetInfo(machine_id);
-    if (machine_info.s_state == S0 &&
-        machine_info.cpu == task_info.required_cpu &&
-        (machine_info.memory_size - machine_info.memory_used) >= (task_info.required_memory + VM_MEMORY_OVERHEAD)) {
-
-        VMId_t new_vm = VM_Create(task_info.required_vm, task_info.required_cpu);
-        VM_Attach(new_vm, machine_id);
-        VM_AddTask(new_vm, task_id, task_info.priority);
-
-        vms.push_back(new_vm);
-        active_tasks.push_back({task_id, task_info.required_sla, task_info.target_completion, new_vm});
-        SimOutput("Scheduler::NewTask(): Created exact required VM " + to_string(new_vm) + 
-                  " on machine " + to_string(machine_id) + " for task " + to_string(task_id), 2);
-        return;
-    }
-}
+        audit.Begin(now, task_id, PLACE_NEW_VM);
+        for (MachineId_t machine_id : machines) {
+            MachineInfo_t machine_info = Machine_GetInfo(machine_id);
+            if (machine_info.s_state != S0) {
+                audit.Reject(REJECT_STATE);
+                continue;
+            }
+            if (machine_info.cpu != task_info.required_cpu) {
+                audit.Reject(REJECT_CPU);
+                continue;
+            }
+            if ((machine_info.memory_size - machine_info.memory_used) < (task_info.required_memory + VM_MEMORY_OVERHEAD)) {
+                audit.Reject(REJECT_MEMORY);
+                continue;
+            }
+
+            VMId_t new_vm = VM_Create(task_info.required_vm, task_info.required_cpu);
+            VM_Attach(new_vm, machine_id);
+            VM_AddTask(new_vm, task_id, task_info.priority);
+
+            double load = (double)machine_info.active_tasks / (double)machine_info.num_cpus;
+            audit.FirstFit(new_vm, machine_id, load);
+            audit.Choose(new_vm, machine_id);
+            audit.End();
+
+            vms.push_back(new_vm);
+            active_tasks.push_back({task_id, task_info.required_sla, task_info.target_completion, new_vm});
+            SimOutput("Scheduler::NewTask(): Created exact required VM " + to_string(new_vm) + 
+                      " on machine " + to_string(machine_id) + " for task " + to_string(task_id), 2);
+            return;
+        }
+        audit.End();
     } else {
         at.vm_id = assigned_vm;
         active_tasks.push_back(at);
@@ -109,45 +142,67 @@ VMId_t Scheduler::AssignTaskToBestVM(TaskId_t task_id) {
     TaskInfo_t task_info = GetTaskInfo(task_id);
 
     VMId_t best_vm = VMId_t(-1);
+    MachineId_t best_machine = MachineId_t(-1);
     double best_score = DBL_MAX;
+    audit.Begin(task_info.arrival, task_id, PLACE_BEST_VM);     // NewTask calls this as the task arrives
 
     for (VMId_t vm : vms) {
         VMInfo_t vm_info = VM_GetInfo(vm);
+#ifdef STATIC_CLUSTER
+        if (StaticCluster::CPU(vm_info.machine_id) != task_info.required_cpu) {
+            audit.Reject(REJECT_CPU);
+            continue; // must match CPU, known without asking the machine
+        }
+#endif
         MachineInfo_t mach_info = Machine_GetInfo(vm_info.machine_id);
         
-        if (mach_info.s_state != S0)
+        if (mach_info.s_state != S0) {
+            audit.Reject(REJECT_STATE);
             continue; // must be active machine
+        }
 
-        if (mach_info.cpu != task_info.required_cpu)
+        if (mach_info.cpu != task_info.required_cpu) {
+            audit.Reject(REJECT_CPU);
             continue; // must match CPU
+        }
 
-        if (vm_info.vm_type != task_info.required_vm)
+        if (vm_info.vm_type != task_info.required_vm) {
+            audit.Reject(REJECT_VM_TYPE);
             continue; // must match VM type
+        }
 
         unsigned needed_mem = task_info.required_memory + VM_MEMORY_OVERHEAD;
-        if (mach_info.memory_used + needed_mem > mach_info.memory_size)
+        if (mach_info.memory_used + needed_mem > mach_info.memory_size) {
+            audit.Reject(REJECT_MEMORY);
             continue; // memory fits?
+        }
 
         // Heuristic to score this VM:
         double load = CalculateMachineLoad(mach_info.machine_id);
         double perf_factor = 1.0;
         if (task_info.gpu_capable && mach_info.gpus) {
-            perf_factor = 0.5; // just a heuristic: GPU speeds up tasks
+            perf_factor = params.gpu_perf_factor; // just a heuristic: GPU speeds up tasks
         }
 
         // Adjust for P-state (lower P-state = P3 means slower)
         // performance[P0] would be the highest MIPS, we can scale inversely:
         // For example: 
+#ifdef STATIC_CLUSTER
+        double speed_ratio = StaticCluster::SpeedRatio(mach_info.machine_id, mach_info.p_state);
+#else
         unsigned p0_mips = mach_info.performance[0];
         unsigned current_mips = mach_info.performance[mach_info.p_state];
         double speed_ratio = (double)p0_mips / (double)current_mips;
+#endif
         
         // Combine into a simple score
         double score = load * speed_ratio * perf_factor;
+        audit.Candidate({vm, vm_info.machine_id, load, speed_ratio, perf_factor, score});
 
         if (score < best_score) {
             best_score = score;
             best_vm = vm;
+            best_machine = vm_info.machine_id;
         }
     }
 
@@ -155,7 +210,9 @@ VMId_t Scheduler::AssignTaskToBestVM(TaskId_t task_id) {
         // Assign task to this VM
         TaskInfo_t task_info2 = GetTaskInfo(task_id);
         VM_AddTask(best_vm, task_id, task_info2.priority);
+        audit.Choose(best_vm, best_machine);
     }
+    audit.End();
     return best_vm;
 }
 
@@ -168,13 +225,13 @@ double Scheduler::CalculateMachineLoad(MachineId_t machine_id) {
 
 CPUPerformance_t Scheduler::GetPStateForLoad(double load) {
     // Simple heuristic:
-    // if load > 0.8: P0
-    // if load > 0.5: P1
-    // if load > 0.2: P2
+    // if load > pstate_p0_load (0.8): P0
+    // if load > pstate_p1_load (0.5): P1
+    // if load > pstate_p2_load (0.2): P2
     // else: P3
-    if (load > 0.8) return P0;
-    else if (load > 0.5) return P1;
-    else if (load > 0.2) return P2;
+    if (load > params.pstate_p0_load) return P0;
+    else if (load > params.pstate_p1_load) return P1;
+    else if (load > params.pstate_p2_load) return P2;
     else return P3;
 }
 
@@ -208,12 +265,16 @@ void Scheduler::CheckDeadlinesAndRebalance(Time_t now) {
             // Rough estimate of finish time:
             VMInfo_t vm_info = VM_GetInfo(task.vm_id);
             MachineInfo_t mach_info = Machine_GetInfo(vm_info.machine_id);
+#ifdef STATIC_CLUSTER
+            unsigned current_mips = StaticCluster::MIPS(mach_info.machine_id, mach_info.p_state);
+#else
             unsigned current_mips = mach_info.performance[mach_info.p_state];
+#endif
             // Time to finish = instructions_remaining / (mips * 1e6)
             double time_to_finish = (double)info.remaining_instructions / ((double)current_mips * 1e6);
             Time_t time_to_finish_us = (Time_t)(time_to_finish * 1000000);
 
-            if (time_to_finish_us > remaining_time / 2) {
+            if (time_to_finish_us > remaining_time * params.rescue_fraction) {
                 // Try to boost machine performance or migrate this VM to a faster machine:
                 BoostMachinePerformance(mach_info.machine_id);
                 // Potentially migrate to a better machine if available:
@@ -243,6 +304,11 @@ void Scheduler::Shutdown(Time_t time) {
         // Shutdown all VMs:
         VM_Shutdown(vm);
     }
+    try {
+        audit.Write();
+    } catch (const exception & e) {
+        ThrowException("Scheduler::Shutdown(): ", e.what());
+    }
     SimOutput("SimulationComplete(): Finished!", 4);
     SimOutput("SimulationComplete(): Time is " + to_string(time), 4);
 }
@@ -260,35 +326,42 @@ void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
 static Scheduler Scheduler;
 
 void InitScheduler() {
+    CallbackScope callback(CB_INIT, Now());
     SimOutput("InitScheduler(): Initializing scheduler", 4);
     Scheduler.Init();
 }
 
 void HandleNewTask(Time_t time, TaskId_t task_id) {
+    CallbackScope callback(CB_NEW_TASK, time, task_id);
     SimOutput("HandleNewTask(): Received new task " + to_string(task_id) + " at time " + to_string(time), 4);
     Scheduler.NewTask(time, task_id);
 }
 
 void HandleTaskCompletion(Time_t time, TaskId_t task_id) {
+    CallbackScope callback(CB_TASK_COMPLETION, time, task_id);
     SimOutput("HandleTaskCompletion(): Task " + to_string(task_id) + " completed at time " + to_string(time), 4);
     Scheduler.TaskComplete(time, task_id);
 }
 
 void MemoryWarning(Time_t time, MachineId_t machine_id) {
+    CallbackScope callback(CB_MEMORY_WARNING, time, machine_id);
     SimOutput("MemoryWarning(): Overflow at " + to_string(machine_id) + " was detected at time " + to_string(time), 0);
 }
 
 void MigrationDone(Time_t time, VMId_t vm_id) {
+    CallbackScope callback(CB_MIGRATION_DONE, time, vm_id);
     SimOutput("MigrationDone(): Migration of VM " + to_string(vm_id) + " was completed at time " + to_string(time), 4);
     Scheduler.MigrationComplete(time, vm_id);
 }
 
 void SchedulerCheck(Time_t time) {
+    CallbackScope callback(CB_SCHEDULER_CHECK, time);
     SimOutput("SchedulerCheck(): SchedulerCheck() called at " + to_string(time), 4);
     Scheduler.PeriodicCheck(time);
 }
 
 void SimulationComplete(Time_t time) {
+    CallbackScope callback(CB_SIMULATION_COMPLETE, time);
     cout << "SLA violation report" << endl;
     cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
     cout << "SLA1: " << GetSLAReport(SLA1) << "%" << endl;
@@ -301,10 +374,12 @@ void SimulationComplete(Time_t time) {
 }
 
 void SLAWarning(Time_t time, TaskId_t task_id) {
+    CallbackScope callback(CB_SLA_WARNING, time, task_id);
     Scheduler.HandleSLAWarning(time, task_id);
 }
 
 void StateChangeComplete(Time_t time, MachineId_t machine_id) {
+    CallbackScope callback(CB_STATE_CHANGE_COMPLETE, time, machine_id);
     SimOutput("StateChangeComplete(): State change for machine " + to_string(machine_id) + " completed at time " + to_string(time), 2);
 
     // If this callback indicates a machine is now S0, you can now safely proceed with VM shutdown if you were waiting.
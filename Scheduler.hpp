@@ -11,10 +11,15 @@
 
 #include <vector>
 #include "Interfaces.h"
+#include "InterfaceHooks.h"
+#include "SchedulerParams.hpp"
+#include "PlacementAudit.hpp"
 
 class Scheduler {
 public:
     Scheduler() {}
+    // Starts from these parameters instead of the defaults (a parameters file still wins in Init)
+    explicit Scheduler(const SchedulerParams & params) : params(params) {}
 
     void Init();
     void MigrationComplete(Time_t time, VMId_t vm_id);
@@ -34,6 +39,8 @@ public:
     void CheckDeadlinesAndRebalance(Time_t now);
 
 private:
+    SchedulerParams params;
+    PlacementAudit audit;               // Off unless CLOUDSIM_AUDIT is set
     vector<VMId_t> vms;
     vector<MachineId_t> machines;
 
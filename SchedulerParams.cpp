@@ -0,0 +1,95 @@
+//
+//  SchedulerParams.cpp
+//  CloudSim
+//
+
+#include "SchedulerParams.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+const SchedulerParamSpec kSchedulerParams[] = {
+    {"active_machines", &SchedulerParams::active_machines, true,  1,    100000},
+    {"pstate_p0_load",  &SchedulerParams::pstate_p0_load,  false, 0,    2},
+    {"pstate_p1_load",  &SchedulerParams::pstate_p1_load,  false, 0,    2},
+    {"pstate_p2_load",  &SchedulerParams::pstate_p2_load,  false, 0,    2},
+    {"rescue_fraction", &SchedulerParams::rescue_fraction, false, 0.05, 1},
+    {"gpu_perf_factor", &SchedulerParams::gpu_perf_factor, false, 0.05, 2},
+};
+const unsigned kSchedulerParamCount = sizeof(kSchedulerParams) / sizeof(kSchedulerParams[0]);
+
+const SchedulerParamSpec * FindSchedulerParam(const string & name) {
+    for (unsigned i = 0; i < kSchedulerParamCount; i++) {
+        if (name == kSchedulerParams[i].name) return &kSchedulerParams[i];
+    }
+    return nullptr;
+}
+
+void SetSchedulerParam(SchedulerParams & params, const string & name, const string & value) {
+    const SchedulerParamSpec * spec = FindSchedulerParam(name);
+    if (spec == nullptr) throw runtime_error("unknown scheduler parameter " + name);
+    char * end;
+    double number = strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !isfinite(number)) throw runtime_error(name + ": not a number: " + value);
+    if (spec->integer && number != floor(number)) throw runtime_error(name + ": must be a whole number");
+    if (number < spec->lo || number > spec->hi) {
+        ostringstream range;
+        range << name << ": " << value << " is outside [" << spec->lo << ", " << spec->hi << "]";
+        throw runtime_error(range.str());
+    }
+    params.*spec->field = number;
+}
+
+SchedulerParams ReadSchedulerParams(const string & filename) {
+    ifstream in(filename);
+    if (!in) throw runtime_error("could not open " + filename);
+    SchedulerParams params;
+    string line;
+    unsigned number = 0;
+    while (getline(in, line)) {
+        number++;
+        line = line.substr(0, line.find('#'));
+        istringstream fields(line);
+        string name, value, extra;
+        if (!(fields >> name)) continue;
+        if (!(fields >> value) || fields >> extra) {
+            throw runtime_error(filename + ":" + to_string(number) + ": expected \"name value\"");
+        }
+        try {
+            SetSchedulerParam(params, name, value);
+        } catch (const exception & e) {
+            throw runtime_error(filename + ":" + to_string(number) + ": " + e.what());
+        }
+    }
+    try {
+        ValidateSchedulerParams(params);
+    } catch (const exception & e) {
+        throw runtime_error(filename + ": " + e.what());
+    }
+    return params;
+}
+
+void ValidateSchedulerParams(const SchedulerParams & params) {
+    if (!(params.pstate_p0_load > params.pstate_p1_load && params.pstate_p1_load > params.pstate_p2_load)) {
+        ostringstream out;
+        out << "the P-state thresholds must fall from P0 to P2, got pstate_p0_load " << params.pstate_p0_load
+            << ", pstate_p1_load " << params.pstate_p1_load << ", pstate_p2_load " << params.pstate_p2_load;
+        throw runtime_error(out.str());
+    }
+}
+
+void WriteSchedulerParams(ostream & out, const SchedulerParams & params) {
+    for (unsigned i = 0; i < kSchedulerParamCount; i++) {
+        out << left << setw(18) << kSchedulerParams[i].name << right << setprecision(10)
+            << params.*kSchedulerParams[i].field << endl;
+    }
+}
+
+string SchedulerParamsFile() {
+    const char * file = getenv("CLOUDSIM_PARAMS");
+    return file ? file : "";
+}
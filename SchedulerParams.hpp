@@ -0,0 +1,68 @@
+//
+//  SchedulerParams.hpp
+//  CloudSim
+//
+//  The scheduler's tuning knobs, read once at Scheduler::Init() from the file
+//  named by CLOUDSIM_PARAMS; Init logs the file it used. Without it the
+//  defaults below apply: the values the policy was written with, or the best
+//  setting found by tune --update-defaults, which rewrites them. A file lying
+//  in the working directory is never picked up on its own, so a run's
+//  parameters are always visible in how it was started or in this header.
+//
+//  Format: one "name value" pair per line, '#' starts a comment. Names not set
+//  keep their default; unknown names and out-of-range values are errors, and so
+//  are P-state thresholds that do not fall from pstate_p0_load to pstate_p2_load.
+//      active_machines   40
+//      pstate_p0_load    0.85
+//
+//  Tools/bin/sweep and the tuner write these files; kSchedulerParams also gives
+//  them each knob's search range.
+//
+
+#ifndef SchedulerParams_hpp
+#define SchedulerParams_hpp
+
+#include <iosfwd>
+#include <string>
+
+#include "SimTypes.h"
+
+struct SchedulerParams {
+    double active_machines = 60;        // Machines (split evenly over CPU types) left on at Init
+    double pstate_p0_load = 0.8;        // Machine load above which PeriodicCheck picks P0,
+    double pstate_p1_load = 0.5;        // ... P1,
+    double pstate_p2_load = 0.2;        // ... P2, else P3
+    double rescue_fraction = 0.5;       // Boost a task's machine once its estimated time to finish exceeds
+                                        // this fraction of the time left to its deadline
+    double gpu_perf_factor = 0.5;       // Score multiplier for a GPU machine when the task is GPU capable
+};
+
+struct SchedulerParamSpec {
+    const char * name;
+    double SchedulerParams::* field;
+    bool integer;
+    double lo, hi;                      // Valid range; also the default search range of the tools
+};
+
+extern const SchedulerParamSpec kSchedulerParams[];
+extern const unsigned kSchedulerParamCount;
+
+// The spec for a name, nullptr if there is none
+const SchedulerParamSpec * FindSchedulerParam(const string & name);
+
+// Sets one knob from its text value. Throws runtime_error on unknown names and bad values.
+void SetSchedulerParam(SchedulerParams & params, const string & name, const string & value);
+
+// Throws runtime_error naming the file and line on any error
+SchedulerParams ReadSchedulerParams(const string & filename);
+
+// Throws runtime_error unless pstate_p0_load > pstate_p1_load > pstate_p2_load
+void ValidateSchedulerParams(const SchedulerParams & params);
+
+// Every knob, in file format, so that reading it back gives the same values
+void WriteSchedulerParams(ostream & out, const SchedulerParams & params);
+
+// CLOUDSIM_PARAMS, or "" if it is not set
+string SchedulerParamsFile();
+
+#endif /* SchedulerParams_hpp */
@@ -0,0 +1,262 @@
+//
+//  Snapshot.cpp
+//  CloudSim
+//
+
+#include "Snapshot.hpp"
+#include "TypeNames.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+static const char * kStateNames[] = {"S0", "S0i1", "S1", "S2", "S3", "S4", "S5"};
+static const char * kPStateNames[] = {"P0", "P1", "P2", "P3"};
+static const char * kPriorityNames[] = {"HIGH", "MID", "LOW"};
+
+string SnapshotStateName(MachineState_t s_state) { return kStateNames[s_state]; }
+string SnapshotPStateName(CPUPerformance_t p_state) { return kPStateNames[p_state]; }
+string SnapshotPriorityName(Priority_t priority) { return kPriorityNames[priority]; }
+
+template <typename T>
+static void WriteList(ostream & out, const vector<T> & ids) {
+    out << "[";
+    for (size_t i = 0; i < ids.size(); i++) out << (i ? "," : "") << ids[i];
+    out << "]";
+}
+
+static void WriteId(ostream & out, unsigned id) {
+    if (id == SNAPSHOT_NONE) out << "null";
+    else out << id;
+}
+
+void WriteSnapshot(const ClusterSnapshot & snapshot, const string & filename) {
+    ofstream out(filename);
+    if (!out) throw runtime_error("Snapshot: could not write " + filename);
+    out << "{\"time\":" << snapshot.time << ",\"reason\":\"" << snapshot.reason << "\",\n\"machines\":[";
+    for (size_t i = 0; i < snapshot.machines.size(); i++) {
+        const SnapshotMachine & m = snapshot.machines[i];
+        out << (i ? ",\n" : "\n") << "{\"id\":" << m.id << ",\"cpu\":\"" << CPUName(m.cpu) << "\",\"cores\":" << m.cores
+            << ",\"gpus\":" << (m.gpus ? "true" : "false") << ",\"state\":\"" << kStateNames[m.s_state] << "\",\"p_state\":\""
+            << kPStateNames[m.p_state] << "\",\"memory_used\":" << m.memory_used << ",\"memory_size\":" << m.memory_size
+            << ",\"energy\":" << m.energy << ",\"vms\":";
+        WriteList(out, m.vms);
+        out << ",\"tasks\":";
+        WriteList(out, m.tasks);
+        out << "}";
+    }
+    out << "],\n\"vms\":[";
+    for (size_t i = 0; i < snapshot.vms.size(); i++) {
+        const SnapshotVM & v = snapshot.vms[i];
+        out << (i ? ",\n" : "\n") << "{\"id\":" << v.id << ",\"type\":\"" << VMName(v.type) << "\",\"cpu\":\"" << CPUName(v.cpu)
+            << "\",\"host\":";
+        WriteId(out, v.host);
+        out << ",\"migrating_to\":";
+        WriteId(out, v.migrating_to);
+        out << ",\"tasks\":";
+        WriteList(out, v.tasks);
+        out << "}";
+    }
+    out << "],\n\"tasks\":[";
+    for (size_t i = 0; i < snapshot.tasks.size(); i++) {
+        const SnapshotTask & t = snapshot.tasks[i];
+        out << (i ? ",\n" : "\n") << "{\"id\":" << t.id << ",\"vm\":";
+        WriteId(out, t.vm);
+        out << ",\"remaining\":" << t.remaining << ",\"total\":" << t.total << ",\"arrival\":" << t.arrival << ",\"deadline\":"
+            << t.deadline << ",\"priority\":\"" << kPriorityNames[t.priority] << "\",\"sla\":\"" << SLAName(t.sla) << "\",\"cpu\":\""
+            << CPUName(t.cpu) << "\",\"vm_type\":\"" << VMName(t.vm_type) << "\",\"memory\":" << t.memory << ",\"gpu\":"
+            << (t.gpu ? "true" : "false") << ",\"late\":" << (t.late ? "true" : "false") << "}";
+    }
+    out << "]}\n";
+    if (!out) throw runtime_error("Snapshot: could not write " + filename);
+}
+
+// Reading: a small JSON parser, so snapshots that were reformatted (by jq, say) still load
+
+namespace {
+
+struct Json {
+    enum { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } kind = NUL;
+    bool boolean = false;
+    string text;                        // NUMBER keeps its digits, so 64-bit values stay exact
+    vector<Json> items;
+    map<string, Json> fields;
+
+    const Json & operator[](const string & key) const {
+        auto it = fields.find(key);
+        if (kind != OBJECT || it == fields.end()) throw runtime_error("missing \"" + key + "\"");
+        return it->second;
+    }
+    uint64_t Unsigned() const {
+        if (kind != NUMBER) throw runtime_error("expected a number");
+        return strtoull(text.c_str(), nullptr, 10);
+    }
+    unsigned Id() const { return kind == NUL ? SNAPSHOT_NONE : unsigned(Unsigned()); }
+    bool Bool() const {
+        if (kind != BOOL) throw runtime_error("expected true or false");
+        return boolean;
+    }
+    const string & String() const {
+        if (kind != STRING) throw runtime_error("expected a string");
+        return text;
+    }
+    const vector<Json> & Array() const {
+        if (kind != ARRAY) throw runtime_error("expected an array");
+        return items;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const string & text) : text(text) {}
+
+    Json Parse() {
+        Json value = Value();
+        Space();
+        if (at != text.size()) Fail("trailing characters");
+        return value;
+    }
+
+private:
+    const string & text;
+    size_t at = 0;
+
+    [[noreturn]] void Fail(const string & what) {
+        throw runtime_error(what + " at offset " + to_string(at));
+    }
+
+    void Space() {
+        while (at < text.size() && isspace((unsigned char)text[at])) at++;
+    }
+
+    void Expect(char ch) {
+        Space();
+        if (at >= text.size() || text[at] != ch) Fail(string("expected '") + ch + "'");
+        at++;
+    }
+
+    bool Word(const char * word) {
+        size_t n = char_traits<char>::length(word);
+        if (text.compare(at, n, word) != 0) return false;
+        at += n;
+        return true;
+    }
+
+    string String() {
+        Expect('"');
+        string out;
+        while (at < text.size() && text[at] != '"') {
+            if (text[at] == '\\' && at + 1 < text.size()) at++;
+            out += text[at++];
+        }
+        if (at >= text.size()) Fail("unterminated string");
+        at++;
+        return out;
+    }
+
+    Json Value() {
+        Json value;
+        Space();
+        if (at >= text.size()) Fail("unexpected end");
+        char ch = text[at];
+        if (ch == '{') {
+            value.kind = Json::OBJECT;
+            at++;
+            Space();
+            if (at < text.size() && text[at] == '}') { at++; return value; }
+            for (;;) {
+                string key = String();
+                Expect(':');
+                value.fields[key] = Value();
+                Space();
+                if (at < text.size() && text[at] == ',') { at++; continue; }
+                Expect('}');
+                return value;
+            }
+        }
+        if (ch == '[') {
+            value.kind = Json::ARRAY;
+            at++;
+            Space();
+            if (at < text.size() && text[at] == ']') { at++; return value; }
+            for (;;) {
+                value.items.push_back(Value());
+                Space();
+                if (at < text.size() && text[at] == ',') { at++; continue; }
+                Expect(']');
+                return value;
+            }
+        }
+        if (ch == '"') {
+            value.kind = Json::STRING;
+            value.text = String();
+            return value;
+        }
+        if (Word("true")) { value.kind = Json::BOOL; value.boolean = true; return value; }
+        if (Word("false")) { value.kind = Json::BOOL; return value; }
+        if (Word("null")) return value;
+        size_t start = at;
+        while (at < text.size() && (isdigit((unsigned char)text[at]) || (text[at] && strchr("+-.eE", text[at])))) at++;
+        if (at == start) Fail("unexpected character");
+        value.kind = Json::NUMBER;
+        value.text = text.substr(start, at - start);
+        return value;
+    }
+};
+
+}
+
+template <size_t N>
+static unsigned Lookup(const char * (&names)[N], const Json & value) {
+    for (unsigned i = 0; i < N; i++) {
+        if (value.String() == names[i]) return i;
+    }
+    throw runtime_error("unknown name \"" + value.String() + "\"");
+}
+
+template <typename T>
+static vector<T> ReadList(const Json & value) {
+    vector<T> ids;
+    for (auto & item : value.Array()) ids.push_back(T(item.Unsigned()));
+    return ids;
+}
+
+ClusterSnapshot ReadSnapshot(const string & filename) {
+    ifstream in(filename);
+    if (!in) throw runtime_error("could not read " + filename);
+    ostringstream buffer;
+    buffer << in.rdbuf();
+    string text = buffer.str();
+
+    ClusterSnapshot snapshot;
+    try {
+        Json root = JsonParser(text).Parse();
+        snapshot.time = root["time"].Unsigned();
+        snapshot.reason = root["reason"].String();
+        for (auto & m : root["machines"].Array()) {
+            snapshot.machines.push_back({m["id"].Id(), ParseCPU(m["cpu"].String()), unsigned(m["cores"].Unsigned()),
+                                         m["gpus"].Bool(), MachineState_t(Lookup(kStateNames, m["state"])),
+                                         CPUPerformance_t(Lookup(kPStateNames, m["p_state"])), unsigned(m["memory_used"].Unsigned()),
+                                         unsigned(m["memory_size"].Unsigned()), m["energy"].Unsigned(), ReadList<VMId_t>(m["vms"]),
+                                         ReadList<TaskId_t>(m["tasks"])});
+        }
+        for (auto & v : root["vms"].Array()) {
+            snapshot.vms.push_back({v["id"].Id(), ParseVM(v["type"].String()), ParseCPU(v["cpu"].String()),
+                                    v["host"].Id(), v["migrating_to"].Id(), ReadList<TaskId_t>(v["tasks"])});
+        }
+        for (auto & t : root["tasks"].Array()) {
+            snapshot.tasks.push_back({t["id"].Id(), t["vm"].Id(), t["remaining"].Unsigned(), t["total"].Unsigned(),
+                                      t["arrival"].Unsigned(), t["deadline"].Unsigned(), Priority_t(Lookup(kPriorityNames, t["priority"])),
+                                      ParseSLA(t["sla"].String()), ParseCPU(t["cpu"].String()),
+                                      ParseVM(t["vm_type"].String()), unsigned(t["memory"].Unsigned()), t["gpu"].Bool(),
+                                      t["late"].Bool()});
+        }
+    } catch (const runtime_error & e) {
+        throw runtime_error(filename + " is not a snapshot: " + e.what());
+    }
+    return snapshot;
+}
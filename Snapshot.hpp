@@ -0,0 +1,95 @@
+//
+//  Snapshot.hpp
+//  CloudSim
+//
+//  The whole cluster at one moment of a run: every machine, every VM and every
+//  task that has arrived and not completed. The hooks take snapshots when
+//  CLOUDSIM_SNAPSHOT names a file prefix (see InterfaceHooks.h), each into its
+//  own file, and Tools/bin/snapdiff compares two of them.
+//
+//  The file is one JSON object, with one line per machine, VM and task so it
+//  can be grepped and read in a text diff as well as parsed:
+//      {"time":..,"reason":"..",
+//       "machines":[
+//        {"id":..,"cpu":"X86","cores":..,"gpus":..,"state":"S0","p_state":"P0",
+//         "memory_used":..,"memory_size":..,"energy":..,"vms":[..],"tasks":[..]},..],
+//       "vms":[
+//        {"id":..,"type":"LINUX","cpu":"X86","host":..,"migrating_to":null,"tasks":[..]},..],
+//       "tasks":[
+//        {"id":..,"vm":..,"remaining":..,"total":..,"arrival":..,"deadline":..,
+//         "priority":"HIGH","sla":"SLA0","cpu":"X86","vm_type":"LINUX","memory":..,
+//         "gpu":..,"late":..},..]}
+//  "host" is null for a VM not attached yet and "vm" for a task not placed on
+//  one. A machine's "vms" and "tasks" are those of the VMs whose host it is.
+//  A task that has finished is left out even before its completion callback.
+//  The CPU, VM and SLA names are those of TypeNames.hpp.
+//  Times are simulated microseconds and energy is the machine's energy_consumed.
+//
+
+#ifndef Snapshot_hpp
+#define Snapshot_hpp
+
+#include <string>
+#include <vector>
+
+#include "SimTypes.h"
+
+#define SNAPSHOT_NONE unsigned(-1)      // No host or no VM
+
+struct SnapshotMachine {
+    MachineId_t id;
+    CPUType_t cpu;
+    unsigned cores;
+    bool gpus;
+    MachineState_t s_state;
+    CPUPerformance_t p_state;
+    unsigned memory_used;
+    unsigned memory_size;
+    uint64_t energy;
+    vector<VMId_t> vms;
+    vector<TaskId_t> tasks;
+};
+
+struct SnapshotVM {
+    VMId_t id;
+    VMType_t type;
+    CPUType_t cpu;
+    MachineId_t host;                   // Or SNAPSHOT_NONE
+    MachineId_t migrating_to;           // Or SNAPSHOT_NONE when not migrating
+    vector<TaskId_t> tasks;
+};
+
+struct SnapshotTask {
+    TaskId_t id;
+    VMId_t vm;                          // Or SNAPSHOT_NONE
+    uint64_t remaining;
+    uint64_t total;
+    Time_t arrival;
+    Time_t deadline;                    // target_completion
+    Priority_t priority;
+    SLAType_t sla;
+    CPUType_t cpu;
+    VMType_t vm_type;
+    unsigned memory;
+    bool gpu;
+    bool late;                          // Past its deadline at the snapshot's time
+};
+
+struct ClusterSnapshot {
+    Time_t time = 0;
+    string reason;
+    vector<SnapshotMachine> machines;   // In id order
+    vector<SnapshotVM> vms;             // In id order
+    vector<SnapshotTask> tasks;         // In id order
+};
+
+// Both throw runtime_error: if the file cannot be written, or is missing or not a snapshot
+void WriteSnapshot(const ClusterSnapshot & snapshot, const string & filename);
+ClusterSnapshot ReadSnapshot(const string & filename);
+
+// Names as they appear in snapshot files
+string SnapshotStateName(MachineState_t s_state);
+string SnapshotPStateName(CPUPerformance_t p_state);
+string SnapshotPriorityName(Priority_t priority);
+
+#endif /* Snapshot_hpp */
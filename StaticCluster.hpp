@@ -0,0 +1,72 @@
+//
+//  StaticCluster.hpp
+//  CloudSim
+//
+//  Compile-time view of the machine fleet, for scheduler builds specialized to
+//  one cluster composition (make simulator-static WORKLOAD=...). The tables in
+//  ClusterConfig.hpp are generated by Tools/bin/clustercodegen; everything that
+//  never changes during a run (CPU type, cores, GPUs, MIPS ladder) is answered
+//  from them instead of a Machine_GetInfo() call.
+//
+
+#ifndef StaticCluster_hpp
+#define StaticCluster_hpp
+
+#include "ClusterConfig.hpp"
+#include "Interfaces.h"
+
+namespace StaticCluster {
+
+using ClusterConfig::kClasses;
+using ClusterConfig::kClassCount;
+using ClusterConfig::kMachineCount;
+
+constexpr bool ClassesAreContiguous() {
+    MachineId_t next = 0;
+    for (unsigned i = 0; i < kClassCount; i++) {
+        if (kClasses[i].first != next || kClasses[i].last <= kClasses[i].first) return false;
+        next = kClasses[i].last;
+    }
+    return next == kMachineCount;
+}
+static_assert(ClassesAreContiguous(), "ClusterConfig.hpp: machine classes must cover [0, kMachineCount) in order");
+
+constexpr const ClusterConfig::MachineClass & ClassOf(MachineId_t machine_id) {
+    unsigned lo = 0, hi = kClassCount - 1;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (machine_id < kClasses[mid].last) hi = mid;
+        else lo = mid + 1;
+    }
+    return kClasses[lo];
+}
+
+constexpr CPUType_t CPU(MachineId_t machine_id)        { return ClassOf(machine_id).cpu; }
+constexpr unsigned Cores(MachineId_t machine_id)       { return ClassOf(machine_id).cores; }
+constexpr bool GPUs(MachineId_t machine_id)            { return ClassOf(machine_id).gpus; }
+constexpr unsigned MIPS(MachineId_t machine_id, CPUPerformance_t p_state) {
+    return ClassOf(machine_id).mips[p_state];
+}
+constexpr double SpeedRatio(MachineId_t machine_id, CPUPerformance_t p_state) {
+    return ClassOf(machine_id).speed_ratio[p_state];
+}
+
+// Fails the run if the simulator was handed a different fleet than the one compiled in
+inline void Verify() {
+    if (Machine_GetTotal() != kMachineCount) {
+        ThrowException("StaticCluster::Verify(): scheduler was built for a different number of machines, expected ", kMachineCount);
+    }
+    for (unsigned i = 0; i < kClassCount; i++) {
+        for (MachineId_t id : {kClasses[i].first, kClasses[i].last - 1}) {
+            MachineInfo_t info = Machine_GetInfo(id);
+            if (info.cpu != kClasses[i].cpu || info.num_cpus != kClasses[i].cores ||
+                info.gpus != kClasses[i].gpus || info.performance[P0] != kClasses[i].mips[P0]) {
+                ThrowException("StaticCluster::Verify(): scheduler was built for a different fleet, mismatch at machine ", id);
+            }
+        }
+    }
+}
+
+} // namespace StaticCluster
+
+#endif /* StaticCluster_hpp */
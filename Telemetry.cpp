@@ -0,0 +1,200 @@
+//
+//  Telemetry.cpp
+//  CloudSim
+//
+
+#include "Telemetry.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "Varint.hpp"
+
+static const char magic[4] = {'C', 'S', 'T', 'M'};
+static const char version = 1;
+
+static const char * kColumnNames[NUM_TELEMETRY_COLUMNS] = {"s_state", "p_state", "tasks", "vms", "memory_used", "energy_uj"};
+
+void TelemetryRecorder::Open(const string & filename, size_t budget_bytes) {
+    this->filename = filename;
+    budget = budget_bytes;
+}
+
+bool TelemetryRecorder::Begin(Time_t time, bool force) {
+    if (!force) {
+        uint64_t check = checks++;
+        if (check % stride != 0) return false;
+        if (budget && Bytes() > budget) {
+            Downsample();
+            if (check % stride != 0) return false;
+        }
+    }
+    if (samples > 0 && time == last_time) return false;
+    PutSignedVarint(times, int64_t(time - last_time));
+    last_time = time;
+    next_machine = 0;
+    return true;
+}
+
+void TelemetryRecorder::Add(const MachineInfo_t & info) {
+    size_t m = next_machine++;
+    if (samples == 0) machines.push_back({info.cpu, info.num_cpus, info.memory_size, info.gpus});
+    Put(TM_S_STATE, m, info.s_state);
+    Put(TM_P_STATE, m, info.p_state);
+    Put(TM_TASKS, m, info.active_tasks);
+    Put(TM_VMS, m, info.active_vms);
+    Put(TM_MEMORY_USED, m, info.memory_used);
+    Put(TM_ENERGY, m, int64_t(info.energy_consumed));
+}
+
+void TelemetryRecorder::End() {
+    samples++;
+}
+
+void TelemetryRecorder::Put(unsigned column, size_t machine, int64_t value) {
+    vector<int64_t> & base = last[column];
+    if (base.size() <= machine) base.resize(machine + 1, 0);
+    PutSignedVarint(columns[column], value - base[machine]);
+    base[machine] = value;
+}
+
+size_t TelemetryRecorder::Bytes() const {
+    size_t bytes = times.size();
+    for (auto & column : columns) bytes += column.size();
+    return bytes;
+}
+
+// Keeps every other sample and doubles the stride
+void TelemetryRecorder::Downsample() {
+    TelemetryReader reader;
+    reader.machines = machines;
+    reader.samples = samples;
+    reader.times.swap(times);
+    for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) {
+        reader.columns[c].swap(columns[c]);
+        last[c].assign(machines.size(), 0);
+    }
+    last_time = 0;
+    uint64_t kept = 0;
+    TelemetrySample sample;
+    for (uint64_t i = 0; reader.Next(sample); i++) {
+        if (i % 2 != 0) continue;
+        PutSignedVarint(times, int64_t(sample.time - last_time));
+        last_time = sample.time;
+        for (size_t m = 0; m < machines.size(); m++) {
+            for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) Put(c, m, sample.values[m][c]);
+        }
+        kept++;
+    }
+    samples = kept;
+    stride *= 2;
+}
+
+void TelemetryRecorder::Close() {
+    if (!IsOpen()) return;
+    string name = filename;
+    filename.clear();
+    ofstream out(name, ios::binary);
+    if (!out) throw runtime_error("TelemetryRecorder: could not write " + name);
+
+    bool csv = name.size() >= 4 && name.compare(name.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        TelemetryReader reader;
+        reader.machines = machines;
+        reader.samples = samples;
+        reader.times.swap(times);
+        for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) reader.columns[c].swap(columns[c]);
+        out << "time_us,machine,cpu,cores,gpus,memory_size";
+        for (auto column : kColumnNames) out << "," << column;
+        out << ",power_w,utilization" << endl;
+        TelemetrySample sample;
+        Time_t previous_time = 0;
+        vector<int64_t> previous_energy(machines.size(), 0);
+        while (reader.Next(sample)) {
+            for (size_t m = 0; m < machines.size(); m++) {
+                const auto & v = sample.values[m];
+                const TelemetryMachine & tm = machines[m];
+                double dt = double(sample.time - previous_time);
+                double watts = dt > 0 ? (v[TM_ENERGY] - previous_energy[m]) / dt : 0;
+                double utilization = tm.cores ? min(1.0, double(v[TM_TASKS]) / tm.cores) : 0;
+                out << sample.time << "," << m << "," << tm.cpu << "," << tm.cores << "," << tm.gpus << "," << tm.memory_size;
+                for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) out << "," << v[c];
+                out << "," << watts << "," << utilization << "\n";
+                previous_energy[m] = v[TM_ENERGY];
+            }
+            previous_time = sample.time;
+        }
+        return;
+    }
+
+    string header;
+    PutVarint(header, machines.size());
+    for (auto & tm : machines) {
+        PutVarint(header, tm.cpu);
+        PutVarint(header, tm.cores);
+        PutVarint(header, tm.memory_size);
+        PutVarint(header, tm.gpus);
+    }
+    PutVarint(header, stride);
+    PutVarint(header, samples);
+    out.write(magic, sizeof(magic));
+    out.put(version);
+    out << header;
+    string length;
+    PutVarint(length, times.size());
+    out << length << times;
+    for (auto & column : columns) {
+        length.clear();
+        PutVarint(length, column.size());
+        out << length << column;
+    }
+}
+
+void TelemetryReader::Open(const string & filename) {
+    ifstream in(filename, ios::binary);
+    if (!in) throw runtime_error("TelemetryReader::Open(): could not open " + filename);
+    char header[sizeof(magic)];
+    if (!in.read(header, sizeof(header)) || memcmp(header, magic, sizeof(magic)) != 0 || in.get() != version) {
+        throw runtime_error("TelemetryReader::Open(): " + filename + " is not a telemetry file of this version");
+    }
+    auto value = [&]() {
+        uint64_t v;
+        if (!GetVarint(in, v)) throw runtime_error("TelemetryReader::Open(): " + filename + " is truncated");
+        return v;
+    };
+    uint64_t count = value();
+    if (count > (1 << 24)) throw runtime_error("TelemetryReader::Open(): corrupt machine count in " + filename);
+    machines.resize(count);
+    for (auto & tm : machines) {
+        tm.cpu = CPUType_t(value());
+        tm.cores = unsigned(value());
+        tm.memory_size = unsigned(value());
+        tm.gpus = value() != 0;
+    }
+    stride = unsigned(value());
+    samples = value();
+    auto block = [&](string & out) {
+        out.resize(value());
+        if (!in.read(&out[0], out.size())) throw runtime_error("TelemetryReader::Open(): " + filename + " is truncated");
+    };
+    block(times);
+    for (auto & column : columns) block(column);
+}
+
+bool TelemetryReader::Next(TelemetrySample & sample) {
+    if (read == samples) return false;
+    int64_t delta;
+    if (!GetSignedVarint(times, time_at, delta)) throw runtime_error("TelemetryReader: corrupt time column");
+    current.time += delta;
+    current.values.resize(machines.size(), {});
+    for (size_t m = 0; m < machines.size(); m++) {
+        for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) {
+            if (!GetSignedVarint(columns[c], at[c], delta)) throw runtime_error(string("TelemetryReader: corrupt ") + kColumnNames[c] + " column");
+            current.values[m][c] += delta;
+        }
+    }
+    read++;
+    sample = current;
+    return true;
+}
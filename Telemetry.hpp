@@ -0,0 +1,112 @@
+//
+//  Telemetry.hpp
+//  CloudSim
+//
+//  Per-machine time series sampled at every SchedulerCheck: S-state, P-state,
+//  tasks, VMs, memory in use and energy consumed so far (from which power and
+//  utilization follow). Recorded when CLOUDSIM_TELEMETRY names a file (see
+//  InterfaceHooks.h) and queried by Tools/bin/telemetry.
+//
+//  Each column is kept in memory as zigzag varints of the change since the
+//  machine's previous sample, so a machine that did nothing costs one byte per
+//  column per sample. Memory stays within CLOUDSIM_TELEMETRY_MB (default 32):
+//  when the columns outgrow it every other sample is dropped and from then on
+//  only every other SchedulerCheck is sampled, so an hour on a large cluster
+//  ends with a coarser, not a truncated, series.
+//
+//  A file name ending in .csv gets one row per machine per sample. Anything
+//  else gets the columns as they are in memory:
+//      "CSTM", version byte
+//      varint machines, then per machine: cpu, cores, memory size, gpus
+//      varint sampling stride (SchedulerChecks per sample), varint samples
+//      per column (time, then the TelemetryColumn_t order): varint length, bytes
+//  The time column holds one delta per sample, the others one per machine per
+//  sample, machines in id order.
+//
+
+#ifndef Telemetry_hpp
+#define Telemetry_hpp
+
+#include <array>
+#include <string>
+
+#include "SimTypes.h"
+
+typedef enum {
+    TM_S_STATE,
+    TM_P_STATE,
+    TM_TASKS,
+    TM_VMS,
+    TM_MEMORY_USED,
+    TM_ENERGY                           // Cumulative, in microjoules (W * us)
+} TelemetryColumn_t;
+#define NUM_TELEMETRY_COLUMNS 6
+
+struct TelemetryMachine {
+    CPUType_t cpu;
+    unsigned cores;
+    unsigned memory_size;
+    bool gpus;
+};
+
+class TelemetryRecorder {
+public:
+    void Open(const string & filename, size_t budget_bytes);
+    bool IsOpen() const { return !filename.empty(); }
+
+    // A sample is Begin(), one Add() per machine in id order, End(). Begin()
+    // returns false for the SchedulerChecks the stride skips, unless forced.
+    bool Begin(Time_t time, bool force = false);
+    void Add(const MachineInfo_t & info);
+    void End();
+
+    // Writes the file; throws runtime_error if it cannot
+    void Close();
+
+private:
+    void Put(unsigned column, size_t machine, int64_t value);
+    size_t Bytes() const;
+    void Downsample();
+
+    string filename;
+    size_t budget = 0;
+    vector<TelemetryMachine> machines;
+    unsigned stride = 1;
+    uint64_t checks = 0;
+    uint64_t samples = 0;
+    Time_t last_time = 0;
+    size_t next_machine = 0;
+    string times;
+    string columns[NUM_TELEMETRY_COLUMNS];
+    vector<int64_t> last[NUM_TELEMETRY_COLUMNS];
+};
+
+// One decoded sample: the time and, per machine, each column's value
+struct TelemetrySample {
+    Time_t time = 0;
+    vector<array<int64_t, NUM_TELEMETRY_COLUMNS>> values;
+};
+
+class TelemetryReader {
+public:
+    // Throws runtime_error if the file is missing, not a telemetry file, or corrupt
+    void Open(const string & filename);
+    bool Next(TelemetrySample & sample);
+
+    const vector<TelemetryMachine> & Machines() const { return machines; }
+    uint64_t Samples() const { return samples; }
+    unsigned Stride() const { return stride; }
+
+private:
+    friend class TelemetryRecorder;     // Which decodes its own columns to downsample them
+
+    vector<TelemetryMachine> machines;
+    unsigned stride = 1;
+    uint64_t samples = 0, read = 0;
+    string times;
+    string columns[NUM_TELEMETRY_COLUMNS];
+    size_t time_at = 0, at[NUM_TELEMETRY_COLUMNS] = {};
+    TelemetrySample current;
+};
+
+#endif /* Telemetry_hpp */
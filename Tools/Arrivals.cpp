@@ -0,0 +1,261 @@
+//
+//  Arrivals.cpp
+//  CloudSim
+//
+
+#include "Arrivals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "Random.hpp"
+
+// Derived seeds tried for a class before giving up on an encoding
+static const unsigned kSeedAttempts = 1000;
+
+static const char * extended_keys[] = {
+    "Arrival process", "On period", "Off period", "Off rate", "Diurnal period", "Diurnal amplitude",
+    "Runtime distribution", "Pareto shape", "Lognormal sigma", "Runtime cap"
+};
+
+static string Get(const TaskClass & tc, const string & key, const string & fallback) {
+    auto it = tc.extra.find(key);
+    return it == tc.extra.end() ? fallback : it->second;
+}
+
+static double GetNumber(const TaskClass & tc, const string & key, double fallback) {
+    auto it = tc.extra.find(key);
+    if (it == tc.extra.end()) return fallback;
+    try {
+        return stod(it->second);
+    } catch (const exception &) {
+        throw runtime_error("task class with seed " + to_string(tc.seed) + ": '" + key + "' is not a number");
+    }
+}
+
+static double Exponential(Rng & rng, double mean) {
+    return -log(1.0 - rng.Uniform()) * mean;
+}
+
+static double Normal(Rng & rng) {
+    double u1 = 1.0 - rng.Uniform();
+    double u2 = rng.Uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+vector<Time_t> PlainArrivals(const TaskClass & tc) {
+    // The simulator's own draws, so the standard distributions rather than Rng
+    mt19937 gen(tc.seed);
+    exponential_distribution<double> gap(1.0 / double(max<Time_t>(1, tc.inter_arrival)));
+    uniform_real_distribution<double> instructions(0, 1);
+    vector<Time_t> arrivals;
+    for (Time_t t = tc.start; t < tc.end;) {
+        t += Time_t(gap(gen));
+        instructions(gen);
+        arrivals.push_back(t);
+    }
+    return arrivals;
+}
+
+bool IsExtendedTaskClass(const TaskClass & tc) {
+    for (auto key : extended_keys) {
+        if (tc.extra.count(key)) return true;
+    }
+    return false;
+}
+
+void ValidateTaskClass(const TaskClass & tc) {
+    string where = "task class with seed " + to_string(tc.seed);
+    for (auto & kv : tc.extra) {
+        if (find(begin(extended_keys), end(extended_keys), kv.first) == end(extended_keys)) {
+            throw runtime_error(where + ": unknown key '" + kv.first + "'");
+        }
+    }
+    string process = Get(tc, "Arrival process", "constant");
+    if (process != "constant" && process != "poisson" && process != "mmpp" && process != "diurnal") {
+        throw runtime_error(where + ": unknown arrival process '" + process + "'");
+    }
+    string runtime = Get(tc, "Runtime distribution", "constant");
+    if (runtime != "constant" && runtime != "pareto" && runtime != "lognormal") {
+        throw runtime_error(where + ": unknown runtime distribution '" + runtime + "'");
+    }
+    if (tc.inter_arrival == 0) {
+        throw runtime_error(where + ": inter arrival must be positive");
+    }
+    if (GetNumber(tc, "Pareto shape", 1.5) <= 1.0) {
+        throw runtime_error(where + ": Pareto shape must be above 1 for the mean to exist");
+    }
+    double amplitude = GetNumber(tc, "Diurnal amplitude", 0.5);
+    if (amplitude < 0 || amplitude > 1) {
+        throw runtime_error(where + ": Diurnal amplitude must be within [0, 1]");
+    }
+    if (process == "mmpp" && (GetNumber(tc, "On period", 0) <= 0 || GetNumber(tc, "Off period", 0) <= 0)) {
+        throw runtime_error(where + ": mmpp needs positive 'On period' and 'Off period'");
+    }
+}
+
+vector<Time_t> SampleArrivals(const TaskClass & tc) {
+    Rng rng(DeriveSeed(tc.seed, 1));
+    string process = Get(tc, "Arrival process", "constant");
+    double mean = double(tc.inter_arrival);
+    double t = double(tc.start);
+    double end = double(tc.end);
+    vector<Time_t> arrivals;
+
+    if (process == "constant") {
+        for (; t < end; t += mean) arrivals.push_back(Time_t(t));
+    } else if (process == "poisson") {
+        for (t += Exponential(rng, mean); t < end; t += Exponential(rng, mean)) {
+            arrivals.push_back(Time_t(t));
+        }
+    } else if (process == "mmpp") {
+        double on_mean = GetNumber(tc, "On period", 0);
+        double off_mean = GetNumber(tc, "Off period", 0);
+        double off_rate = GetNumber(tc, "Off rate", 0);
+        bool on = true;
+        double phase_end = t + Exponential(rng, on_mean);
+        while (t < end) {
+            double rate = on ? 1.0 / mean : off_rate / mean;
+            double next = rate > 0 ? t + Exponential(rng, 1.0 / rate) : phase_end;
+            if (next >= phase_end) {
+                // Gaps are memoryless, so the draw that crosses the phase boundary can be dropped
+                t = phase_end;
+                on = !on;
+                phase_end = t + Exponential(rng, on ? on_mean : off_mean);
+                continue;
+            }
+            t = next;
+            if (t < end) arrivals.push_back(Time_t(t));
+        }
+    } else if (process == "diurnal") {
+        // Thinning against the peak rate
+        double period = GetNumber(tc, "Diurnal period", 86400000000.0);
+        double amplitude = GetNumber(tc, "Diurnal amplitude", 0.5);
+        double peak_mean = mean / (1.0 + amplitude);
+        for (t += Exponential(rng, peak_mean); t < end; t += Exponential(rng, peak_mean)) {
+            double rate = 1.0 + amplitude * sin(2.0 * M_PI * (t - double(tc.start)) / period);
+            if (rng.Uniform() * (1.0 + amplitude) < rate) arrivals.push_back(Time_t(t));
+        }
+    }
+    return arrivals;
+}
+
+// A plain class the simulator turns into exactly one task at time arrival: with
+// 'Inter arrival' 1 it draws one gap g from the class start, so the class
+// starts g before the arrival and ends one microsecond after its start. The
+// seed is the first derived one whose gap is at least 1 (0 would let a second
+// task follow) and fits before the arrival. Nothing can arrive at 0, so an
+// arrival there moves to 1.
+static TaskClass SingleTask(const TaskClass & tc, Time_t arrival, uint64_t seed) {
+    TaskClass single = tc;
+    single.extra.clear();
+    single.inter_arrival = 1;
+    arrival = max<Time_t>(1, arrival);
+    for (unsigned attempt = 0; attempt < kSeedAttempts; attempt++) {
+        single.seed = DeriveSeed(seed, attempt) % 1000000000;
+        single.start = 0;
+        single.end = 1;
+        Time_t gap = PlainArrivals(single).front();
+        if (gap < 1 || gap > arrival) continue;
+        single.start = arrival - gap;
+        single.end = single.start + 1;
+        return single;
+    }
+    throw logic_error("no seed places a single task at " + to_string(arrival));
+}
+
+// Poisson arrivals with one runtime are what the simulator does with a plain
+// class, so a poisson class is one plain class and an mmpp class one per phase
+// with arrivals. The arrivals are the simulator's own draws from the phase
+// start; the class ends at the last one before the phase end, so the one past
+// it is never added. When that cannot be expressed (the last two share a
+// microsecond, or the only one is at the start) the phase falls back to one
+// class per arrival.
+static vector<TaskClass> PoissonClasses(const TaskClass & tc, Time_t runtime) {
+    Rng rng(DeriveSeed(tc.seed, 1));
+    bool mmpp = Get(tc, "Arrival process", "constant") == "mmpp";
+    double on_mean = GetNumber(tc, "On period", 0);
+    double off_mean = GetNumber(tc, "Off period", 0);
+    double off_rate = GetNumber(tc, "Off rate", 0);
+    double end = double(tc.end);
+    vector<TaskClass> classes;
+    bool on = true;
+    for (double t = double(tc.start); t < end;) {
+        double phase_end = mmpp ? min(end, t + Exponential(rng, on ? on_mean : off_mean)) : end;
+        double rate = on ? 1.0 : off_rate;
+        if (rate > 0 && Time_t(t) < Time_t(phase_end)) {
+            TaskClass phase = tc;
+            phase.extra.clear();
+            phase.start = Time_t(t);
+            phase.end = Time_t(phase_end);
+            phase.inter_arrival = max<Time_t>(1, Time_t(double(tc.inter_arrival) / rate));
+            phase.expected_runtime = runtime;
+            phase.seed = DeriveSeed(tc.seed, 3 + classes.size()) % 1000000000;
+            vector<Time_t> arrivals = PlainArrivals(phase);
+            arrivals.pop_back();
+            if (!arrivals.empty()) {
+                phase.end = arrivals.back();
+                if (PlainArrivals(phase) == arrivals) {
+                    classes.push_back(phase);
+                } else {
+                    for (size_t i = 0; i < arrivals.size(); i++) {
+                        classes.push_back(SingleTask(phase, arrivals[i], DeriveSeed(phase.seed, 3 + i)));
+                    }
+                }
+            }
+        }
+        t = phase_end;
+        on = !on;
+    }
+    return classes;
+}
+
+vector<TaskClass> ExpandTaskClass(const TaskClass & tc) {
+    ValidateTaskClass(tc);
+    Rng rng(DeriveSeed(tc.seed, 2));
+    string runtime = Get(tc, "Runtime distribution", "constant");
+    double mean = double(tc.expected_runtime);
+    double cap = GetNumber(tc, "Runtime cap", 0);
+    double shape = GetNumber(tc, "Pareto shape", 1.5);
+    double sigma = GetNumber(tc, "Lognormal sigma", 1.0);
+
+    string process = Get(tc, "Arrival process", "constant");
+    if (runtime == "constant" && (process == "poisson" || process == "mmpp")) {
+        return PoissonClasses(tc, max<Time_t>(1, Time_t(cap > 0 ? min(mean, cap) : mean)));
+    }
+
+    vector<Time_t> arrivals = SampleArrivals(tc);
+    vector<TaskClass> expanded;
+    expanded.reserve(arrivals.size());
+    for (size_t i = 0; i < arrivals.size(); i++) {
+        double sample = mean;
+        if (runtime == "pareto") {
+            double scale = mean * (shape - 1.0) / shape;
+            sample = scale / pow(1.0 - rng.Uniform(), 1.0 / shape);
+        } else if (runtime == "lognormal") {
+            sample = exp(log(mean) - sigma * sigma / 2.0 + sigma * Normal(rng));
+        }
+        if (cap > 0) sample = min(sample, cap);
+
+        TaskClass single = tc;
+        single.expected_runtime = max<Time_t>(1, Time_t(sample));
+        expanded.push_back(SingleTask(single, arrivals[i], DeriveSeed(tc.seed, 3 + i)));
+    }
+    return expanded;
+}
+
+void ExpandWorkload(Workload & workload) {
+    vector<TaskClass> tasks;
+    for (auto & tc : workload.tasks) {
+        if (!IsExtendedTaskClass(tc)) {
+            ValidateTaskClass(tc);
+            tasks.push_back(tc);
+            continue;
+        }
+        vector<TaskClass> expanded = ExpandTaskClass(tc);
+        tasks.insert(tasks.end(), expanded.begin(), expanded.end());
+    }
+    workload.tasks.swap(tasks);
+}
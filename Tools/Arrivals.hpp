@@ -0,0 +1,60 @@
+//
+//  Arrivals.hpp
+//  CloudSim
+//
+//  Arrival processes and runtime distributions for task classes. The simulator
+//  itself only understands a plain class: exponential gaps with mean 'Inter
+//  arrival' from its start, and a single expected runtime (PlainArrivals).
+//  Classes using the keys below are expanded into plain classes before they
+//  are handed to it (see workloadexpand). With a constant runtime a poisson
+//  class stays one class and an mmpp class becomes one per phase; otherwise
+//  each arrival becomes its own class, placed so that the simulator's one task
+//  arrives exactly when it was sampled.
+//
+//      Arrival process: constant | poisson | mmpp | diurnal
+//          poisson  exponential gaps with mean 'Inter arrival'
+//          mmpp     on/off bursts: 'On period' and 'Off period' are the mean
+//                   (exponential) phase lengths in microseconds; arrivals run at
+//                   the 'Inter arrival' rate while on and at 'Off rate' times
+//                   that rate while off (default 0)
+//          diurnal  sinusoidal rate around the 'Inter arrival' mean with
+//                   'Diurnal period' (us, default 86400000000) and
+//                   'Diurnal amplitude' (0..1, default 0.5)
+//      Runtime distribution: constant | pareto | lognormal
+//          pareto     shape 'Pareto shape' (> 1, default 1.5), mean 'Expected runtime'
+//          lognormal  'Lognormal sigma' (default 1.0), mean 'Expected runtime'
+//      Runtime cap: upper bound on a sampled runtime (us, optional)
+//
+//  All sampling is driven by the class's Seed.
+//
+
+#ifndef Arrivals_hpp
+#define Arrivals_hpp
+
+#include "Workload.hpp"
+
+// The arrivals the simulator draws for a plain class: a std::mt19937 seeded
+// with the Seed gives each task an exponential gap, truncated to microseconds,
+// then a uniform for its instruction count. Tasks are added from Start time
+// while the previous one was before End time, so the last one is the first at
+// or past it.
+vector<Time_t> PlainArrivals(const TaskClass & tc);
+
+// True if the class uses any of the keys above and must be expanded
+bool IsExtendedTaskClass(const TaskClass & tc);
+
+// Checks the extended keys of a class, throws runtime_error on unknown keys or bad values
+void ValidateTaskClass(const TaskClass & tc);
+
+// Arrival times of the class, in order
+vector<Time_t> SampleArrivals(const TaskClass & tc);
+
+// Plain task classes: one per arrival with its own sampled runtime and derived seed, or
+// for poisson and mmpp arrivals with a constant runtime one per phase with arrivals.
+// An arrival sampled at 0 arrives at 1.
+vector<TaskClass> ExpandTaskClass(const TaskClass & tc);
+
+// Expands every extended class of the workload in place
+void ExpandWorkload(Workload & workload);
+
+#endif /* Arrivals_hpp */
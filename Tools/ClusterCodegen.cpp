@@ -0,0 +1,113 @@
+//
+//  ClusterCodegen.cpp
+//  CloudSim
+//
+//  Reads the machine classes of a workload and writes a header of constexpr
+//  tables describing that fleet. Scheduler.cpp compiled with -DSTATIC_CLUSTER
+//  uses the tables instead of asking the simulator for per-machine constants
+//  (see StaticCluster.hpp and 'make simulator-static').
+//
+//  Usage: clustercodegen workload.md [-o ClusterConfig.hpp]
+//
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "Workload.hpp"
+
+static string Array(const vector<unsigned> & values) {
+    string s = "{";
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i) s += ", ";
+        s += to_string(values[i]);
+    }
+    return s + "}";
+}
+
+static string Array(const vector<double> & values) {
+    ostringstream s;
+    s.precision(17);
+    s << "{";
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i) s << ", ";
+        s << values[i];
+    }
+    s << "}";
+    return s.str();
+}
+
+static void Generate(ostream & out, const Workload & w, const string & source) {
+    out << "//\n"
+        << "//  ClusterConfig.hpp\n"
+        << "//  CloudSim\n"
+        << "//\n"
+        << "//  Generated by clustercodegen from " << source << " -- do not edit.\n"
+        << "//\n\n"
+        << "#ifndef ClusterConfig_hpp\n"
+        << "#define ClusterConfig_hpp\n\n"
+        << "#include \"SimTypes.h\"\n\n"
+        << "namespace ClusterConfig {\n\n"
+        << "struct MachineClass {\n"
+        << "    MachineId_t first;                      // Machines [first, last) belong to this class\n"
+        << "    MachineId_t last;\n"
+        << "    CPUType_t cpu;\n"
+        << "    unsigned cores;\n"
+        << "    unsigned memory;\n"
+        << "    bool gpus;\n"
+        << "    unsigned mips[P_STATES];\n"
+        << "    double speed_ratio[P_STATES];           // mips[P0] / mips[p]\n"
+        << "};\n\n";
+
+    out << "constexpr unsigned kMachineCount = " << w.TotalMachines() << ";\n"
+        << "constexpr unsigned kClassCount = " << w.machines.size() << ";\n\n"
+        << "constexpr MachineClass kClasses[kClassCount] = {\n";
+
+    // The simulator numbers machines in the order their classes appear in the file
+    unsigned first = 0;
+    for (auto & mc : w.machines) {
+        vector<double> ratio;
+        for (unsigned p = 0; p < P_STATES; p++) ratio.push_back(double(mc.mips[0]) / double(mc.mips[p]));
+        out << "    {" << first << ", " << first + mc.count << ", " << CPUName(mc.cpu) << ", " << mc.cores << ", "
+            << mc.memory << ", " << (mc.gpus ? "true" : "false") << ", " << Array(mc.mips) << ", "
+            << Array(ratio) << "},\n";
+        first += mc.count;
+    }
+    out << "};\n\n"
+        << "} // namespace ClusterConfig\n\n"
+        << "#endif /* ClusterConfig_hpp */\n";
+}
+
+int main(int argc, char * argv[]) {
+    string input, output;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (input.empty() && arg[0] != '-') input = arg;
+        else {
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty()) {
+        cerr << "Usage: clustercodegen workload.md [-o ClusterConfig.hpp]" << endl;
+        return 1;
+    }
+
+    try {
+        Workload w = ReadWorkload(input);
+        if (w.machines.empty()) throw runtime_error(input + " has no machine classes");
+        if (output.empty()) {
+            Generate(cout, w, input);
+        } else {
+            ofstream out(output);
+            if (!out) throw runtime_error("could not write " + output);
+            Generate(out, w, input);
+        }
+    } catch (const exception & e) {
+        cerr << "clustercodegen: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+//
+//  ClusterMirror.cpp
+//  CloudSim
+//
+
+#include "ClusterMirror.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+ClusterMirror::ClusterMirror(const string & workload) : workload(workload) {
+    if (workload.empty()) return;
+    for (auto & mc : ReadWorkload(workload).machines) {
+        for (unsigned i = 0; i < mc.count; i++) {
+            machines.push_back({});
+            machines.back().cores = mc.cores;
+            machines.back().mips = mc.mips;
+            machines.back().s_power = mc.s_states;
+            machines.back().p_power = mc.p_states;
+        }
+    }
+}
+
+void ClusterMirror::Replay(const string & filename) {
+    TraceReader trace;
+    trace.Open(filename);
+    vector<Time_t> times;
+    TraceEvent e;
+    while (trace.Next(e)) {
+        switch (e.kind) {
+            case TraceEvent::BEGIN:
+                times.push_back(e.time);
+                SetTime(e.time);
+                Before(e);
+                Callback(e);
+                After(e);
+                break;
+            case TraceEvent::END:
+                if (!times.empty()) times.pop_back();
+                if (!times.empty()) SetTime(times.back());
+                break;
+            case TraceEvent::CALL:
+                Before(e);
+                Call(e);
+                After(e);
+                break;
+        }
+    }
+}
+
+void ClusterMirror::StopAll() {
+    while (!running.empty()) Leave(running.begin()->first, "end of run");
+}
+
+MachinePower ClusterMirror::Power(MachineId_t machine_id) {
+    const MirrorMachine & m = GetMachine(machine_id);
+    MachinePower power;
+    if (m.s_state < m.s_power.size()) power.idle = m.s_power[m.s_state];
+    if (m.s_state == S0 && m.p_state < m.p_power.size()) {
+        power.dynamic = double(min(unsigned(m.tasks.size()), m.cores)) * m.p_power[m.p_state];
+    }
+    return power;
+}
+
+MirrorMachine & ClusterMirror::GetMachine(MachineId_t id) {
+    if (id >= machines.size()) {
+        if (HasWorkload()) throw runtime_error("machine " + to_string(id) + " is not in " + workload);
+        machines.resize(id + 1);
+    }
+    return machines[id];
+}
+
+MirrorVM & ClusterMirror::GetVM(VMId_t id) {
+    if (id >= vms.size()) vms.resize(id + 1);
+    return vms[id];
+}
+
+bool ClusterMirror::TaskMachine(TaskId_t task_id, MachineId_t & machine_id) {
+    auto vm = task_vm.find(task_id);
+    if (vm == task_vm.end() || !vms[vm->second].attached) return false;
+    machine_id = vms[vm->second].machine;
+    return true;
+}
+
+void ClusterMirror::SetTime(Time_t t) {
+    if (t <= now) return;
+    TimeChanging(t);
+    now = t;
+}
+
+void ClusterMirror::Callback(const TraceEvent & e) {
+    switch (e.callback) {
+        case CB_TASK_COMPLETION: {
+            auto vm = task_vm.find(e.subject);
+            if (vm != task_vm.end()) {
+                vms[vm->second].tasks.erase(e.subject);
+                task_vm.erase(vm);
+            }
+            Leave(e.subject, "completed");
+            break;
+        }
+        case CB_MIGRATION_DONE: {
+            MirrorVM & vm = GetVM(e.subject);
+            if (!vm.migrating) break;
+            vm.migrating = false;
+            vm.machine = vm.target;
+            if (vm.attached) {
+                for (TaskId_t task : vm.tasks) Join(task, vm.machine);
+            }
+            break;
+        }
+        case CB_STATE_CHANGE_COMPLETE: {
+            MirrorMachine & m = GetMachine(e.subject);
+            if (!m.transition) break;
+            Changing(e.subject);
+            m.transition = false;
+            m.s_state = m.pending;
+            Changed(e.subject);
+            break;
+        }
+        default: break;
+    }
+}
+
+void ClusterMirror::Call(const TraceEvent & e) {
+    switch (e.call) {
+        case CALL_MACHINE_GET_INFO: {
+            const MachineInfo_t & info = e.machine;
+            MirrorMachine & m = GetMachine(info.machine_id);
+            if (info.num_cpus) m.cores = info.num_cpus;
+            if (!info.performance.empty()) m.mips = info.performance;
+            if (!info.s_states.empty()) m.s_power = info.s_states;
+            if (!info.p_states.empty()) m.p_power = info.p_states;
+            // During a transition the answer still has the old state
+            if (!m.transition && info.s_state != m.s_state) {
+                Changing(info.machine_id);
+                m.s_state = info.s_state;
+                Changed(info.machine_id);
+            }
+            if (info.p_state != m.p_state) {
+                Changing(info.machine_id);
+                m.p_state = info.p_state;
+                Changed(info.machine_id);
+            }
+            break;
+        }
+        case CALL_VM_CREATE:
+            GetVM(VMId_t(e.value)).type = VMType_t(e.args[0]);
+            break;
+        case CALL_VM_ATTACH: {
+            MirrorVM & vm = GetVM(e.args[0]);
+            vm.attached = true;
+            vm.machine = e.args[1];
+            if (!vm.migrating) {
+                for (TaskId_t task : vm.tasks) Join(task, vm.machine);
+            }
+            break;
+        }
+        case CALL_VM_ADD_TASK: {
+            MirrorVM & vm = GetVM(e.args[0]);
+            vm.tasks.insert(e.args[1]);
+            task_vm[e.args[1]] = e.args[0];
+            if (vm.attached && !vm.migrating) Join(e.args[1], vm.machine);
+            break;
+        }
+        case CALL_VM_REMOVE_TASK:
+            GetVM(e.args[0]).tasks.erase(e.args[1]);
+            task_vm.erase(e.args[1]);
+            Leave(e.args[1], "removed");
+            break;
+        case CALL_VM_MIGRATE: {
+            MirrorVM & vm = GetVM(e.args[0]);
+            vm.migrating = true;
+            vm.target = e.args[1];
+            for (TaskId_t task : vm.tasks) Leave(task, "migrated");
+            break;
+        }
+        case CALL_VM_SHUTDOWN:
+            GetVM(e.args[0]).attached = false;
+            break;
+        case CALL_MACHINE_SET_STATE: {
+            MachineId_t machine_id = e.args[0];
+            MirrorMachine & m = GetMachine(machine_id);
+            MachineState_t s_state = MachineState_t(e.args[1]);
+            if (m.s_state == s_state && !m.transition) break;
+            Changing(machine_id);
+            m.transition = true;
+            m.pending = s_state;
+            Changed(machine_id);
+            break;
+        }
+        case CALL_MACHINE_SET_CORE_PERFORMANCE: {
+            MachineId_t machine_id = e.args[0];
+            MirrorMachine & m = GetMachine(machine_id);
+            if (m.p_state == e.args[2]) break;
+            Changing(machine_id);
+            m.p_state = e.args[2];
+            Changed(machine_id);
+            break;
+        }
+        default: break;
+    }
+}
+
+void ClusterMirror::Join(TaskId_t task_id, MachineId_t machine_id) {
+    if (running.count(task_id)) return;
+    Changing(machine_id);
+    GetMachine(machine_id).tasks.insert(task_id);
+    running[task_id] = machine_id;
+    Joined(task_id, machine_id);
+    Changed(machine_id);
+}
+
+void ClusterMirror::Leave(TaskId_t task_id, const string & how) {
+    auto run = running.find(task_id);
+    if (run == running.end()) return;
+    MachineId_t machine_id = run->second;
+    Changing(machine_id);
+    GetMachine(machine_id).tasks.erase(task_id);
+    running.erase(run);
+    Left(task_id, machine_id, how);
+    Changed(machine_id);
+}
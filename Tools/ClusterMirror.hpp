@@ -0,0 +1,109 @@
+//
+//  ClusterMirror.hpp
+//  CloudSim
+//
+//  The cluster as the tools that read a callback trace (CLOUDSIM_CAPTURE) see
+//  it. VM_Attach, VM_AddTask, VM_RemoveTask, VM_Migrate, Machine_SetState
+//  and Machine_SetCorePerformance commands and the callbacks that complete
+//  them move the mirror forward, and every Machine_GetInfo answer corrects
+//  its S-state and P-state. Commands happen at the simulated time of the
+//  innermost open callback.
+//
+//  A task runs on a machine while it is in a VM that is attached and not
+//  migrating; it stops when it completes, is removed or its VM starts to
+//  migrate, and runs again on the target once the migration is done. While a
+//  machine changes S-state it keeps the state it is leaving.
+//
+//  The tools derive from ClusterMirror and override the hooks they need:
+//  Changing and Changed bracket every change to a machine (its tasks, S-state
+//  or P-state), Joined and Left follow a task starting and stopping on one,
+//  and Before and After see every trace event around the mirror's own update.
+//
+
+#ifndef ClusterMirror_hpp
+#define ClusterMirror_hpp
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CallbackTrace.hpp"
+#include "Workload.hpp"
+
+struct MirrorMachine {
+    MachineState_t s_state = S0;            // The simulator starts every machine in S0
+    bool transition = false;
+    MachineState_t pending = S0;            // The state a transition goes to
+    unsigned p_state = 0;
+    unsigned cores = 0;
+    vector<unsigned> mips;                  // Per P-state
+    vector<unsigned> s_power, p_power;      // From the workload, or the answers when they carry them
+    set<TaskId_t> tasks;                    // Running on it
+};
+
+struct MirrorVM {
+    VMType_t type = LINUX;
+    bool attached = false;
+    bool migrating = false;
+    MachineId_t machine = 0;
+    MachineId_t target = 0;                 // While migrating
+    set<TaskId_t> tasks;
+};
+
+// Modelled power of a machine, in W
+struct MachinePower {
+    double idle = 0;                        // S-state power
+    double dynamic = 0;                     // Core power of the tasks it runs
+};
+
+class ClusterMirror {
+public:
+    // With a workload, machines start with its power ladders and core counts and
+    // are numbered in the order of its machine classes; ids past them throw
+    explicit ClusterMirror(const string & workload = "");
+    virtual ~ClusterMirror() {}
+
+    // Reads the whole trace through the mirror; throws runtime_error if it cannot be read
+    void Replay(const string & trace);
+
+    // Stops every running task, as if the run ended now
+    void StopAll();
+
+    // In S0 a machine draws its S0 power plus the P-state power of one core per
+    // running task, up to its core count; otherwise its S-state power
+    MachinePower Power(MachineId_t machine_id);
+
+protected:
+    virtual void Before(const TraceEvent &) {}
+    virtual void After(const TraceEvent &) {}
+    virtual void Changing(MachineId_t) {}
+    virtual void Changed(MachineId_t) {}
+    virtual void Joined(TaskId_t, MachineId_t) {}
+    virtual void Left(TaskId_t, MachineId_t, const string & how) {}
+    virtual void TimeChanging(Time_t) {}   // Before now moves forward
+
+    MirrorMachine & GetMachine(MachineId_t id);
+    MirrorVM & GetVM(VMId_t id);
+    // Machine running a task, if it is placed on a VM that is attached
+    bool TaskMachine(TaskId_t task_id, MachineId_t & machine_id);
+    bool HasWorkload() const { return !workload.empty(); }
+    size_t MachineCount() const { return machines.size(); }
+
+    Time_t now = 0;
+
+private:
+    void SetTime(Time_t t);
+    void Callback(const TraceEvent & e);
+    void Call(const TraceEvent & e);
+    void Join(TaskId_t task_id, MachineId_t machine_id);
+    void Leave(TaskId_t task_id, const string & how);
+
+    string workload;
+    vector<MirrorMachine> machines;
+    vector<MirrorVM> vms;
+    map<TaskId_t, VMId_t> task_vm;
+    map<TaskId_t, MachineId_t> running;
+};
+
+#endif /* ClusterMirror_hpp */
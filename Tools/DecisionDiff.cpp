@@ -0,0 +1,81 @@
+//
+//  DecisionDiff.cpp
+//  CloudSim
+//
+//  Compares two decision logs (CLOUDSIM_RECORD) and reports the first command
+//  where they diverge, with the commands leading up to it and per-command totals.
+//  Exits 0 if the logs are identical, 1 if they differ.
+//
+//  Usage: decisiondiff a.dlog b.dlog [-c context]
+//
+
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "DecisionLog.hpp"
+
+int main(int argc, char * argv[]) {
+    string files[2];
+    unsigned context = 5;
+    unsigned n = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-c" && i + 1 < argc) context = unsigned(stoul(argv[++i]));
+        else if (n < 2 && arg[0] != '-') files[n++] = arg;
+        else n = 3;
+    }
+    if (n != 2) {
+        cerr << "Usage: decisiondiff a.dlog b.dlog [-c context]" << endl;
+        return 2;
+    }
+
+    try {
+        DecisionReader a, b;
+        a.Open(files[0]);
+        b.Open(files[1]);
+
+        vector<uint64_t> totals[2] = {vector<uint64_t>(NUM_COMMANDS, 0), vector<uint64_t>(NUM_COMMANDS, 0)};
+        deque<Decision> recent;
+        uint64_t index = 0;
+        bool diverged = false;
+        Decision da, db;
+        bool more_a = a.Next(da), more_b = b.Next(db);
+
+        while (more_a || more_b) {
+            if (!diverged && (!more_a || !more_b || da != db)) {
+                diverged = true;
+                cout << "First divergence at decision " << index << endl;
+                for (auto & d : recent) cout << "    " << FormatDecision(d) << endl;
+                cout << "  " << files[0] << ": " << (more_a ? FormatDecision(da) : string("<end of log>")) << endl;
+                cout << "  " << files[1] << ": " << (more_b ? FormatDecision(db) : string("<end of log>")) << endl;
+            }
+            if (!diverged) {
+                recent.push_back(da);
+                if (recent.size() > context) recent.pop_front();
+            }
+            if (more_a) {
+                totals[0][da.command]++;
+                more_a = a.Next(da);
+            }
+            if (more_b) {
+                totals[1][db.command]++;
+                more_b = b.Next(db);
+            }
+            index++;
+        }
+
+        if (!diverged) cout << "Logs are identical (" << index << " decisions)" << endl;
+        cout << endl << left << setw(28) << "Command" << right << setw(12) << "A" << setw(12) << "B" << endl;
+        for (unsigned c = 0; c < NUM_COMMANDS; c++) {
+            if (totals[0][c] == 0 && totals[1][c] == 0) continue;
+            cout << left << setw(28) << CommandName(Command_t(c)) << right
+                 << setw(12) << totals[0][c] << setw(12) << totals[1][c] << endl;
+        }
+        return diverged ? 1 : 0;
+    } catch (const exception & e) {
+        cerr << "decisiondiff: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,368 @@
+//
+//  EnergyBound.cpp
+//  CloudSim
+//
+//  Offline lower bound on the energy any policy needs for a workload, to tell
+//  how far a policy is from optimal. The machine classes (power ladders, MIPS,
+//  cores, GPUs) come from the workload file; the tasks (instruction counts,
+//  arrivals, deadlines, CPU type, GPU capability) from a callback trace of any
+//  run of that workload (CLOUDSIM_CAPTURE), since the instruction counts are
+//  drawn by the simulator and only reach the scheduler through GetTaskInfo().
+//  The tasks are the same whatever the policy, so any policy's trace will do.
+//
+//  Power model (the simulator's, as far as the scheduler can observe it): a
+//  machine in S0 draws its S0 power plus, for every core running a task, the
+//  P-state power of that core; a core runs MIPS[p] million instructions per
+//  second, times the GPU speedup for GPU-capable tasks on GPU machines. Idle
+//  cores and non-S0 states draw at least nothing, and every machine draws at
+//  least its lowest S-state power for the whole run.
+//
+//  The bound is the LP relaxation of assigning instructions to (machine class,
+//  P-state) core time, with S0 power shared evenly by a machine's cores (as if
+//  every awake machine were fully packed) and without core capacity limits.
+//  Without capacity the LP separates per task: a task's instructions may be
+//  split over any of the options that can run it, and to meet its deadline
+//  when started on arrival the time they take must fit its window. With two
+//  constraints (all instructions, the window) the optimum mixes at most two
+//  options, so each task costs the lower convex hull of the options' (seconds,
+//  joules) per instruction at its window: its cheapest option if that is fast
+//  enough, otherwise the cheapest mix of a faster and a slower one. Relaxing
+//  constraints only lowers the optimum, so this is a lower bound for every
+//  policy that meets the deadlines of the SLA0-SLA2 tasks (SLA3 is best effort
+//  and has none); tasks no option can finish in time are costed at their
+//  cheapest option.
+//
+//  Packing every awake machine is rarely possible, so a second bound charges
+//  S0 power by awake machine-time instead: a machine of a task's CPU type is
+//  awake whenever one of its tasks runs. A task running at its fastest option
+//  needs its run time within its window, so the least time some machine of
+//  the type must be awake is the smallest set of instants that holds that
+//  much of every window (filled latest-deadline-last from the right, which is
+//  optimal). Windows shorter than twice the run time force the task to run in
+//  their middle, and where more of those overlap than a machine has cores,
+//  several machines are awake. That time at the type's cheapest S0 power, plus
+//  the work at P-state power alone, is the bound when it is the higher one.
+//
+//  A policy that misses deadlines can run every task on its cheapest option,
+//  and all of them at once, so a second bound without the deadlines holds for
+//  any policy at all; its awake time is only the longest task. Both are
+//  printed; --tsv writes "test deadline_kwh any_kwh" lines, and
+//  policymatrix divides by the first for policies without SLA violations and
+//  by the second otherwise.
+//
+//  --gpu-speedup is an upper bound on how much faster a GPU machine runs a
+//  GPU-capable task (about 28 on single-task calibration workloads); larger
+//  values give a lower, safer bound.
+//
+//  Usage: energybound [--gpu-speedup x] [--tsv file] workload.md run.trace
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "CallbackTrace.hpp"
+#include "SimRunner.hpp"
+#include "Workload.hpp"
+
+struct BoundParams {
+    double gpu_speedup = 32;
+    string tsv;
+    string workload;
+    string trace;
+};
+
+struct BoundTask {
+    uint64_t instructions;
+    Time_t arrival;
+    Time_t deadline;
+    CPUType_t cpu;
+    bool gpu;
+    SLAType_t sla;
+};
+
+struct Option {
+    double joules_per_mi;                   // Energy per million instructions
+    double mips;
+};
+
+// When a task must run at its fastest option, in us
+struct Window {
+    double start;
+    double deadline;
+    double run;
+};
+
+// Least awake time, in us, over which every window's run time fits, and the
+// part of it forced by windows shorter than twice their run time, counted in
+// machines of the given cores
+static double AwakeTime(vector<Window> windows, unsigned cores) {
+    if (windows.empty()) return 0;
+    sort(windows.begin(), windows.end(), [](const Window & a, const Window & b) { return a.deadline < b.deadline; });
+    // Disjoint awake intervals, start -> end
+    map<double, double> awake;
+    double total = 0;
+    for (auto & w : windows) {
+        double covered = 0;
+        auto it = awake.upper_bound(w.deadline);
+        while (it != awake.begin()) {
+            --it;
+            if (it->second <= w.start) break;
+            covered += min(it->second, w.deadline) - max(it->first, w.start);
+        }
+        // The rest goes into the gaps, latest first
+        double need = w.run - covered;
+        double at = w.deadline;
+        while (need > 1e-9 && at > w.start) {
+            auto next = awake.lower_bound(at);
+            double gap_end = at, gap_start = w.start;
+            if (next != awake.begin()) {
+                auto before = prev(next);
+                if (before->second >= at) {
+                    at = before->first;             // Already awake; skip over it
+                    continue;
+                }
+                gap_start = max(gap_start, before->second);
+            }
+            double from = max(gap_start, gap_end - need);
+            if (from >= gap_end) break;
+            need -= gap_end - from;
+            total += gap_end - from;
+            // Merge with the neighbours it touches
+            double end = gap_end;
+            if (next != awake.end() && next->first <= end) {
+                end = next->second;
+                awake.erase(next);
+            }
+            auto before = awake.lower_bound(from);
+            if (before != awake.begin() && prev(before)->second >= from) {
+                before = prev(before);
+                from = before->first;
+                awake.erase(before);
+            }
+            awake[from] = end;
+            at = from;
+        }
+    }
+
+    // Forced parts: [deadline - run, start + run] when that is not empty
+    vector<pair<double, int>> edges;
+    for (auto & w : windows) {
+        if (w.deadline - w.run < w.start + w.run) {
+            edges.push_back({w.deadline - w.run, 1});
+            edges.push_back({w.start + w.run, -1});
+        }
+    }
+    sort(edges.begin(), edges.end());
+    double forced = 0, forced_machines = 0;
+    int running = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        running += edges[i].second;
+        if (i + 1 < edges.size() && running > 0) {
+            double span = edges[i + 1].first - edges[i].first;
+            forced += span;
+            forced_machines += span * ((running + cores - 1) / cores);
+        }
+    }
+    return forced_machines + max(0.0, total - forced);
+}
+
+// Least energy per million instructions over mixes of options whose average
+// time per million instructions is at most seconds_per_mi: the lower convex
+// hull at that time. INFINITY if even the fastest option is too slow.
+static double CheapestWithin(const vector<Option> & options, double seconds_per_mi) {
+    double best = INFINITY;
+    for (auto & fast : options) {
+        double fast_s = 1 / fast.mips;
+        if (fast_s > seconds_per_mi) continue;
+        best = min(best, fast.joules_per_mi);
+        // Mixed with a slower option, up to the time allowed
+        for (auto & slow : options) {
+            double slow_s = 1 / slow.mips;
+            if (slow_s <= seconds_per_mi) continue;
+            double share = (seconds_per_mi - fast_s) / (slow_s - fast_s);       // Of the instructions on the slower one
+            best = min(best, (1 - share) * fast.joules_per_mi + share * slow.joules_per_mi);
+        }
+    }
+    return best;
+}
+
+// Every (class, P-state) a task of this CPU type and GPU capability can run on,
+// with S0 power shared by the cores or, without share_idle, P-state power only
+static vector<Option> Options(const Workload & workload, CPUType_t cpu, bool gpu_task, double gpu_speedup, bool share_idle) {
+    vector<Option> options;
+    for (auto & mc : workload.machines) {
+        if (mc.cpu != cpu || mc.count == 0) continue;
+        double base = mc.s_states.empty() ? 0 : mc.s_states[0];
+        double floor = base;
+        for (unsigned s : mc.s_states) floor = min(floor, double(s));
+        double speedup = gpu_task && mc.gpus ? gpu_speedup : 1;
+        for (size_t p = 0; p < mc.mips.size() && p < mc.p_states.size(); p++) {
+            // The floor is charged separately for the whole run
+            double watts = mc.p_states[p] + (share_idle ? (base - floor) / mc.cores : 0);
+            double mips = mc.mips[p] * speedup;
+            options.push_back({watts / mips, mips});
+        }
+    }
+    return options;
+}
+
+static BoundParams ParseArgs(int argc, char * argv[]) {
+    BoundParams params;
+    vector<string> files;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--gpu-speedup") params.gpu_speedup = stod(value());
+        else if (arg == "--tsv") params.tsv = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else files.push_back(arg);
+    }
+    if (files.size() != 2) throw runtime_error("usage: energybound [--gpu-speedup x] [--tsv file] workload.md run.trace");
+    if (params.gpu_speedup < 1) throw runtime_error("--gpu-speedup must be at least 1");
+    params.workload = files[0];
+    params.trace = files[1];
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        BoundParams params = ParseArgs(argc, argv);
+        Workload workload = ReadWorkload(params.workload);
+
+        // Last TaskInfo seen per task; the static fields never change
+        map<TaskId_t, BoundTask> tasks;
+        TraceReader trace;
+        trace.Open(params.trace);
+        TraceEvent event;
+        while (trace.Next(event)) {
+            if (event.kind != TraceEvent::CALL || event.call != CALL_GET_TASK_INFO) continue;
+            const TaskInfo_t & t = event.task;
+            tasks[t.task_id] = {t.total_instructions, t.arrival, t.target_completion, t.required_cpu, t.gpu_capable, t.required_sla};
+        }
+        if (tasks.empty()) throw runtime_error(params.trace + ": no GetTaskInfo() answers; capture a run of a scheduler that asks for them");
+
+        // Work with S0 shared by the cores, and at P-state power alone for the awake-time bound
+        double work_joules = 0, any_joules = 0, sla_joules[NUM_SLAS] = {};
+        double dynamic_joules = 0, any_dynamic_joules = 0;
+        unsigned infeasible = 0, unhosted = 0;
+        Time_t horizon = 0;
+        map<pair<CPUType_t, bool>, vector<Option>> cache, dynamic_cache;
+        map<CPUType_t, vector<Window>> windows;
+        map<CPUType_t, double> longest;
+        for (auto & entry : tasks) {
+            const BoundTask & t = entry.second;
+            auto key = make_pair(t.cpu, t.gpu);
+            if (!cache.count(key)) {
+                cache[key] = Options(workload, t.cpu, t.gpu, params.gpu_speedup, true);
+                dynamic_cache[key] = Options(workload, t.cpu, t.gpu, params.gpu_speedup, false);
+            }
+            const vector<Option> & options = cache[key];
+            const vector<Option> & dynamic = dynamic_cache[key];
+            if (options.empty()) {
+                unhosted++;
+                continue;
+            }
+            double mi = t.instructions / 1e6;
+            double cheapest = INFINITY, cheapest_dynamic = INFINITY, fastest_s = INFINITY;
+            for (size_t o = 0; o < options.size(); o++) {
+                cheapest = min(cheapest, options[o].joules_per_mi);
+                cheapest_dynamic = min(cheapest_dynamic, dynamic[o].joules_per_mi);
+                fastest_s = min(fastest_s, mi / options[o].mips);
+            }
+            double best = cheapest, best_dynamic = cheapest_dynamic;
+            if (t.sla < SLA3 && mi > 0) {
+                double window_s = t.deadline > t.arrival ? (t.deadline - t.arrival) / 1e6 : 0;
+                best = CheapestWithin(options, window_s / mi);
+                best_dynamic = CheapestWithin(dynamic, window_s / mi);
+                if (isinf(best)) {
+                    infeasible++;
+                    best = cheapest;
+                    best_dynamic = cheapest_dynamic;
+                } else {
+                    windows[t.cpu].push_back({double(t.arrival), double(t.deadline), fastest_s * 1e6});
+                }
+            }
+            work_joules += mi * best;
+            any_joules += mi * cheapest;
+            dynamic_joules += mi * best_dynamic;
+            any_dynamic_joules += mi * cheapest_dynamic;
+            if (t.sla < NUM_SLAS) sla_joules[t.sla] += mi * best;
+            horizon = max(horizon, t.arrival + Time_t(fastest_s * 1e6));
+            longest[t.cpu] = max(longest[t.cpu], fastest_s * 1e6);
+        }
+
+        // Awake machine-time per CPU type at its cheapest S0 power above the floor
+        double awake_joules = 0, any_awake_joules = 0, awake_s = 0;
+        for (auto & entry : longest) {
+            CPUType_t cpu = entry.first;
+            double watts = INFINITY;
+            unsigned cores = 1;
+            for (auto & mc : workload.machines) {
+                if (mc.cpu != cpu || mc.count == 0 || mc.s_states.empty()) continue;
+                double floor = *min_element(mc.s_states.begin(), mc.s_states.end());
+                watts = min(watts, mc.s_states[0] - floor);
+                cores = max(cores, mc.cores);
+            }
+            double time_us = max(AwakeTime(windows[cpu], cores), entry.second);
+            awake_s += time_us / 1e6;
+            awake_joules += watts * time_us / 1e6;
+            any_awake_joules += watts * entry.second / 1e6;
+        }
+        bool by_awake = dynamic_joules + awake_joules > work_joules;
+        double deadline_joules = max(work_joules, dynamic_joules + awake_joules);
+        double any_policy_joules = max(any_joules, any_dynamic_joules + any_awake_joules);
+
+        double floor_watts = 0;
+        for (auto & mc : workload.machines) {
+            double floor = mc.s_states.empty() ? 0 : mc.s_states[0];
+            for (unsigned s : mc.s_states) floor = min(floor, double(s));
+            floor_watts += floor * mc.count;
+        }
+        double floor_joules = floor_watts * horizon / 1e6;
+        double bound_kwh = (deadline_joules + floor_joules) / 3.6e6;
+        double any_kwh = (any_policy_joules + floor_joules) / 3.6e6;
+
+        cout << TestName(params.workload) << ": " << tasks.size() << " tasks, " << workload.TotalMachines() << " machines" << endl;
+        cout << setprecision(6) << "  work         " << work_joules / 3.6e6 << " KWh" << endl;
+        for (int s = 0; s < NUM_SLAS; s++) {
+            if (sla_joules[s] > 0) cout << "    SLA" << s << "       " << sla_joules[s] / 3.6e6 << " KWh" << endl;
+        }
+        cout << "  awake        " << (dynamic_joules + awake_joules) / 3.6e6 << " KWh (P-state work " << dynamic_joules / 3.6e6
+             << " KWh, S0 for " << awake_s << " machine-s)" << endl;
+        cout << "  floor        " << floor_joules / 3.6e6 << " KWh (" << floor_watts << " W for " << horizon / 1e6 << " s)" << endl;
+        cout << "  lower bound  " << bound_kwh << " KWh, meeting every deadline (" << (by_awake ? "awake" : "work") << " + floor)" << endl;
+        cout << "               " << any_kwh << " KWh, any policy" << endl;
+        if (infeasible) cout << "  " << infeasible << " tasks cannot meet their deadline on any machine; costed at their cheapest option" << endl;
+        if (unhosted) cout << "  " << unhosted << " tasks have no machine of their CPU type; left out" << endl;
+
+        if (!params.tsv.empty()) {
+            // One line per test; a test already in the file is replaced
+            map<string, string> lines;
+            ifstream in(params.tsv);
+            string line;
+            while (getline(in, line)) {
+                size_t tab = line.find('\t');
+                if (tab != string::npos) lines[line.substr(0, tab)] = line.substr(tab + 1);
+            }
+            ostringstream figure;
+            figure << setprecision(6) << bound_kwh << '\t' << any_kwh;
+            lines[TestName(params.workload)] = figure.str();
+            ofstream out(params.tsv);
+            if (!out) throw runtime_error("could not write " + params.tsv);
+            for (auto & line : lines) out << line.first << '\t' << line.second << endl;
+        }
+        return 0;
+    } catch (const exception & e) {
+        cerr << "energybound: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,279 @@
+//
+//  EnergyShare.cpp
+//  CloudSim
+//
+//  Attributes a run's energy to its tasks, for chargeback and for finding what
+//  is worth optimizing: energy per task, per SLA and per VM type. The machine
+//  power ladders come from the workload file and the run from a callback trace
+//  (CLOUDSIM_CAPTURE), replayed through the ClusterMirror that slacause and
+//  timeline use, which knows which tasks run on which machine and each
+//  machine's S-state and P-state.
+//
+//  Power model, ClusterMirror::Power: a machine in S0 draws its S0 power plus
+//  the P-state power of one core per running task, up to its core count;
+//  otherwise it draws its S-state power.
+//      Dynamic energy (the core power) is split evenly over the tasks running
+//      on the machine at each moment.
+//      Idle energy (S0 and S-state power) goes by --idle:
+//          busy          split evenly over the tasks on the machine at each
+//                        moment; while it has none it stays unattributed
+//                        (the default)
+//          proportional  all of it, cluster-wide, in proportion to each task's
+//                        dynamic energy
+//          none          left unattributed
+//  Each machine's model is then scaled to the energy_consumed of the last
+//  Machine_GetInfo answer for it, so the attribution adds up to what the
+//  simulator measured; the dynamic part is kept and the idle part scaled. The
+//  report states how far the raw model was from the measurement.
+//
+//  Usage: energyshare [--idle busy|proportional|none] [--csv file] workload.md run.trace
+//      --csv file  one row per task: SLA, VM type, machine, dynamic, idle and total J
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "ClusterMirror.hpp"
+
+typedef enum {
+    IDLE_BUSY,
+    IDLE_PROPORTIONAL,
+    IDLE_NONE
+} IdleRule_t;
+
+struct ShareParams {
+    IdleRule_t idle = IDLE_BUSY;
+    string csv;
+    string workload;
+    string trace;
+};
+
+// Running totals of a machine, in joules; tasks snapshot the per-task ones when they join
+struct Totals {
+    double dynamic_per_task = 0;
+    double idle_per_task = 0;
+    double dynamic = 0;
+    double idle = 0;
+    double idle_unattributed = 0;           // With no task on the machine
+};
+
+// A machine's running totals and its last energy_consumed answer, with the model's totals at that time
+struct Meter {
+    Time_t since = 0;
+    Totals totals;
+    bool measured = false;
+    double measured_j = 0;
+    double dynamic_at_measure = 0;
+    double idle_at_measure = 0;
+};
+
+struct Share {
+    bool known = false;
+    SLAType_t sla = SLA3;
+    VMType_t vm_type = LINUX;
+    bool ran = false;
+    MachineId_t first_host = 0;
+    Totals at_join;
+    double dynamic = 0;
+    map<MachineId_t, double> idle;          // Per machine, so each machine's scale can be applied
+};
+
+class Attribution : public ClusterMirror {
+public:
+    Attribution(const ShareParams & params) : ClusterMirror(params.workload), params(params), meters(MachineCount()) {}
+
+    void Finish();
+
+protected:
+    void After(const TraceEvent & e) override {
+        if (e.kind != TraceEvent::CALL) return;
+        if (e.call == CALL_GET_TASK_INFO) {
+            Share & s = GetShare(e.task.task_id);
+            if (s.known) return;
+            s.known = true;
+            s.sla = e.task.required_sla;
+            s.vm_type = e.task.required_vm;
+        } else if (e.call == CALL_MACHINE_GET_INFO) {
+            MachineId_t machine_id = e.machine.machine_id;
+            Advance(machine_id);
+            Meter & meter = meters[machine_id];
+            meter.measured = true;
+            meter.measured_j = double(e.machine.energy_consumed) / 1e6;     // W * us
+            meter.dynamic_at_measure = meter.totals.dynamic;
+            meter.idle_at_measure = meter.totals.idle;
+        }
+    }
+
+    void Changing(MachineId_t machine_id) override { Advance(machine_id); }
+
+    void Joined(TaskId_t task_id, MachineId_t machine_id) override {
+        Share & s = GetShare(task_id);
+        if (!s.ran) s.first_host = machine_id;
+        s.ran = true;
+        s.at_join = meters[machine_id].totals;
+    }
+
+    void Left(TaskId_t task_id, MachineId_t machine_id, const string &) override {
+        Share & s = GetShare(task_id);
+        const Totals & totals = meters[machine_id].totals;
+        s.dynamic += totals.dynamic_per_task - s.at_join.dynamic_per_task;
+        s.idle[machine_id] += totals.idle_per_task - s.at_join.idle_per_task;
+    }
+
+private:
+    Share & GetShare(TaskId_t id) {
+        if (id >= shares.size()) shares.resize(id + 1);
+        return shares[id];
+    }
+
+    // Brings the machine's totals up to now under its current state
+    void Advance(MachineId_t machine_id) {
+        Meter & meter = meters[machine_id];
+        double dt = double(now - meter.since) / 1e6;
+        meter.since = now;
+        if (dt <= 0) return;
+        MachinePower power = Power(machine_id);
+        unsigned tasks = unsigned(GetMachine(machine_id).tasks.size());
+        meter.totals.dynamic += dt * power.dynamic;
+        meter.totals.idle += dt * power.idle;
+        if (tasks) {
+            meter.totals.dynamic_per_task += dt * power.dynamic / tasks;
+            meter.totals.idle_per_task += dt * power.idle / tasks;
+        } else {
+            meter.totals.idle_unattributed += dt * power.idle;
+        }
+    }
+
+    const ShareParams & params;
+    vector<Share> shares;
+    vector<Meter> meters;                   // Per machine of the workload
+};
+
+void Attribution::Finish() {
+    StopAll();
+    for (MachineId_t m = 0; m < meters.size(); m++) Advance(m);
+
+    // Per machine scale of the idle model that makes it meet the measurement
+    double model_j = 0, measured_j = 0;
+    vector<double> scale(meters.size(), 1);
+    for (MachineId_t m = 0; m < meters.size(); m++) {
+        const Meter & meter = meters[m];
+        if (!meter.measured) continue;
+        model_j += meter.dynamic_at_measure + meter.idle_at_measure;
+        measured_j += meter.measured_j;
+        if (meter.idle_at_measure > 0) scale[m] = max(0.0, (meter.measured_j - meter.dynamic_at_measure) / meter.idle_at_measure);
+    }
+
+    // Per task, scaled
+    vector<double> idle(shares.size(), 0);
+    double dynamic_total = 0, idle_attributed = 0, idle_total = 0;
+    for (TaskId_t t = 0; t < shares.size(); t++) {
+        for (auto & entry : shares[t].idle) idle[t] += entry.second * scale[entry.first];
+        dynamic_total += shares[t].dynamic;
+    }
+    for (MachineId_t m = 0; m < meters.size(); m++) idle_total += meters[m].totals.idle * scale[m];
+    if (params.idle == IDLE_NONE) {
+        fill(idle.begin(), idle.end(), 0);
+    } else if (params.idle == IDLE_PROPORTIONAL) {
+        for (TaskId_t t = 0; t < shares.size(); t++) idle[t] = dynamic_total > 0 ? idle_total * shares[t].dynamic / dynamic_total : 0;
+    }
+    for (double j : idle) idle_attributed += j;
+
+    static const char * kRules[] = {"busy", "proportional", "none"};
+    double total = dynamic_total + idle_total;
+    cout << params.trace << ": " << fixed << setprecision(6) << total / 3.6e6 << " KWh attributed, " << measured_j / 3.6e6
+         << " KWh measured";
+    cout.unsetf(ios::fixed);
+    if (measured_j > 0) cout << " (raw model " << showpos << fixed << setprecision(1) << 100 * (model_j - measured_j) / measured_j << noshowpos << "%)";
+    cout.unsetf(ios::fixed);
+    cout << ", idle rule " << kRules[params.idle] << endl;
+
+    // Groups: per SLA and per VM type
+    struct Group {
+        unsigned tasks = 0;
+        double dynamic = 0, idle = 0;
+    };
+    map<string, Group> by_sla, by_vm;
+    for (TaskId_t t = 0; t < shares.size(); t++) {
+        const Share & s = shares[t];
+        if (!s.known) continue;
+        for (auto * g : {&by_sla[SLAName(s.sla)], &by_vm[VMName(s.vm_type)]}) {
+            g->tasks++;
+            g->dynamic += s.dynamic;
+            g->idle += idle[t];
+        }
+    }
+    auto table = [&](const string & title, const map<string, Group> & groups) {
+        cout << endl << left << setw(18) << title << right << setw(8) << "Tasks" << setw(14) << "Dynamic KWh" << setw(12) << "Idle KWh"
+             << setw(12) << "Total KWh" << setw(8) << "Share" << setw(12) << "J/task" << endl;
+        auto row = [&](const string & name, unsigned tasks, double dynamic, double idle_j) {
+            cout << left << setw(18) << name << right << setw(8);
+            if (tasks) cout << tasks;
+            else cout << "-";
+            cout << fixed << setprecision(6) << setw(14) << dynamic / 3.6e6 << setw(12) << idle_j / 3.6e6 << setw(12)
+                 << (dynamic + idle_j) / 3.6e6 << setprecision(1) << setw(7) << (total > 0 ? 100 * (dynamic + idle_j) / total : 0) << "%";
+            if (tasks) cout << setprecision(1) << setw(12) << (dynamic + idle_j) / tasks;
+            cout << endl;
+            cout.unsetf(ios::fixed);
+        };
+        for (auto & entry : groups) row(entry.first, entry.second.tasks, entry.second.dynamic, entry.second.idle);
+        if (idle_total - idle_attributed > 0) row("(no task)", 0, 0, idle_total - idle_attributed);
+    };
+    table("SLA", by_sla);
+    table("VM type", by_vm);
+
+    if (!params.csv.empty()) {
+        ofstream csv(params.csv);
+        if (!csv) throw runtime_error("could not write " + params.csv);
+        csv << "task,sla,vm_type,machine,dynamic_j,idle_j,total_j" << endl;
+        for (TaskId_t t = 0; t < shares.size(); t++) {
+            const Share & s = shares[t];
+            if (!s.known) continue;
+            csv << t << "," << SLAName(s.sla) << "," << VMName(s.vm_type) << ",";
+            if (s.ran) csv << s.first_host;
+            csv << "," << s.dynamic << "," << idle[t] << "," << s.dynamic + idle[t] << endl;
+        }
+    }
+}
+
+static ShareParams ParseArgs(int argc, char * argv[]) {
+    ShareParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--idle") {
+            string rule = value();
+            if (rule == "busy") params.idle = IDLE_BUSY;
+            else if (rule == "proportional") params.idle = IDLE_PROPORTIONAL;
+            else if (rule == "none") params.idle = IDLE_NONE;
+            else throw runtime_error("--idle takes busy, proportional or none");
+        }
+        else if (arg == "--csv") params.csv = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (params.workload.empty()) params.workload = arg;
+        else if (params.trace.empty()) params.trace = arg;
+        else throw runtime_error("one workload and one trace");
+    }
+    if (params.trace.empty()) throw runtime_error("usage: energyshare [--idle busy|proportional|none] [--csv file] workload.md run.trace");
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        ShareParams params = ParseArgs(argc, argv);
+        Attribution attribution(params);
+        attribution.Replay(params.trace);
+        attribution.Finish();
+        return 0;
+    } catch (const exception & e) {
+        cerr << "energyshare: " << e.what() << endl;
+        return 2;
+    }
+}
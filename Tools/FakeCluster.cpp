@@ -0,0 +1,281 @@
+//
+//  FakeCluster.cpp
+//  CloudSim
+//
+
+#include "FakeCluster.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Interfaces.h"
+
+static vector<MachineInfo_t> machines;
+static vector<VMInfo_t> vms;
+static vector<bool> vm_alive;
+static vector<TaskInfo_t> tasks;
+static Time_t now = 0;
+static bool applying = true;
+static uint64_t commands = 0;
+
+static const MachineId_t unattached = MachineId_t(-1);
+
+void FakeCluster_Build(const vector<MachineClass> & classes) {
+    machines.clear();
+    vms.clear();
+    vm_alive.clear();
+    tasks.clear();
+    now = 0;
+    applying = true;
+    commands = 0;
+    for (auto & mc : classes) {
+        for (unsigned i = 0; i < mc.count; i++) {
+            MachineInfo_t info = {};
+            info.num_cpus = mc.cores;
+            info.cpu = mc.cpu;
+            info.memory_size = mc.memory;
+            info.gpus = mc.gpus;
+            info.performance = mc.mips;
+            info.c_states = mc.c_states;
+            info.p_states = mc.p_states;
+            info.s_states = mc.s_states;
+            info.s_state = S5;
+            info.p_state = P0;
+            info.machine_id = MachineId_t(machines.size());
+            machines.push_back(info);
+        }
+    }
+}
+
+void FakeCluster_SetApply(bool value) {
+    applying = value;
+}
+
+TaskId_t FakeCluster_AddTask(TaskInfo_t info) {
+    info.task_id = TaskId_t(tasks.size());
+    tasks.push_back(info);
+    return info.task_id;
+}
+
+void FakeCluster_SetTime(Time_t time) {
+    now = time;
+}
+
+unsigned FakeCluster_VMCount() {
+    return unsigned(count(vm_alive.begin(), vm_alive.end(), true));
+}
+
+uint64_t FakeCluster_Commands() {
+    return commands;
+}
+
+static MachineInfo_t & Machine(MachineId_t machine_id) {
+    if (machine_id >= machines.size()) ThrowException("FakeCluster: unknown machine ", machine_id);
+    return machines[machine_id];
+}
+
+static VMInfo_t & VM(VMId_t vm_id) {
+    if (vm_id >= vms.size() || !vm_alive[vm_id]) ThrowException("FakeCluster: unknown VM ", vm_id);
+    return vms[vm_id];
+}
+
+static TaskInfo_t & Task(TaskId_t task_id) {
+    if (task_id >= tasks.size()) ThrowException("FakeCluster: unknown task ", task_id);
+    return tasks[task_id];
+}
+
+// Debugging
+
+void SimOutput(string msg, unsigned verbose_level) {
+}
+
+void ThrowException(string err_msg) {
+    throw runtime_error(err_msg);
+}
+
+void ThrowException(string err_msg, string further_input) {
+    throw runtime_error(err_msg + further_input);
+}
+
+void ThrowException(string err_msg, unsigned further_input) {
+    throw runtime_error(err_msg + to_string(further_input));
+}
+
+// Machines
+
+CPUType_t Machine_GetCPUType(MachineId_t machine_id) {
+    return Machine(machine_id).cpu;
+}
+
+uint64_t Machine_GetEnergy(MachineId_t machine_id) {
+    return Machine(machine_id).energy_consumed;
+}
+
+double Machine_GetClusterEnergy() {
+    return 0.0;
+}
+
+MachineInfo_t Machine_GetInfo(MachineId_t machine_id) {
+    return Machine(machine_id);
+}
+
+unsigned Machine_GetTotal() {
+    return unsigned(machines.size());
+}
+
+void Machine_SetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state) {
+    MachineInfo_t & machine = Machine(machine_id);
+    if (p_state >= machine.performance.size()) ThrowException("FakeCluster: bad P-state ", p_state);
+    commands++;
+    if (applying) machine.p_state = p_state;
+}
+
+void Machine_SetState(MachineId_t machine_id, MachineState_t s_state) {
+    MachineInfo_t & machine = Machine(machine_id);
+    commands++;
+    if (applying) machine.s_state = s_state;
+}
+
+// Statistics, simulator and tasks
+
+double GetSLAReport(SLAType_t sla) {
+    return 0.0;
+}
+
+Time_t Now() {
+    return now;
+}
+
+unsigned GetNumTasks() {
+    return unsigned(tasks.size());
+}
+
+TaskInfo_t GetTaskInfo(TaskId_t task_id) {
+    return Task(task_id);
+}
+
+unsigned GetTaskMemory(TaskId_t task_id) {
+    return Task(task_id).required_memory;
+}
+
+unsigned GetTaskPriority(TaskId_t task_id) {
+    return Task(task_id).priority;
+}
+
+bool IsSLAViolated(TaskId_t task_id) {
+    TaskInfo_t & task = Task(task_id);
+    return task.required_sla != SLA3 && now > task.target_completion;
+}
+
+bool IsTaskCompleted(TaskId_t task_id) {
+    return Task(task_id).completed;
+}
+
+bool IsTaskGPUCapable(TaskId_t task_id) {
+    return Task(task_id).gpu_capable;
+}
+
+CPUType_t RequiredCPUType(TaskId_t task_id) {
+    return Task(task_id).required_cpu;
+}
+
+SLAType_t RequiredSLA(TaskId_t task_id) {
+    return Task(task_id).required_sla;
+}
+
+VMType_t RequiredVMType(TaskId_t task_id) {
+    return Task(task_id).required_vm;
+}
+
+void SetTaskPriority(TaskId_t task_id, Priority_t priority) {
+    TaskInfo_t & task = Task(task_id);
+    commands++;
+    if (applying) task.priority = priority;
+}
+
+// VMs
+
+void VM_Attach(VMId_t vm_id, MachineId_t machine_id) {
+    VMInfo_t & vm = VM(vm_id);
+    MachineInfo_t & machine = Machine(machine_id);
+    if (vm.machine_id != unattached) ThrowException("FakeCluster: VM already attached ", vm_id);
+    if (!IsVMCompatible(vm.vm_type, machine.cpu)) ThrowException("FakeCluster: VM type does not run on machine ", machine_id);
+    commands++;
+    if (!applying) return;
+    vm.machine_id = machine_id;
+    machine.active_vms++;
+    machine.memory_used += VM_MEMORY_OVERHEAD;
+}
+
+void VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    VMInfo_t & vm = VM(vm_id);
+    TaskInfo_t & task = Task(task_id);
+    if (vm.machine_id == unattached) ThrowException("FakeCluster: VM not attached ", vm_id);
+    commands++;
+    if (!applying) return;
+    MachineInfo_t & machine = Machine(vm.machine_id);
+    vm.active_tasks.push_back(task_id);
+    task.priority = priority;
+    machine.active_tasks++;
+    machine.memory_used += task.required_memory;
+}
+
+VMId_t VM_Create(VMType_t vm_type, CPUType_t cpu) {
+    commands++;
+    // Creation is applied even when commands are not, so the caller gets an id it can use
+    VMInfo_t vm = {};
+    vm.cpu = cpu;
+    vm.machine_id = unattached;
+    vm.vm_id = VMId_t(vms.size());
+    vm.vm_type = vm_type;
+    vms.push_back(vm);
+    vm_alive.push_back(true);
+    return vm.vm_id;
+}
+
+VMInfo_t VM_GetInfo(VMId_t vm_id) {
+    return VM(vm_id);
+}
+
+void VM_Migrate(VMId_t vm_id, MachineId_t machine_id) {
+    VMInfo_t & vm = VM(vm_id);
+    MachineInfo_t & target = Machine(machine_id);
+    if (vm.machine_id == unattached) ThrowException("FakeCluster: VM not attached ", vm_id);
+    commands++;
+    if (!applying) return;
+    MachineInfo_t & source = Machine(vm.machine_id);
+    unsigned memory = VM_MEMORY_OVERHEAD;
+    for (TaskId_t task_id : vm.active_tasks) memory += tasks[task_id].required_memory;
+    source.active_vms--;
+    source.active_tasks -= unsigned(vm.active_tasks.size());
+    source.memory_used -= memory;
+    target.active_vms++;
+    target.active_tasks += unsigned(vm.active_tasks.size());
+    target.memory_used += memory;
+    vm.machine_id = machine_id;
+}
+
+void VM_RemoveTask(VMId_t vm_id, TaskId_t task_id) {
+    VMInfo_t & vm = VM(vm_id);
+    auto it = find(vm.active_tasks.begin(), vm.active_tasks.end(), task_id);
+    if (it == vm.active_tasks.end()) ThrowException("FakeCluster: task not on VM ", task_id);
+    commands++;
+    if (!applying) return;
+    MachineInfo_t & machine = Machine(vm.machine_id);
+    vm.active_tasks.erase(it);
+    machine.active_tasks--;
+    machine.memory_used -= tasks[task_id].required_memory;
+}
+
+void VM_Shutdown(VMId_t vm_id) {
+    VMInfo_t & vm = VM(vm_id);
+    if (!vm.active_tasks.empty()) ThrowException("FakeCluster: VM still has tasks ", vm_id);
+    commands++;
+    if (!applying) return;
+    if (vm.machine_id != unattached) {
+        MachineInfo_t & machine = Machine(vm.machine_id);
+        machine.active_vms--;
+        machine.memory_used -= VM_MEMORY_OVERHEAD;
+    }
+    vm_alive[vm_id] = false;
+}
@@ -0,0 +1,33 @@
+//
+//  FakeCluster.hpp
+//  CloudSim
+//
+//  An in-memory implementation of the Interfaces.h functions the scheduler
+//  calls, linkable in place of the simulator objects. It keeps machines, VMs
+//  and tasks as plain tables and applies commands immediately: state changes
+//  complete at once and deliver no callbacks, tasks make no progress, and
+//  energy and SLA figures stay at zero. Meant for timing scheduler code on a
+//  cluster in a known state, not for judging its decisions.
+//
+
+#ifndef FakeCluster_hpp
+#define FakeCluster_hpp
+
+#include "Workload.hpp"
+
+// Replaces the cluster with the machines of 'classes', all in S5 with no VMs,
+// and drops every task. Machine ids follow the class order, as in Init().
+void FakeCluster_Build(const vector<MachineClass> & classes);
+
+// When false, commands are checked and counted but leave the cluster as it is,
+// so a benchmark can repeat an operation against the same state.
+void FakeCluster_SetApply(bool apply);
+
+// Adds a task that has arrived but is not placed. info.task_id is ignored.
+TaskId_t FakeCluster_AddTask(TaskInfo_t info);
+void FakeCluster_SetTime(Time_t now);
+
+unsigned FakeCluster_VMCount();
+uint64_t FakeCluster_Commands();        // Commands issued since Build, applied or not
+
+#endif /* FakeCluster_hpp */
@@ -0,0 +1,206 @@
+//
+//  FleetSize.cpp
+//  CloudSim
+//
+//  Capacity planning: finds the smallest machine fleet that still runs a
+//  workload within its SLA limits (--sla-limits, default 5,10,20 percent of
+//  SLA0..SLA2 tasks late). Machine classes are shrunk one at a time, in file
+//  order: each class's count is searched between 0 and its current value with
+//  the classes before it at their minimum and the ones after it at full size.
+//  The search assumes fewer machines never improve the SLA figures; every
+//  round runs one candidate count per core (a multi-way bisection), so it
+//  needs about log(count) / log(cores + 1) rounds per class.
+//
+//  Reports the minimal composition with its energy, SLA figures and fleet
+//  machine-hours (machines times simulated hours) against the full fleet, and
+//  writes it as a workload file with -o.
+//
+//  Usage: fleetsize [-j jobs] [--sla-limits a,b,c] [--simulator path] [-o file] workload.md
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "SimRunner.hpp"
+#include "Workload.hpp"
+
+struct FleetParams {
+    unsigned jobs = 0;
+    SLALimits sla_limits;
+    string simulator = "./simulator";
+    string output;
+    string workload;
+};
+
+class FleetSearch {
+public:
+    FleetSearch(const FleetParams & params, const Workload & workload, const string & dir)
+        : params(params), workload(workload), dir(dir) {}
+
+    // Runs every composition not tried yet, at most one per core at a time
+    void Evaluate(const vector<vector<unsigned>> & compositions) {
+        vector<SimJob> jobs;
+        vector<string> keys;
+        for (auto & counts : compositions) {
+            string key = Key(counts);
+            if (results.count(key) || find(keys.begin(), keys.end(), key) != keys.end()) continue;
+            SimJob job;
+            job.binary = params.simulator;
+            job.workload = Write(counts, dir + "/fleet." + to_string(runs + jobs.size()) + ".md");
+            jobs.push_back(job);
+            keys.push_back(key);
+        }
+        vector<SimResult> done = RunJobs(jobs, params.jobs);
+        for (size_t i = 0; i < done.size(); i++) {
+            remove(jobs[i].workload.c_str());
+            results[keys[i]] = done[i];
+        }
+        runs += unsigned(done.size());
+    }
+
+    const SimResult & Result(const vector<unsigned> & counts) const { return results.at(Key(counts)); }
+
+    // Within the limits, with a machine left for every CPU type some task requires.
+    // (Tasks nothing can host never count against the SLA report.)
+    bool Meets(const vector<unsigned> & counts) const {
+        for (auto & tc : workload.tasks) {
+            bool hosted = false;
+            for (size_t c = 0; c < counts.size(); c++) hosted = hosted || (counts[c] > 0 && workload.machines[c].cpu == tc.cpu);
+            if (!hosted) return false;
+        }
+        const SimResult & r = Result(counts);
+        return r.ok && params.sla_limits.Met(r);
+    }
+
+    // The workload with these class counts; classes at zero are left out
+    string Write(const vector<unsigned> & counts, const string & filename) const {
+        Workload copy = workload;
+        copy.machines.clear();
+        for (size_t c = 0; c < counts.size(); c++) {
+            if (counts[c] == 0) continue;
+            copy.machines.push_back(workload.machines[c]);
+            copy.machines.back().count = counts[c];
+        }
+        ofstream out(filename);
+        if (!out) throw runtime_error("could not write " + filename);
+        WriteWorkload(out, copy);
+        return filename;
+    }
+
+    unsigned Runs() const { return runs; }
+
+private:
+    static string Key(const vector<unsigned> & counts) {
+        string key;
+        for (unsigned n : counts) key += to_string(n) + ",";
+        return key;
+    }
+
+    const FleetParams & params;
+    const Workload & workload;
+    string dir;
+    map<string, SimResult> results;
+    unsigned runs = 0;
+};
+
+static FleetParams ParseArgs(int argc, char * argv[]) {
+    FleetParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--sla-limits") params.sla_limits.Parse(value());
+        else if (arg == "--simulator") params.simulator = value();
+        else if (arg == "-o") params.output = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (params.workload.empty()) params.workload = arg;
+        else throw runtime_error("one workload at a time");
+    }
+    if (params.workload.empty()) throw runtime_error("usage: fleetsize [-j jobs] [--sla-limits a,b,c] [--simulator path] [-o file] workload.md");
+    if (params.jobs == 0) params.jobs = unsigned(max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+    return params;
+}
+
+static void Report(const string & what, const vector<unsigned> & counts, const SimResult & r) {
+    unsigned machines = 0;
+    for (unsigned n : counts) machines += n;
+    cout << left << setw(8) << what << right << setw(10) << machines << setw(12) << setprecision(6) << r.energy_kwh
+         << setw(10) << r.sla[0] << setw(10) << r.sla[1] << setw(10) << r.sla[2]
+         << setw(16) << fixed << setprecision(2) << machines * r.runtime_s / 3600 << endl;
+    cout.unsetf(ios::fixed);
+}
+
+int main(int argc, char * argv[]) {
+    string dir = (filesystem::temp_directory_path() / ("fleetsize." + to_string(getpid()))).string();
+    try {
+        FleetParams params = ParseArgs(argc, argv);
+        Workload workload = ReadWorkload(params.workload);
+        filesystem::create_directories(dir);
+        FleetSearch search(params, workload, dir);
+
+        vector<unsigned> full;
+        for (auto & mc : workload.machines) full.push_back(mc.count);
+        search.Evaluate({full});
+        if (!search.Meets(full)) {
+            const SimResult & r = search.Result(full);
+            filesystem::remove_all(dir);
+            cerr << "fleetsize: the full fleet already misses the limits ("
+                 << (r.ok ? "SLA0 " + to_string(r.sla[0]) + "%, SLA1 " + to_string(r.sla[1]) + "%, SLA2 " + to_string(r.sla[2]) + "%" : r.error)
+                 << ")" << endl;
+            return 1;
+        }
+
+        vector<unsigned> best = full;
+        for (size_t c = 0; c < full.size(); c++) {
+            // best[c] meets the limits; every count <= bad does not (-1: none known)
+            long bad = -1;
+            while (long(best[c]) - bad > 1) {
+                long lo = bad, hi = best[c];
+                unsigned points = unsigned(min<long>(params.jobs, hi - lo - 1));
+                vector<vector<unsigned>> candidates;
+                for (unsigned p = 1; p <= points; p++) {
+                    candidates.push_back(best);
+                    candidates.back()[c] = unsigned(lo + (hi - lo) * p / (points + 1));
+                }
+                search.Evaluate(candidates);
+                for (auto & candidate : candidates) {
+                    if (search.Meets(candidate)) {
+                        if (candidate[c] < best[c]) best = candidate;
+                    }
+                }
+                for (auto & candidate : candidates) {
+                    if (!search.Meets(candidate) && long(candidate[c]) < long(best[c])) bad = max(bad, long(candidate[c]));
+                }
+            }
+            cout << "class " << c + 1 << " (" << CPUName(workload.machines[c].cpu) << (workload.machines[c].gpus ? ", GPU" : "")
+                 << "): " << full[c] << " -> " << best[c] << " machines" << endl;
+        }
+
+        cout << endl << left << setw(8) << "" << right << setw(10) << "Machines" << setw(12) << "Energy" << setw(10) << "SLA0"
+             << setw(10) << "SLA1" << setw(10) << "SLA2" << setw(16) << "Machine-hours" << endl;
+        Report("full", full, search.Result(full));
+        Report("minimal", best, search.Result(best));
+        cout << search.Runs() << " simulator runs" << endl;
+        if (!params.output.empty()) {
+            search.Write(best, params.output);
+            cout << "Minimal fleet written to " << params.output << endl;
+        }
+        filesystem::remove_all(dir);
+        return 0;
+    } catch (const exception & e) {
+        filesystem::remove_all(dir);
+        cerr << "fleetsize: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,113 @@
+//
+//  GaussianProcess.cpp
+//  CloudSim
+//
+
+#include "GaussianProcess.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+double GaussianProcess::Kernel(const vector<double> & a, const vector<double> & b) const {
+    double d2 = 0;
+    for (size_t i = 0; i < a.size(); i++) d2 += (a[i] - b[i]) * (a[i] - b[i]);
+    return exp(-0.5 * d2 / (length_scale * length_scale));
+}
+
+void GaussianProcess::Fit(const vector<vector<double>> & x, const vector<double> & y) {
+    double best_scale = length_scale, best_likelihood = -INFINITY;
+    for (double scale : {0.05, 0.1, 0.2, 0.35, 0.5, 0.75, 1.0, 1.5}) {
+        Fit(x, y, scale);
+        double likelihood = LogMarginalLikelihood();
+        if (likelihood > best_likelihood) {
+            best_likelihood = likelihood;
+            best_scale = scale;
+        }
+    }
+    Fit(x, y, best_scale);
+}
+
+void GaussianProcess::Fit(const vector<vector<double>> & x, const vector<double> & y, double scale) {
+    if (x.empty() || x.size() != y.size()) throw runtime_error("GaussianProcess::Fit(): need as many values as points");
+    size_t n = x.size();
+    points = x;
+    length_scale = scale;
+
+    y_mean = 0;
+    for (double v : y) y_mean += v;
+    y_mean /= n;
+    double var = 0;
+    for (double v : y) var += (v - y_mean) * (v - y_mean);
+    y_scale = n > 1 && var > 0 ? sqrt(var / (n - 1)) : 1;
+    standardized.resize(n);
+    for (size_t i = 0; i < n; i++) standardized[i] = (y[i] - y_mean) / y_scale;
+
+    // Cholesky of K + noise I; more jitter if rounding makes it indefinite
+    for (double jitter = noise; ; jitter *= 10) {
+        chol.assign(n, vector<double>(n, 0));
+        bool ok = true;
+        for (size_t i = 0; i < n && ok; i++) {
+            for (size_t j = 0; j <= i; j++) {
+                double sum = Kernel(points[i], points[j]) + (i == j ? jitter : 0);
+                for (size_t k = 0; k < j; k++) sum -= chol[i][k] * chol[j][k];
+                if (i == j) {
+                    if (sum <= 0) {
+                        ok = false;
+                        break;
+                    }
+                    chol[i][i] = sqrt(sum);
+                } else {
+                    chol[i][j] = sum / chol[j][j];
+                }
+            }
+        }
+        if (ok) break;
+        if (jitter > 1) throw runtime_error("GaussianProcess::Fit(): kernel matrix is not positive definite");
+    }
+
+    // alpha = K^-1 y through L L^T
+    alpha = standardized;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < i; k++) alpha[i] -= chol[i][k] * alpha[k];
+        alpha[i] /= chol[i][i];
+    }
+    for (size_t i = n; i-- > 0; ) {
+        for (size_t k = i + 1; k < n; k++) alpha[i] -= chol[k][i] * alpha[k];
+        alpha[i] /= chol[i][i];
+    }
+}
+
+double GaussianProcess::LogMarginalLikelihood() const {
+    double fit = 0, complexity = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        fit += standardized[i] * alpha[i];
+        complexity += log(chol[i][i]);
+    }
+    return -0.5 * fit - complexity;
+}
+
+pair<double, double> GaussianProcess::Predict(const vector<double> & x) const {
+    size_t n = points.size();
+    vector<double> k(n);
+    double mean = 0;
+    for (size_t i = 0; i < n; i++) {
+        k[i] = Kernel(points[i], x);
+        mean += k[i] * alpha[i];
+    }
+    // v = L^-1 k, variance = k(x, x) - v.v
+    double variance = 1;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < i; j++) k[i] -= chol[i][j] * k[j];
+        k[i] /= chol[i][i];
+        variance -= k[i] * k[i];
+    }
+    return {y_mean + y_scale * mean, y_scale * sqrt(max(variance, 0.0))};
+}
+
+double ExpectedImprovement(double mean, double sd, double best) {
+    if (sd <= 0) return max(best - mean, 0.0);
+    double z = (best - mean) / sd;
+    double cdf = 0.5 * erfc(-z / sqrt(2.0));
+    double pdf = exp(-0.5 * z * z) / sqrt(2 * M_PI);
+    return (best - mean) * cdf + sd * pdf;
+}
@@ -0,0 +1,51 @@
+//
+//  GaussianProcess.hpp
+//  CloudSim
+//
+//  Gaussian-process regression for the tuner: a surrogate of an expensive
+//  function over the unit cube, fitted to the points evaluated so far, with
+//  a squared-exponential kernel whose length scale is picked by maximizing the
+//  marginal likelihood over a small ladder. Observations are standardized, so
+//  the function's units do not matter. Small dense problems only (the kernel
+//  matrix is factored directly, O(n^3) in the number of points).
+//
+
+#ifndef GaussianProcess_hpp
+#define GaussianProcess_hpp
+
+#include <utility>
+#include <vector>
+
+#include "SimTypes.h"
+
+class GaussianProcess {
+public:
+    // Chooses the length scale, then fits
+    void Fit(const vector<vector<double>> & x, const vector<double> & y);
+
+    // Fits with the given length scale
+    void Fit(const vector<vector<double>> & x, const vector<double> & y, double length_scale);
+
+    // Posterior mean and standard deviation at x, in the units of y
+    pair<double, double> Predict(const vector<double> & x) const;
+
+    double LengthScale() const { return length_scale; }
+
+private:
+    double Kernel(const vector<double> & a, const vector<double> & b) const;
+    double LogMarginalLikelihood() const;
+
+    vector<vector<double>> points;
+    vector<double> alpha;                   // K^-1 (y - mean) / scale
+    vector<vector<double>> chol;            // Lower Cholesky factor of K
+    double y_mean = 0;
+    double y_scale = 1;
+    double length_scale = 0.3;
+    double noise = 1e-6;                    // Jitter; simulator runs are deterministic
+    vector<double> standardized;
+};
+
+// Expected amount by which a point with this posterior falls below 'best' (minimization)
+double ExpectedImprovement(double mean, double sd, double best);
+
+#endif /* GaussianProcess_hpp */
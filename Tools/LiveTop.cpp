@@ -0,0 +1,149 @@
+//
+//  LiveTop.cpp
+//  CloudSim
+//
+//  Watches a run that publishes live counters (CLOUDSIM_LIVE=name, see
+//  LiveMetrics.hpp): simulated time, progress, events and simulated seconds
+//  per wall second, active tasks, awake machines, energy and SLA violations so
+//  far, and an ETA. Only reads the shared memory, so watching costs the run
+//  nothing.
+//
+//  Progress is completed tasks over GetNumTasks(). While tasks still arrive,
+//  the ETA divides the simulated time left until the last arrival by the
+//  simulated-to-wall ratio of the last refresh interval; that time is the
+//  workload's horizon (its latest task class end) with --workload, otherwise
+//  it is extrapolated from the arrivals. The active tasks over the rate tasks
+//  completed at in the last interval is the least it can be, and all of it
+//  once every task has arrived.
+//
+//  On a terminal the display is redrawn in place; otherwise one line is
+//  printed per refresh. It exits when the run completes or its process is gone.
+//
+//  Usage: livetop [--interval s] [--workload file.md] [--once] [name]
+//      name        the CLOUDSIM_LIVE name, default cloudsim
+//      --once      print the current counters once and exit
+//
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+#include "LiveMetrics.hpp"
+#include "Workload.hpp"
+
+struct LiveTopParams {
+    double interval_s = 1;
+    string workload;
+    bool once = false;
+    string name = "cloudsim";
+};
+
+static string Duration(double s) {
+    if (s < 0) return "-";
+    if (s > 0 && s < 0.5) return "<1s";
+    ostringstream out;
+    unsigned total = unsigned(s + 0.5);
+    if (total >= 3600) out << total / 3600 << "h" << setw(2) << setfill('0') << total % 3600 / 60 << "m";
+    else if (total >= 60) out << total / 60 << "m" << setw(2) << setfill('0') << total % 60 << "s";
+    else out << total << "s";
+    return out.str();
+}
+
+static LiveTopParams ParseArgs(int argc, char * argv[]) {
+    LiveTopParams params;
+    bool named = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--interval") params.interval_s = stod(value());
+        else if (arg == "--workload") params.workload = value();
+        else if (arg == "--once") params.once = true;
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (!named) params.name = arg, named = true;
+        else throw runtime_error("one run at a time");
+    }
+    if (params.interval_s <= 0) throw runtime_error("--interval must be positive");
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        LiveTopParams params = ParseArgs(argc, argv);
+        Time_t horizon = params.workload.empty() ? 0 : ReadWorkload(params.workload).Horizon();
+        string error;
+        const LiveSegment * segment = OpenLiveSegment(params.name, error);
+        if (!segment) throw runtime_error(error);
+        bool tty = isatty(STDOUT_FILENO);
+
+        LiveCounters c, previous = {};
+        bool have_previous = false;
+        for (;;) {
+            if (!ReadLive(segment, c)) throw runtime_error(params.name + " is not a live metrics segment of this version");
+            double wall = double(c.wall_ns - c.wall_start_ns) / 1e9;
+            double simulated = double(c.simulated_us) / 1e6;
+
+            // Rates over the last interval, or over the whole run so far
+            const LiveCounters & base = have_previous && c.wall_ns > previous.wall_ns ? previous : LiveCounters{};
+            double dwall = double(c.wall_ns - (base.wall_ns ? base.wall_ns : c.wall_start_ns)) / 1e9;
+            double ratio = dwall > 0 ? (simulated - double(base.simulated_us) / 1e6) / dwall : 0;
+            double events = dwall > 0 ? double(c.events - base.events) / dwall : 0;
+            double completions = dwall > 0 ? double(c.tasks_completed - base.tasks_completed) / dwall : 0;
+
+            double progress = c.finished ? 1 : c.tasks_total ? double(c.tasks_completed) / c.tasks_total : 0;
+            uint64_t active = c.tasks_arrived - c.tasks_completed;
+            bool arriving = horizon ? c.simulated_us < horizon : c.tasks_arrived < c.tasks_total;
+            double eta = c.finished ? 0 : completions > 0 ? active / completions : -1;
+            if (!c.finished && arriving) {
+                double left = -1;
+                if (horizon) left = double(horizon - c.simulated_us) / 1e6;
+                else if (c.tasks_arrived) left = simulated * c.tasks_total / c.tasks_arrived - simulated;
+                if (ratio > 0 && left >= 0) eta = max(eta, left / ratio);
+            }
+
+            ostringstream out;
+            out << fixed;
+            if (tty) {
+                out << "\033[H\033[J" << params.name << "  pid " << c.pid << (c.finished ? "  finished" : "") << "\n"
+                    << setprecision(1) << "Simulated   " << simulated << " s of " << (horizon ? to_string(horizon / 1000000) + " s" : "?")
+                    << "  (" << 100 * progress << "%)  wall " << Duration(wall) << "  ETA " << Duration(eta) << "\n"
+                    << "Throughput  " << setprecision(0) << events << " events/s  " << setprecision(2) << ratio << " simulated s per wall s\n"
+                    << "Tasks       " << c.tasks_arrived << " of " << c.tasks_total << " arrived, " << c.tasks_completed << " done, "
+                    << active << " active" << (arriving || c.finished ? "" : ", all arrived") << "\n"
+                    << "Machines    " << c.machines_awake << " of " << c.machines << " awake\n"
+                    << setprecision(4) << "Energy      " << c.energy_kwh << " KWh\n" << setprecision(2) << "SLA         ";
+                for (unsigned s = SLA0; s < SLA3; s++) out << SLAName(SLAType_t(s)) << " " << c.sla_violations[s] << "%  ";
+                out << c.sla_warnings << " warnings\n";
+            } else {
+                out << setprecision(1) << "t=" << simulated << "s " << 100 * progress << "% wall=" << Duration(wall) << " eta=" << Duration(eta)
+                    << setprecision(0) << " events/s=" << events << setprecision(2) << " sim/wall=" << ratio << " tasks=" << c.tasks_arrived
+                    << "/" << c.tasks_total << " active="
+                    << active << " awake=" << c.machines_awake << "/" << c.machines << setprecision(4)
+                    << " energy=" << c.energy_kwh << "KWh" << setprecision(2);
+                for (unsigned s = SLA0; s < SLA3; s++) out << " " << SLAName(SLAType_t(s)) << "=" << c.sla_violations[s] << "%";
+                out << (c.finished ? " finished" : "") << "\n";
+            }
+            cout << out.str() << flush;
+
+            if (params.once || c.finished) return 0;
+            if (kill(c.pid, 0) != 0 && errno == ESRCH) {
+                cout << "The run (pid " << c.pid << ") ended without completing" << endl;
+                return 1;
+            }
+            previous = c;
+            have_previous = true;
+            this_thread::sleep_for(chrono::duration<double>(params.interval_s));
+        }
+    } catch (const exception & e) {
+        cerr << "livetop: " << e.what() << endl;
+        return 2;
+    }
+}
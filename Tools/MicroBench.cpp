@@ -0,0 +1,236 @@
+//
+//  MicroBench.cpp
+//  CloudSim
+//
+//  Times individual Scheduler methods against the in-memory FakeCluster, for
+//  a grid of cluster sizes, VM pool sizes and load levels, and reports ns/op
+//  and heap allocations/op (counted by replacing operator new in this program).
+//
+//  For each configuration a fresh Scheduler runs Init() on the fake cluster and
+//  receives load x (cores of its powered-on machines) tasks through NewTask().
+//  Commands are then switched off (FakeCluster_SetApply), so every iteration of
+//  a benchmark sees the same cluster.
+//
+//  The scheduler powers on one machine with one VM per active_machines, split
+//  evenly over the CPU types and capped by each type's machines, and its
+//  placement loops are O(VMs). --vms sets active_machines for each run, as a
+//  count or as a percentage of the machines ("10%", the default, so the pool
+//  grows with the cluster); the VM count reported is the pool Init() built.
+//
+//  Usage: microbench [--machines 100,1000,10000] [--vms 10%,...] [--loads 0.5,1,2]
+//                    [--workload file] [--bench name] [--min-time seconds] [--seed N]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#include "FakeCluster.hpp"
+#include "Random.hpp"
+#include "Scheduler.hpp"
+
+// Allocation counting
+
+static uint64_t allocations = 0;
+
+void * operator new(size_t size) {
+    allocations++;
+    if (void * p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void * p) noexcept {
+    free(p);
+}
+
+void operator delete(void * p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchParams {
+    vector<unsigned> machines = {100, 1000, 10000};
+    vector<string> vms = {"10%"};           // active_machines: a count, or a percentage of the machines
+    vector<double> loads = {0.5, 1, 2};     // Tasks per core of the powered-on machines
+    string workload;                        // Take the machine classes from here instead
+    string bench;                           // Run only the benchmark with this name
+    double min_time = 0.1;                  // Seconds per measurement
+    uint64_t seed = 520230;
+};
+
+// A fleet of n machines in the proportions of the Test_Cases classes. RISC-V
+// is left out: the scheduler has no default VM type for it.
+static vector<MachineClass> SyntheticFleet(unsigned n) {
+    vector<MachineClass> classes = {
+        {0, X86,   8,  16384, {120, 100, 100, 80, 40, 10, 0}, {12, 8, 6, 4}, {12, 3, 1, 0}, {3000, 2400, 2000, 1500}, false},
+        {0, X86,   16, 32768, {200, 160, 160, 120, 60, 15, 0}, {16, 12, 8, 6}, {16, 4, 2, 0}, {4000, 3200, 2400, 1600}, true},
+        {0, ARM,   4,  8192,  {40, 20, 16, 12, 10, 4, 0}, {4, 2, 2, 1}, {4, 1, 1, 0}, {1800, 1400, 1000, 600}, false},
+        {0, POWER, 16, 65536, {300, 240, 240, 180, 90, 20, 0}, {20, 15, 10, 8}, {20, 5, 2, 0}, {3500, 2800, 2100, 1400}, true},
+    };
+    const double share[] = {0.4, 0.2, 0.25, 0.15};
+    unsigned assigned = 0;
+    for (size_t i = 0; i < classes.size(); i++) {
+        classes[i].count = i + 1 < classes.size() ? unsigned(n * share[i]) : n - assigned;
+        assigned += classes[i].count;
+    }
+    return classes;
+}
+
+static VMType_t DefaultVM(CPUType_t cpu) {
+    return cpu == POWER ? AIX : cpu == ARM ? WIN : LINUX;
+}
+
+// A task that fits the given machine. Deadlines are spread so that about half
+// of the tasks look at risk to CheckDeadlinesAndRebalance at time 0.
+static TaskInfo_t MakeTask(Rng & rng, const MachineInfo_t & machine) {
+    TaskInfo_t task = {};
+    Time_t runtime = rng.Range(100000, 10000000);
+    task.total_instructions = uint64_t(machine.performance[0]) * runtime;
+    task.remaining_instructions = task.total_instructions;
+    task.target_completion = Time_t(runtime * rng.Uniform(1.2, 3.0));
+    task.gpu_capable = rng.Uniform() < 0.25;
+    task.priority = Priority_t(rng.Range(HIGH_PRIORITY, LOW_PRIORITY));
+    task.required_cpu = machine.cpu;
+    task.required_memory = unsigned(rng.Range(8, 64));
+    task.required_sla = SLAType_t(rng.Range(SLA0, SLA3));
+    task.required_vm = DefaultVM(machine.cpu);
+    return task;
+}
+
+struct Measurement {
+    uint64_t iterations;
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+// Doubles the iteration count until one round takes at least min_time
+template <typename Op>
+static Measurement Measure(Op op, double min_time) {
+    for (uint64_t iterations = 1;; iterations *= 2) {
+        uint64_t allocations_before = allocations;
+        auto start = chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) op(i);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (seconds >= min_time || iterations >= (uint64_t(1) << 40)) {
+            return {iterations, seconds * 1e9 / iterations, double(allocations - allocations_before) / iterations};
+        }
+    }
+}
+
+static vector<string> Split(const string & list) {
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) items.push_back(item);
+    return items;
+}
+
+// A --vms entry for a cluster of n machines
+static unsigned PoolSize(const string & entry, unsigned n) {
+    double value = stod(entry);
+    if (!entry.empty() && entry.back() == '%') value = value * n / 100;
+    return max(1u, unsigned(value + 0.5));
+}
+
+static BenchParams ParseArgs(int argc, char * argv[]) {
+    BenchParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--machines") {
+            params.machines.clear();
+            for (auto & item : Split(value())) params.machines.push_back(unsigned(stoul(item)));
+        } else if (arg == "--vms") {
+            params.vms = Split(value());
+        } else if (arg == "--loads") {
+            params.loads.clear();
+            for (auto & item : Split(value())) params.loads.push_back(stod(item));
+        } else if (arg == "--workload") params.workload = value();
+        else if (arg == "--bench") params.bench = value();
+        else if (arg == "--min-time") params.min_time = stod(value());
+        else if (arg == "--seed") params.seed = stoull(value());
+        else throw runtime_error("unknown option " + arg);
+    }
+    if (!params.workload.empty()) params.machines = {0};
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        BenchParams params = ParseArgs(argc, argv);
+        vector<MachineClass> workload_fleet;
+        if (!params.workload.empty()) workload_fleet = ReadWorkload(params.workload).machines;
+
+        cout << left << setw(28) << "Benchmark" << right << setw(9) << "Machines" << setw(7) << "Load"
+             << setw(6) << "VMs" << setw(8) << "Tasks" << setw(12) << "Iterations"
+             << setw(14) << "ns/op" << setw(12) << "allocs/op" << endl;
+
+        for (unsigned n : params.machines) {
+            for (auto & pool : params.vms) {
+                for (double load : params.loads) {
+                    vector<MachineClass> fleet = workload_fleet.empty() ? SyntheticFleet(n) : workload_fleet;
+                    unsigned fleet_size = 0;
+                    for (auto & mc : fleet) fleet_size += mc.count;
+                    FakeCluster_Build(fleet);
+                    SchedulerParams scheduler_params;
+                    scheduler_params.active_machines = PoolSize(pool, fleet_size);
+                    Scheduler scheduler(scheduler_params);
+                    scheduler.Init();
+
+                    vector<MachineInfo_t> active;
+                    for (unsigned m = 0; m < Machine_GetTotal(); m++) {
+                        MachineInfo_t info = Machine_GetInfo(m);
+                        if (info.s_state == S0) active.push_back(info);
+                    }
+                    if (active.empty()) throw runtime_error("Init() powered on no machines");
+                    unsigned cores = 0;
+                    for (auto & info : active) cores += info.num_cpus;
+
+                    Rng rng(DeriveSeed(params.seed, n));
+                    unsigned task_count = unsigned(load * cores);
+                    for (unsigned t = 0; t < task_count; t++) {
+                        scheduler.NewTask(0, FakeCluster_AddTask(MakeTask(rng, active[t % active.size()])));
+                    }
+                    // Tasks the scheduler has not seen, placed over and over by AssignTaskToBestVM
+                    vector<TaskId_t> probes;
+                    for (unsigned t = 0; t < 64; t++) probes.push_back(FakeCluster_AddTask(MakeTask(rng, active[t % active.size()])));
+                    FakeCluster_SetApply(false);
+
+                    struct Bench {
+                        const char * name;
+                        function<void(uint64_t)> op;
+                    };
+                    vector<Bench> benches = {
+                        {"AssignTaskToBestVM", [&](uint64_t i) { scheduler.AssignTaskToBestVM(probes[i % probes.size()]); }},
+                        {"CalculateMachineLoad", [&](uint64_t i) { scheduler.CalculateMachineLoad(active[i % active.size()].machine_id); }},
+                        {"CheckDeadlinesAndRebalance", [&](uint64_t i) { scheduler.CheckDeadlinesAndRebalance(0); }},
+                        {"PeriodicCheck", [&](uint64_t i) { scheduler.PeriodicCheck(0); }},
+                    };
+                    unsigned total = Machine_GetTotal();
+                    unsigned vm_count = FakeCluster_VMCount();
+                    for (auto & bench : benches) {
+                        if (!params.bench.empty() && params.bench != bench.name) continue;
+                        Measurement m = Measure(bench.op, params.min_time);
+                        cout << left << setw(28) << bench.name << right << setw(9) << total
+                             << setw(7) << setprecision(3) << load << setw(6) << vm_count << setw(8) << task_count
+                             << setw(12) << m.iterations << setw(14) << fixed << setprecision(1) << m.ns_per_op
+                             << setw(12) << setprecision(2) << m.allocations_per_op << endl;
+                        cout.unsetf(ios::fixed);
+                    }
+                }
+            }
+        }
+        return 0;
+    } catch (const exception & e) {
+        cerr << "microbench: " << e.what() << endl;
+        return 2;
+    }
+}
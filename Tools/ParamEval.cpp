@@ -0,0 +1,199 @@
+//
+//  ParamEval.cpp
+//  CloudSim
+//
+
+#include "ParamEval.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "Random.hpp"
+
+ParamRange ParseParamRange(const string & text) {
+    size_t equals = text.find('=');
+    size_t colon = text.find(':', equals);
+    if (equals == string::npos || colon == string::npos) throw runtime_error("expected name=lo:hi, got " + text);
+    string name = text.substr(0, equals);
+    ParamRange range;
+    range.spec = FindSchedulerParam(name);
+    if (range.spec == nullptr) throw runtime_error("unknown scheduler parameter " + name);
+    range.lo = stod(text.substr(equals + 1, colon - equals - 1));
+    range.hi = stod(text.substr(colon + 1));
+    if (range.lo > range.hi) swap(range.lo, range.hi);
+    if (range.lo < range.spec->lo || range.hi > range.spec->hi) {
+        ostringstream out;
+        out << name << ": range must lie within [" << range.spec->lo << ", " << range.spec->hi << "]";
+        throw runtime_error(out.str());
+    }
+    return range;
+}
+
+double RangeValue(const ParamRange & range, double x) {
+    double value = range.lo + x * (range.hi - range.lo);
+    return range.spec->integer ? round(value) : value;
+}
+
+SchedulerParams AtPoint(const SchedulerParams & base, const vector<ParamRange> & ranges, const vector<double> & point) {
+    SchedulerParams params = base;
+    for (size_t i = 0; i < ranges.size(); i++) params.*ranges[i].spec->field = RangeValue(ranges[i], point[i]);
+    return params;
+}
+
+vector<vector<double>> LatinHypercube(unsigned samples, unsigned dims, uint64_t seed) {
+    Rng rng(seed);
+    vector<vector<double>> points(samples, vector<double>(dims));
+    vector<unsigned> strata(samples);
+    for (unsigned d = 0; d < dims; d++) {
+        iota(strata.begin(), strata.end(), 0);
+        for (unsigned i = samples; i > 1; i--) swap(strata[i - 1], strata[rng.Range(0, i - 1)]);
+        for (unsigned i = 0; i < samples; i++) points[i][d] = (strata[i] + rng.Uniform()) / samples;
+    }
+    return points;
+}
+
+static string Number(double value) {
+    ostringstream out;
+    out << setprecision(6) << value;
+    return out.str();
+}
+
+string ParamsText(const SchedulerParams & params) {
+    string text;
+    for (unsigned i = 0; i < kSchedulerParamCount; i++) {
+        text += (i ? "," : "") + string(kSchedulerParams[i].name) + "=" + Number(params.*kSchedulerParams[i].field);
+    }
+    return text;
+}
+
+string ParamsText(const SchedulerParams & params, const vector<ParamRange> & ranges) {
+    string text;
+    for (auto & range : ranges) {
+        text += (text.empty() ? "" : ",") + string(range.spec->name) + "=" + Number(params.*range.spec->field);
+    }
+    return text;
+}
+
+uint64_t Fnv1a(const string & data, uint64_t hash) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static string FileHash(const string & filename) {
+    ifstream in(filename, ios::binary);
+    if (!in) throw runtime_error("could not read " + filename);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    char buffer[1 << 16];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        hash = Fnv1a(string(buffer, size_t(in.gcount())), hash);
+    }
+    ostringstream out;
+    out << hex << setw(16) << setfill('0') << hash;
+    return out.str();
+}
+
+ParamEvaluator::ParamEvaluator(const string & simulator, const vector<string> & workloads, const string & cache_file, unsigned parallel)
+    : simulator(simulator), workloads(workloads), cache_file(cache_file), parallel(parallel) {
+    binary_hash = FileHash(simulator);
+    for (auto & workload : workloads) workload_hashes.push_back(FileHash(workload));
+
+    ifstream in(cache_file);
+    string line;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string key, test, params, sla[3], energy, runtime, wall;
+        if (!(fields >> key >> test >> params >> sla[0] >> sla[1] >> sla[2] >> energy >> runtime >> wall)) continue;
+        SimResult & r = cache[key];
+        r.workload = test;
+        r.ok = true;
+        for (int s = 0; s < 3; s++) r.sla[s] = ParseFigure(sla[s]);
+        r.energy_kwh = stod(energy);
+        r.runtime_s = stod(runtime);
+        r.wall_s = stod(wall);
+    }
+}
+
+string ParamEvaluator::Key(size_t workload, const string & params_text) const {
+    ostringstream out;
+    out << hex << setw(16) << setfill('0') << Fnv1a(binary_hash + workload_hashes[workload] + params_text);
+    return out.str();
+}
+
+vector<vector<SimResult>> ParamEvaluator::Evaluate(const vector<SchedulerParams> & settings) {
+    vector<vector<SimResult>> results(settings.size(), vector<SimResult>(workloads.size()));
+    string dir = (filesystem::temp_directory_path() / ("paramEval." + to_string(getpid()))).string();
+    filesystem::create_directories(dir);
+
+    vector<SimJob> jobs;
+    vector<pair<size_t, size_t>> job_cells;
+    vector<string> keys;
+    map<string, size_t> queued;             // The same setting twice in one batch runs once
+    for (size_t i = 0; i < settings.size(); i++) {
+        try {
+            ValidateSchedulerParams(settings[i]);
+        } catch (const exception & e) {
+            for (size_t w = 0; w < workloads.size(); w++) {
+                results[i][w].workload = workloads[w];
+                results[i][w].error = e.what();
+            }
+            continue;
+        }
+        ostringstream text;                 // Full precision, exactly what the run reads
+        WriteSchedulerParams(text, settings[i]);
+        string params_file;
+        for (size_t w = 0; w < workloads.size(); w++) {
+            string key = Key(w, text.str());
+            auto hit = cache.find(key);
+            if (hit != cache.end()) {
+                results[i][w] = hit->second;
+                results[i][w].workload = workloads[w];
+                cached++;
+                continue;
+            }
+            if (queued.count(key)) {
+                job_cells.push_back({i, w});
+                keys.push_back(key);
+                continue;
+            }
+            if (params_file.empty()) {
+                params_file = dir + "/" + to_string(i) + ".params";
+                ofstream out(params_file);
+                WriteSchedulerParams(out, settings[i]);
+            }
+            SimJob job;
+            job.binary = simulator;
+            job.workload = workloads[w];
+            job.env.push_back("CLOUDSIM_PARAMS=" + params_file);
+            queued[key] = jobs.size();
+            jobs.push_back(job);
+            job_cells.push_back({i, w});
+            keys.push_back(key);
+        }
+    }
+
+    vector<SimResult> runs = RunJobs(jobs, parallel);
+    filesystem::remove_all(dir);
+    ran += unsigned(runs.size());
+
+    ofstream out(cache_file, ios::app);
+    for (size_t j = 0; j < job_cells.size(); j++) {
+        const SimResult & r = runs[queued[keys[j]]];
+        results[job_cells[j].first][job_cells[j].second] = r;
+        if (!r.ok || cache.count(keys[j])) continue;
+        cache[keys[j]] = r;
+        out << keys[j] << '\t' << TestName(r.workload) << '\t' << ParamsText(settings[job_cells[j].first]) << '\t'
+            << Figure(r.sla[0]) << '\t' << Figure(r.sla[1]) << '\t' << Figure(r.sla[2]) << '\t'
+            << Number(r.energy_kwh) << '\t' << Number(r.runtime_s) << '\t' << Number(r.wall_s) << endl;
+    }
+    return results;
+}
@@ -0,0 +1,79 @@
+//
+//  ParamEval.hpp
+//  CloudSim
+//
+//  Runs the simulator over a set of workloads once per scheduler parameter
+//  setting (SchedulerParams.hpp), handing each run its setting through
+//  CLOUDSIM_PARAMS, and caches the results. A cache entry is keyed by a hash
+//  of the simulator binary, of the workload file and of the full parameter
+//  setting, so rebuilding the scheduler or editing a workload invalidates
+//  exactly the runs it affects. Shared by the parameter sweep and the tuner.
+//
+//  Cache file: tab-separated, appended to, one successful run per line:
+//      key  test  params  sla0  sla1  sla2  energy_kwh  runtime_s  wall_s
+//  where params is the setting as name=value pairs separated by commas.
+//
+
+#ifndef ParamEval_hpp
+#define ParamEval_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SchedulerParams.hpp"
+#include "SimRunner.hpp"
+
+// One knob to search and the interval to search it in
+struct ParamRange {
+    const SchedulerParamSpec * spec;
+    double lo, hi;
+};
+
+// "name=lo:hi"; throws runtime_error on unknown names and ranges outside the knob's valid range
+ParamRange ParseParamRange(const string & text);
+
+// The range value at fraction x of [lo, hi], rounded for whole-number knobs
+double RangeValue(const ParamRange & range, double x);
+
+// base with every ranged knob set to its value at the matching coordinate of a unit-cube point
+SchedulerParams AtPoint(const SchedulerParams & base, const vector<ParamRange> & ranges, const vector<double> & point);
+
+// Latin-hypercube sample of the unit cube: each axis cut into 'samples' strata, each stratum used once
+vector<vector<double>> LatinHypercube(unsigned samples, unsigned dims, uint64_t seed);
+
+// "active_machines=60,pstate_p0_load=0.8,..."
+string ParamsText(const SchedulerParams & params);
+
+// Only the knobs in ranges, for tables
+string ParamsText(const SchedulerParams & params, const vector<ParamRange> & ranges);
+
+uint64_t Fnv1a(const string & data, uint64_t hash = 0xcbf29ce484222325ULL);
+
+class ParamEvaluator {
+public:
+    ParamEvaluator(const string & simulator, const vector<string> & workloads, const string & cache_file, unsigned parallel);
+
+    // results[i][w] is setting i on workload w. Cached runs are not repeated;
+    // the rest run 'parallel' at a time, settings in the order given.
+    vector<vector<SimResult>> Evaluate(const vector<SchedulerParams> & settings);
+
+    const vector<string> & Workloads() const { return workloads; }
+    unsigned Cached() const { return cached; }
+    unsigned Ran() const { return ran; }
+
+private:
+    string Key(size_t workload, const string & params_text) const;
+
+    string simulator;
+    vector<string> workloads;
+    string cache_file;
+    unsigned parallel;
+    string binary_hash;
+    vector<string> workload_hashes;
+    map<string, SimResult> cache;
+    unsigned cached = 0;
+    unsigned ran = 0;
+};
+
+#endif /* ParamEval_hpp */
@@ -0,0 +1,238 @@
+//
+//  PolicyMatrix.cpp
+//  CloudSim
+//
+//  Runs every scheduler policy on every workload and tabulates energy, SLA
+//  violations, simulated runtime, scheduler CPU time and wall time per policy
+//  and workload. The policies are the simulators built by make algos, one per
+//  Algos/*.txt variant plus the current Scheduler.cpp ("current"). Their
+//  CallbackScopes report the CPU time spent inside the scheduler's callbacks
+//  through CLOUDSIM_STATS; the variants get theirs from CallbackTimer.o. All
+//  runs go in parallel.
+//
+//  For each workload the policy with the lowest energy among those that keep
+//  every SLA class within its limit (--sla-limits, default 5,10,20) is marked
+//  best. Policies within one part in a million of that energy tie with it and
+//  are all marked, each credited with a shared win. --markdown also writes the
+//  tables as Markdown (make algos-bench writes Algos/RESULTS.md) so the
+//  README's claim about the best policy can be checked against current figures.
+//
+//  --bounds names a file of energy lower bounds (make bounds writes
+//  Test_Cases/bounds.tsv with Tools/bin/energybound), "test deadline_kwh
+//  any_kwh" per line; each energy is then also shown as a multiple of its
+//  workload's bound, the gap to the best possible. The deadline bound only
+//  holds for policies that meet every deadline, so policies with SLA
+//  violations are divided by the bound for any policy instead, marked "a".
+//
+//  A policy that cannot finish a workload in --timeout seconds (RoundRobin was
+//  written for gentlerHour and crawls through hour) is reported as such.
+//
+//  Usage: policymatrix [-j jobs] [--policy name=path ...] [--sla-limits a,b,c]
+//                      [--timeout seconds] [--bounds file] [--markdown file]
+//                      [workload.md ...]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "SimRunner.hpp"
+
+struct MatrixParams {
+    unsigned jobs = 0;
+    vector<pair<string, string>> policies;  // Name, simulator binary
+    SLALimits sla_limits;
+    unsigned timeout = 0;                   // Per run, wall seconds
+    string markdown;
+    string bounds;
+    vector<string> workloads;
+};
+
+// Relative energy difference below which two policies tie for best
+static const double kTieTolerance = 1e-6;
+
+static string Fixed(double value, int decimals) {
+    ostringstream out;
+    out << fixed << setprecision(decimals) << value;
+    return out.str();
+}
+
+struct EnergyBounds {
+    double deadline_kwh = 0;                // For policies that meet every deadline
+    double any_kwh = 0;                     // For any policy; 0 if the file predates it
+};
+
+// Test name -> lower bounds in KWh
+static map<string, EnergyBounds> ReadBounds(const string & filename) {
+    map<string, EnergyBounds> bounds;
+    if (filename.empty()) return bounds;
+    ifstream in(filename);
+    if (!in) throw runtime_error("could not read " + filename);
+    string line;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string test;
+        EnergyBounds b;
+        if (fields >> test >> b.deadline_kwh) {
+            fields >> b.any_kwh;
+            bounds[test] = b;
+        }
+    }
+    return bounds;
+}
+
+// Algos/bin/simulator-<name>, sorted by name
+static vector<pair<string, string>> BuiltPolicies() {
+    vector<pair<string, string>> policies;
+    if (!filesystem::is_directory("Algos/bin")) return policies;
+    for (auto & entry : filesystem::directory_iterator("Algos/bin")) {
+        string name = entry.path().filename().string();
+        if (name.rfind("simulator-", 0) == 0) policies.push_back({name.substr(10), entry.path().string()});
+    }
+    sort(policies.begin(), policies.end());
+    return policies;
+}
+
+static MatrixParams ParseArgs(int argc, char * argv[]) {
+    MatrixParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--policy") {
+            string text = value();
+            size_t equals = text.find('=');
+            if (equals == string::npos) throw runtime_error("--policy takes name=path, got " + text);
+            params.policies.push_back({text.substr(0, equals), text.substr(equals + 1)});
+        }
+        else if (arg == "--sla-limits") params.sla_limits.Parse(value());
+        else if (arg == "--timeout") params.timeout = unsigned(stoul(value()));
+        else if (arg == "--bounds") params.bounds = value();
+        else if (arg == "--markdown") params.markdown = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.policies.empty()) params.policies = BuiltPolicies();
+    if (params.policies.empty()) throw runtime_error("no policies; run make algos or give --policy name=path");
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        MatrixParams params = ParseArgs(argc, argv);
+        map<string, EnergyBounds> bounds = ReadBounds(params.bounds);
+        size_t policies = params.policies.size();
+
+        // Workload-major, so the long workloads of every policy start together
+        vector<SimJob> jobs;
+        for (auto & workload : params.workloads) {
+            for (auto & policy : params.policies) {
+                SimJob job;
+                job.binary = policy.second;
+                job.workload = workload;
+                job.collect_stats = true;
+                job.timeout_s = params.timeout;
+                jobs.push_back(job);
+            }
+        }
+        vector<SimResult> results = RunJobs(jobs, params.jobs);
+
+        ostringstream md;
+        md << "# Policy matrix" << endl << endl
+           << "Generated by Tools/bin/policymatrix (make algos-bench). Best (ties within 1e-6 all marked): lowest energy with SLA0 <= "
+           << params.sla_limits.percent[0] << "%, SLA1 <= " << params.sla_limits.percent[1] << "%, SLA2 <= " << params.sla_limits.percent[2] << "%." << endl;
+        map<string, unsigned> wins, shared;
+        unsigned failures = 0;
+        for (size_t w = 0; w < params.workloads.size(); w++) {
+            const SimResult * row = &results[w * policies];
+            double lowest = -1;
+            for (size_t p = 0; p < policies; p++) {
+                if (!row[p].ok || !params.sla_limits.Met(row[p])) continue;
+                if (lowest < 0 || row[p].energy_kwh < lowest) lowest = row[p].energy_kwh;
+            }
+            vector<bool> best(policies, false);
+            unsigned tied = 0;
+            for (size_t p = 0; p < policies; p++) {
+                best[p] = lowest >= 0 && row[p].ok && params.sla_limits.Met(row[p]) &&
+                          row[p].energy_kwh <= lowest * (1 + kTieTolerance);
+                tied += best[p];
+            }
+            for (size_t p = 0; p < policies; p++) {
+                if (!best[p]) continue;
+                wins[params.policies[p].first]++;
+                if (tied > 1) shared[params.policies[p].first]++;
+            }
+
+            string test = TestName(params.workloads[w]);
+            EnergyBounds bound = bounds.count(test) ? bounds[test] : EnergyBounds();
+            cout << endl << test;
+            if (bound.deadline_kwh > 0) {
+                cout << " (energy lower bound " << Figure(bound.deadline_kwh) << " KWh meeting deadlines";
+                if (bound.any_kwh > 0) cout << ", " << Figure(bound.any_kwh) << " KWh for any policy";
+                cout << ")";
+            }
+            cout << endl;
+            cout << left << setw(16) << "Policy" << right << setw(12) << "Energy" << setw(8) << "xBound" << setw(10) << "SLA0" << setw(10) << "SLA1"
+                 << setw(10) << "SLA2" << setw(10) << "Sim s" << setw(11) << "Sched CPU" << setw(8) << "Wall s" << endl;
+            md << endl << "## " << test << endl << endl;
+            if (bound.deadline_kwh > 0) {
+                md << "Energy lower bound: " << Figure(bound.deadline_kwh) << " KWh meeting every deadline";
+                if (bound.any_kwh > 0) md << ", " << Figure(bound.any_kwh) << " KWh for any policy (\"a\")";
+                md << "." << endl << endl;
+            }
+            md << "| Policy | Energy (KWh) | x Bound | SLA0 % | SLA1 % | SLA2 % | Runtime (s) | Scheduler CPU (s) | Wall (s) |" << endl
+               << "|---|---:|---:|---:|---:|---:|---:|---:|---:|" << endl;
+            for (size_t p = 0; p < policies; p++) {
+                const SimResult & r = row[p];
+                string name = params.policies[p].first;
+                if (!r.ok) {
+                    failures++;
+                    cout << left << setw(16) << name << "  FAILED: " << r.error << endl;
+                    md << "| " << name << " | failed: " << r.error << " | | | | | | | |" << endl;
+                    continue;
+                }
+                double cpu = r.stats.count("scheduler_cpu_s") ? r.stats.at("scheduler_cpu_s") : -1;
+                bool met = r.sla[0] == 0 && r.sla[1] == 0 && r.sla[2] == 0;
+                string ratio = met && bound.deadline_kwh > 0 ? Fixed(r.energy_kwh / bound.deadline_kwh, 2)
+                             : !met && bound.any_kwh > 0 ? Fixed(r.energy_kwh / bound.any_kwh, 2) + "a" : "-";
+                string mark = best[p] ? " *" : "";
+                cout << left << setw(16) << name + mark << right << setw(12) << Figure(r.energy_kwh) << setw(8) << ratio
+                     << setw(10) << Figure(r.sla[0]) << setw(10) << Figure(r.sla[1]) << setw(10) << Figure(r.sla[2])
+                     << setw(10) << Figure(r.runtime_s) << setw(11) << (cpu < 0 ? "-" : Fixed(cpu, 3))
+                     << setw(8) << Fixed(r.wall_s, 1) << endl;
+                md << "| " << (best[p] ? "**" + name + "**" : name) << " | " << Figure(r.energy_kwh) << " | " << ratio << " | "
+                   << Figure(r.sla[0]) << " | " << Figure(r.sla[1]) << " | " << Figure(r.sla[2]) << " | "
+                   << Figure(r.runtime_s) << " | " << (cpu < 0 ? "-" : Fixed(cpu, 3)) << " | " << Fixed(r.wall_s, 1) << " |" << endl;
+            }
+        }
+
+        cout << endl << "Best policy per workload (* above, ties shared):";
+        md << endl << "## Summary" << endl << endl;
+        for (auto & policy : params.policies) {
+            string ties = shared[policy.first] ? " (" + to_string(shared[policy.first]) + " shared)" : "";
+            cout << " " << policy.first << " " << wins[policy.first] << ties;
+            md << "- " << policy.first << ": best on " << wins[policy.first] << " of " << params.workloads.size() << " workloads" << ties << endl;
+        }
+        cout << endl;
+        if (!params.markdown.empty()) {
+            ofstream out(params.markdown);
+            if (!out) throw runtime_error("could not write " + params.markdown);
+            out << md.str();
+            cout << "Tables written to " << params.markdown << endl;
+        }
+        return failures ? 1 : 0;
+    } catch (const exception & e) {
+        cerr << "policymatrix: " << e.what() << endl;
+        return 2;
+    }
+}
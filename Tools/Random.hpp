@@ -0,0 +1,66 @@
+//
+//  Random.hpp
+//  CloudSim
+//
+//  Small deterministic random number generator for the tools. The standard
+//  <random> distributions are implementation defined, so a workload generated
+//  from a seed would differ between compilers; this one does not.
+//
+
+#ifndef Random_hpp
+#define Random_hpp
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state(seed) {}
+
+    // SplitMix64
+    uint64_t Next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double Uniform() {
+        return double(Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double Uniform(double lo, double hi) {
+        return lo + (hi - lo) * Uniform();
+    }
+
+    // Uniform integer in [lo, hi]
+    uint64_t Range(uint64_t lo, uint64_t hi) {
+        return lo + Next() % (hi - lo + 1);
+    }
+
+    // Index drawn proportionally to the given weights
+    size_t Pick(const std::vector<double> & weights) {
+        double total = 0;
+        for (double w : weights) total += w;
+        double x = Uniform() * total;
+        for (size_t i = 0; i < weights.size(); i++) {
+            if (x < weights[i]) return i;
+            x -= weights[i];
+        }
+        return weights.size() - 1;
+    }
+
+private:
+    uint64_t state;
+};
+
+// Derives an independent seed from a base seed and an index (replicas, sub-streams)
+inline uint64_t DeriveSeed(uint64_t seed, uint64_t index) {
+    Rng rng(seed ^ (index * 0xD1B54A32D192ED03ULL));
+    rng.Next();
+    return rng.Next();
+}
+
+#endif /* Random_hpp */
@@ -0,0 +1,167 @@
+//
+//  Replicate.cpp
+//  CloudSim
+//
+//  Runs a workload several times with different task seeds so a policy's
+//  figures come with error bars. Replica 0 keeps the workload's seeds; replica
+//  i > 0 gives every task class the seed DeriveSeed(Seed, i). Every replica,
+//  0 included, then has its classes with arrival processes expanded
+//  (Arrivals.hpp), so all of them are the same experiment. All replicas run in
+//  parallel. For each workload it prints the mean and 95% confidence
+//  interval of energy, simulated runtime and each SLA violation rate.
+//
+//  With --compare, every replica also runs on a second simulator build, on the
+//  same seeds, and a paired t-test on the per-replica differences tells whether
+//  the builds really differ. Exits 1 if any difference is significant at
+//  --alpha, so scripts can gate on it.
+//
+//  Usage: replicate [-n replicas] [-j jobs] [--simulator path] [--compare path]
+//                   [--alpha level] [workload.md ...]
+//
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "Arrivals.hpp"
+#include "Random.hpp"
+#include "SimRunner.hpp"
+#include "Stats.hpp"
+#include "Workload.hpp"
+
+struct ReplicateParams {
+    unsigned replicas = 10;
+    unsigned jobs = 0;
+    string simulator = "./simulator";
+    string compare;
+    double alpha = 0.05;
+    vector<string> workloads;
+};
+
+static const char * kMetrics[] = {"Energy KWh", "Runtime s", "SLA0 %", "SLA1 %", "SLA2 %"};
+static const int kMetricCount = 5;
+
+static double Metric(const SimResult & r, int metric) {
+    switch (metric) {
+        case 0: return r.energy_kwh;
+        case 1: return r.runtime_s;
+        default: return r.sla[metric - 2];
+    }
+}
+
+static string PlusMinus(const Estimate & e, int precision = 6) {
+    ostringstream out;
+    out << setprecision(precision) << e.mean << " +- " << setprecision(2) << e.half_width;
+    return out.str();
+}
+
+// The expanded workload for replica i, reseeded unless i is 0, written to a file in dir
+static string WriteReplica(const Workload & workload, unsigned replica, const string & dir, const string & name) {
+    Workload copy = workload;
+    if (replica > 0) {
+        for (auto & tc : copy.tasks) tc.seed = DeriveSeed(tc.seed, replica) % 1000000000;
+    }
+    ExpandWorkload(copy);
+    string filename = dir + "/" + name + "." + to_string(replica) + ".md";
+    ofstream out(filename);
+    if (!out) throw runtime_error("could not write " + filename);
+    WriteWorkload(out, copy);
+    return filename;
+}
+
+static ReplicateParams ParseArgs(int argc, char * argv[]) {
+    ReplicateParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-n") params.replicas = unsigned(stoul(value()));
+        else if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--simulator") params.simulator = value();
+        else if (arg == "--compare") params.compare = value();
+        else if (arg == "--alpha") params.alpha = stod(value());
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.replicas < 2) throw runtime_error("-n must be at least 2 for a confidence interval");
+    if (params.alpha <= 0 || params.alpha >= 1) throw runtime_error("--alpha must be in (0, 1)");
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    string dir = (filesystem::temp_directory_path() / ("replicate." + to_string(getpid()))).string();
+    try {
+        ReplicateParams params = ParseArgs(argc, argv);
+        filesystem::create_directories(dir);
+        vector<string> binaries = {params.simulator};
+        if (!params.compare.empty()) binaries.push_back(params.compare);
+
+        // jobs[((w * replicas) + r) * binaries + b]
+        vector<SimJob> jobs;
+        for (auto & workload_file : params.workloads) {
+            Workload workload = ReadWorkload(workload_file);
+            for (unsigned r = 0; r < params.replicas; r++) {
+                string file = WriteReplica(workload, r, dir, TestName(workload_file));
+                for (auto & binary : binaries) {
+                    SimJob job;
+                    job.binary = binary;
+                    job.workload = file;
+                    jobs.push_back(job);
+                }
+            }
+        }
+        vector<SimResult> results = RunJobs(jobs, params.jobs);
+        filesystem::remove_all(dir);
+
+        unsigned significant = 0;
+        size_t next = 0;
+        for (auto & workload_file : params.workloads) {
+            vector<vector<SimResult>> runs(binaries.size());
+            for (unsigned r = 0; r < params.replicas; r++) {
+                for (size_t b = 0; b < binaries.size(); b++) {
+                    const SimResult & result = results[next++];
+                    if (!result.ok) throw runtime_error(TestName(workload_file) + " replica " + to_string(r) + " on " + binaries[b] + ": " + result.error);
+                    runs[b].push_back(result);
+                }
+            }
+
+            cout << endl << TestName(workload_file) << ": " << params.replicas << " replicas, mean +- 95% CI" << endl;
+            cout << left << setw(12) << "" << setw(26) << params.simulator;
+            if (binaries.size() > 1) cout << setw(26) << params.compare << setw(26) << "Difference" << "p";
+            cout << endl;
+            for (int m = 0; m < kMetricCount; m++) {
+                vector<double> a, b;
+                for (auto & r : runs[0]) a.push_back(Metric(r, m));
+                // The simulator leaves SLA classes without tasks out of its report
+                if (a[0] < 0) continue;
+                cout << setw(12) << kMetrics[m] << setw(26) << PlusMinus(EstimateMean(a));
+                if (binaries.size() > 1) {
+                    for (auto & r : runs[1]) b.push_back(Metric(r, m));
+                    PairedTest test = PairedTTest(a, b);
+                    bool differs = test.p_value < params.alpha;
+                    if (differs) significant++;
+                    cout << setw(26) << PlusMinus(EstimateMean(b)) << setw(26) << PlusMinus(test.difference)
+                         << setprecision(3) << test.p_value << (differs ? "  SIGNIFICANT" : "");
+                }
+                cout << endl;
+            }
+        }
+        if (binaries.size() > 1) {
+            cout << endl << significant << " figures differ significantly (paired t-test, alpha " << params.alpha << ")" << endl;
+        }
+        return significant ? 1 : 0;
+    } catch (const exception & e) {
+        filesystem::remove_all(dir);
+        cerr << "replicate: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,470 @@
+//
+//  RunReport.cpp
+//  CloudSim
+//
+//  Writes one self-contained HTML file about a run, with the charts drawn as
+//  inline SVG: no scripts, stylesheets or fonts from anywhere else, so it
+//  opens offline and can be attached to a review. Each panel comes from one of
+//  the run's structured outputs and is left out when that output is not given:
+//      --telemetry run.tlm     (CLOUDSIM_TELEMETRY) cluster power and energy over
+//                              time, awake machines per CPU type, and a heatmap
+//                              of each machine's utilization (tasks over cores,
+//                              capped at 1; grey while not in S0)
+//      --trace run.trace       (CLOUDSIM_CAPTURE) per SLA, the distribution of
+//                              completion time minus target; right of zero is late
+//      --compare label=file    a suite results file (suiterunner's
+//                              suite_results.tsv, Test_Cases/baseline.tsv), once
+//                              per run to compare: energy per workload relative
+//                              to the lowest of the runs, and a table of energy
+//                              and SLA violations
+//
+//  Usage: runreport [-o report.html] [--title text] [--telemetry run.tlm]
+//                   [--trace run.trace] [--compare label=file ...]
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "CallbackTrace.hpp"
+#include "Telemetry.hpp"
+#include "Workload.hpp"
+
+struct ReportParams {
+    string output = "report.html";
+    string title = "CloudSim run report";
+    string telemetry;
+    string trace;
+    vector<pair<string, string>> compare;       // Label, file
+};
+
+static const char * kPalette[] = {"#4e79a7", "#f28e2b", "#e15759", "#76b7b2", "#59a14f", "#edc948", "#b07aa1", "#ff9da7"};
+static const unsigned kPaletteSize = 8;
+
+static string Escape(const string & text) {
+    string out;
+    for (char ch : text) {
+        switch (ch) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += ch;
+        }
+    }
+    return out;
+}
+
+static string Number(double value, int precision = 3) {
+    ostringstream out;
+    out << setprecision(precision) << value;
+    return out.str();
+}
+
+// 1, 2 or 5 times a power of ten, about range / 5
+static double NiceStep(double range) {
+    if (range <= 0) return 1;
+    double step = pow(10, floor(log10(range / 5)));
+    double ratio = range / 5 / step;
+    return step * (ratio >= 5 ? 5 : ratio >= 2 ? 2 : 1);
+}
+
+struct Series {
+    string name;
+    vector<pair<double, double>> points;
+};
+
+// Axes, grid and ticks of a plot area; maps values to pixels
+class Plot {
+public:
+    static const int kWidth = 900, kHeight = 260, kLeft = 64, kRight = 16, kTop = 28, kBottom = 40;
+
+    Plot(ostringstream & svg, const string & title, double x0, double x1, double y0, double y1,
+         const string & x_label, const string & y_label) : svg(svg), x0(x0), x1(x1 > x0 ? x1 : x0 + 1), y0(y0), y1(y1 > y0 ? y1 : y0 + 1) {
+        svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << kWidth << "\" height=\"" << kHeight << "\" viewBox=\"0 0 "
+            << kWidth << " " << kHeight << "\">\n<text x=\"" << kLeft << "\" y=\"16\" class=\"title\">" << Escape(title) << "</text>\n";
+        double step = NiceStep(this->y1 - this->y0);
+        for (double y = ceil(this->y0 / step) * step; y <= this->y1 + step * 1e-9; y += step) {
+            svg << "<line x1=\"" << kLeft << "\" x2=\"" << kWidth - kRight << "\" y1=\"" << Y(y) << "\" y2=\"" << Y(y)
+                << "\" class=\"grid\"/><text x=\"" << kLeft - 6 << "\" y=\"" << Y(y) + 4 << "\" class=\"tick\" text-anchor=\"end\">"
+                << Number(y) << "</text>\n";
+        }
+        step = NiceStep(this->x1 - this->x0);
+        for (double x = ceil(this->x0 / step) * step; x <= this->x1 + step * 1e-9; x += step) {
+            svg << "<text x=\"" << X(x) << "\" y=\"" << kHeight - kBottom + 16 << "\" class=\"tick\" text-anchor=\"middle\">" << Number(x)
+                << "</text>\n";
+        }
+        svg << "<rect x=\"" << kLeft << "\" y=\"" << kTop << "\" width=\"" << kWidth - kLeft - kRight << "\" height=\""
+            << kHeight - kTop - kBottom << "\" class=\"frame\"/>\n"
+            << "<text x=\"" << (kLeft + kWidth - kRight) / 2 << "\" y=\"" << kHeight - 6 << "\" class=\"label\" text-anchor=\"middle\">"
+            << Escape(x_label) << "</text>\n<text x=\"14\" y=\"" << (kTop + kHeight - kBottom) / 2 << "\" class=\"label\" "
+            << "text-anchor=\"middle\" transform=\"rotate(-90 14 " << (kTop + kHeight - kBottom) / 2 << ")\">" << Escape(y_label) << "</text>\n";
+    }
+
+    double X(double x) const { return kLeft + (x - x0) / (x1 - x0) * (kWidth - kLeft - kRight); }
+    double Y(double y) const { return kHeight - kBottom - (y - y0) / (y1 - y0) * (kHeight - kTop - kBottom); }
+
+    void Line(const Series & series, const string & color) {
+        svg << "<polyline fill=\"none\" stroke=\"" << color << "\" stroke-width=\"1.5\" points=\"";
+        for (auto & p : series.points) svg << Number(X(p.first), 6) << "," << Number(Y(p.second), 6) << " ";
+        svg << "\"><title>" << Escape(series.name) << "</title></polyline>\n";
+    }
+
+    void Legend(const vector<string> & names) {
+        double x = kLeft + 260;
+        for (size_t i = 0; i < names.size(); i++) {
+            svg << "<rect x=\"" << x << "\" y=\"7\" width=\"10\" height=\"10\" fill=\"" << kPalette[i % kPaletteSize] << "\"/><text x=\""
+                << x + 14 << "\" y=\"16\" class=\"tick\">" << Escape(names[i]) << "</text>\n";
+            x += 24 + 7 * names[i].size();
+        }
+    }
+
+    void End() { svg << "</svg>\n"; }
+
+private:
+    ostringstream & svg;
+    double x0, x1, y0, y1;
+};
+
+static string LineChart(const string & title, const vector<Series> & series, const string & x_label, const string & y_label) {
+    double x1 = 0, y1 = 0;
+    for (auto & s : series) {
+        for (auto & p : s.points) x1 = max(x1, p.first), y1 = max(y1, p.second);
+    }
+    ostringstream svg;
+    Plot plot(svg, title, 0, x1, 0, y1 * 1.05, x_label, y_label);
+    vector<string> names;
+    for (size_t i = 0; i < series.size(); i++) {
+        plot.Line(series[i], kPalette[i % kPaletteSize]);
+        names.push_back(series[i].name);
+    }
+    if (series.size() > 1) plot.Legend(names);
+    plot.End();
+    return svg.str();
+}
+
+// Telemetry panels
+static string TelemetrySection(const string & file) {
+    TelemetryReader reader;
+    reader.Open(file);
+    const vector<TelemetryMachine> & machines = reader.Machines();
+    size_t n = machines.size();
+    const size_t kColumns = 240;
+    uint64_t samples = reader.Samples();
+    size_t columns = size_t(max<uint64_t>(1, min<uint64_t>(samples, kColumns)));
+    // Up to 120 heatmap rows; more machines share a row
+    size_t per_row = (n + 119) / 120;
+    size_t rows = per_row ? (n + per_row - 1) / per_row : 0;
+
+    map<CPUType_t, unsigned> cpus;
+    for (auto & m : machines) cpus[m.cpu]++;
+    vector<Series> power(1), energy(1), awake;
+    power[0].name = "Power";
+    energy[0].name = "Energy";
+    for (auto & c : cpus) awake.push_back({CPUName(c.first) + " (" + to_string(c.second) + ")", {}});
+
+    vector<vector<double>> heat(rows, vector<double>(columns, 0));
+    vector<vector<unsigned>> heat_n(rows, vector<unsigned>(columns, 0));
+    vector<vector<unsigned>> heat_awake(rows, vector<unsigned>(columns, 0));
+    Time_t end = 0;
+
+    TelemetrySample sample;
+    Time_t previous_time = 0;
+    double previous_energy = 0;
+    for (uint64_t i = 0; reader.Next(sample); i++) {
+        double t = double(sample.time) / 1e6, total = 0;
+        map<CPUType_t, unsigned> up;
+        size_t column = size_t(i * columns / max<uint64_t>(samples, 1));
+        for (size_t m = 0; m < n; m++) {
+            const auto & v = sample.values[m];
+            total += double(v[TM_ENERGY]);
+            size_t row = m / per_row;
+            heat_n[row][column]++;
+            if (v[TM_S_STATE] != S0) continue;
+            up[machines[m].cpu]++;
+            heat_awake[row][column]++;
+            heat[row][column] += machines[m].cores ? min(1.0, double(v[TM_TASKS]) / machines[m].cores) : 0;
+        }
+        if (i > 0 && sample.time > previous_time) power[0].points.push_back({t, (total - previous_energy) / double(sample.time - previous_time)});
+        energy[0].points.push_back({t, total / 3.6e12});
+        size_t k = 0;
+        for (auto & c : cpus) awake[k++].points.push_back({t, double(up[c.first])});
+        previous_time = sample.time;
+        previous_energy = total;
+        end = sample.time;
+    }
+
+    // Keep each line to about a thousand points, averaging runs of samples
+    auto thin = [](Series & s) {
+        size_t step = s.points.size() / 1000 + 1;
+        if (step == 1) return;
+        vector<pair<double, double>> out;
+        for (size_t i = 0; i < s.points.size(); i += step) {
+            double x = 0, y = 0;
+            size_t j = i;
+            for (; j < min(s.points.size(), i + step); j++) x += s.points[j].first, y += s.points[j].second;
+            out.push_back({x / (j - i), y / (j - i)});
+        }
+        s.points.swap(out);
+    };
+    for (auto * list : {&power, &energy, &awake}) for (auto & s : *list) thin(s);
+
+    ostringstream html;
+    html << "<h2>Cluster over time</h2>\n<p>" << Escape(file) << ": " << n << " machines, " << samples << " samples (every "
+         << reader.Stride() << " SchedulerCheck" << (reader.Stride() > 1 ? "s" : "") << "), " << Number(double(end) / 1e6, 6) << " s, "
+         << Number(energy[0].points.empty() ? 0 : previous_energy / 3.6e12, 4) << " KWh.</p>\n";
+    html << LineChart("Cluster power", power, "simulated s", "W");
+    html << LineChart("Energy consumed", energy, "simulated s", "KWh");
+    html << LineChart("Awake machines per CPU type", awake, "simulated s", "machines in S0");
+
+    // Heatmap: one rect per cell, colour from pale (idle) to dark (every core busy)
+    const int left = 64, top = 28, width = 900 - left - 16;
+    int cell_h = rows ? max(2, min(12, 480 / int(rows))) : 2;
+    int height = top + int(rows) * cell_h + 40;
+    double cell_w = double(width) / columns;
+    html << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"900\" height=\"" << height << "\" viewBox=\"0 0 900 " << height << "\">\n"
+         << "<text x=\"" << left << "\" y=\"16\" class=\"title\">Utilization per machine" << (per_row > 1 ? " (" + to_string(per_row) + " machines per row)" : "")
+         << ", grey while not in S0</text>\n";
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < columns; c++) {
+            string fill;
+            if (heat_n[r][c] == 0) continue;
+            if (heat_awake[r][c] == 0) fill = "#d9d9d9";
+            else {
+                double u = heat[r][c] / heat_awake[r][c];
+                int red = int(247 - u * (247 - 8)), green = int(251 - u * (251 - 48)), blue = int(255 - u * (255 - 107));
+                ostringstream colour;
+                colour << "rgb(" << red << "," << green << "," << blue << ")";
+                fill = colour.str();
+            }
+            html << "<rect x=\"" << Number(left + c * cell_w, 6) << "\" y=\"" << top + int(r) * cell_h << "\" width=\"" << Number(cell_w + 0.3, 4)
+                 << "\" height=\"" << cell_h << "\" fill=\"" << fill << "\"/>";
+        }
+        html << "\n";
+    }
+    html << "<text x=\"" << left - 6 << "\" y=\"" << top + 10 << "\" class=\"tick\" text-anchor=\"end\">0</text>"
+         << "<text x=\"" << left - 6 << "\" y=\"" << top + int(rows) * cell_h << "\" class=\"tick\" text-anchor=\"end\">" << (n ? n - 1 : 0) << "</text>"
+         << "<text x=\"" << left << "\" y=\"" << top + int(rows) * cell_h + 16 << "\" class=\"tick\">0 s</text>"
+         << "<text x=\"" << left + width << "\" y=\"" << top + int(rows) * cell_h + 16 << "\" class=\"tick\" text-anchor=\"end\">"
+         << Number(double(end) / 1e6, 6) << " s</text>"
+         << "<text x=\"" << left + width / 2 << "\" y=\"" << top + int(rows) * cell_h + 32 << "\" class=\"label\" text-anchor=\"middle\">"
+         << "machine (rows) over simulated time; darker is busier</text>\n</svg>\n";
+    return html.str();
+}
+
+// Lateness histograms from a callback trace
+static string LatenessSection(const string & file) {
+    TraceReader trace;
+    trace.Open(file);
+    vector<TaskInfo_t> tasks;
+    vector<Time_t> completion;
+    TraceEvent e;
+    while (trace.Next(e)) {
+        if (e.kind == TraceEvent::CALL && e.call == CALL_GET_TASK_INFO) {
+            if (e.task.task_id >= tasks.size()) tasks.resize(e.task.task_id + 1), completion.resize(e.task.task_id + 1, 0);
+            tasks[e.task.task_id] = e.task;
+        } else if (e.kind == TraceEvent::BEGIN && e.callback == CB_TASK_COMPLETION) {
+            if (e.subject >= completion.size()) tasks.resize(e.subject + 1), completion.resize(e.subject + 1, 0);
+            completion[e.subject] = e.time;
+        }
+    }
+
+    ostringstream html;
+    html << "<h2>SLA lateness</h2>\n<p>" << Escape(file) << ": completion time minus target per task; bars right of the red line "
+         << "finished late.</p>\n<table><tr><th>SLA</th><th>Tasks</th><th>Late</th><th>Unfinished</th><th>Median s</th><th>p95 s</th><th>Max s</th></tr>\n";
+    ostringstream charts;
+    for (unsigned s = SLA0; s < NUM_SLAS; s++) {
+        vector<double> lateness;
+        unsigned count = 0, unfinished = 0, late = 0;
+        for (size_t t = 0; t < tasks.size(); t++) {
+            if (tasks[t].target_completion == 0 || tasks[t].required_sla != s) continue;
+            count++;
+            if (completion[t] == 0) {
+                unfinished++;
+                continue;
+            }
+            double d = (double(completion[t]) - double(tasks[t].target_completion)) / 1e6;
+            if (d > 0) late++;
+            lateness.push_back(d);
+        }
+        if (count == 0) continue;
+        sort(lateness.begin(), lateness.end());
+        auto at = [&](double q) { return lateness.empty() ? 0 : lateness[min(lateness.size() - 1, size_t(q * lateness.size()))]; };
+        html << "<tr><td>" << SLAName(SLAType_t(s)) << "</td><td>" << count << "</td><td>" << late << " (" << Number(100.0 * late / count, 3)
+             << "%)</td><td>" << unfinished << "</td><td>" << Number(at(0.5)) << "</td><td>" << Number(at(0.95)) << "</td><td>"
+             << Number(lateness.empty() ? 0 : lateness.back()) << "</td></tr>\n";
+        if (lateness.empty()) continue;
+
+        const unsigned kBins = 50;
+        double lo = min(0.0, lateness.front()), hi = max(0.0, lateness.back());
+        if (hi <= lo) hi = lo + 1;
+        vector<unsigned> bins(kBins, 0);
+        for (double d : lateness) bins[min(kBins - 1, unsigned((d - lo) / (hi - lo) * kBins))]++;
+        unsigned most = *max_element(bins.begin(), bins.end());
+        Plot plot(charts, SLAName(SLAType_t(s)) + ": " + to_string(lateness.size()) + " completed tasks", lo, hi, 0, most * 1.05,
+                  "completion - target (s)", "tasks");
+        double w = (hi - lo) / kBins;
+        for (unsigned b = 0; b < kBins; b++) {
+            if (bins[b] == 0) continue;
+            double x = lo + b * w;
+            charts << "<rect x=\"" << Number(plot.X(x), 6) << "\" y=\"" << Number(plot.Y(bins[b]), 6) << "\" width=\""
+                   << Number(max(1.0, plot.X(x + w) - plot.X(x) - 1), 4) << "\" height=\"" << Number(plot.Y(0) - plot.Y(bins[b]), 6)
+                   << "\" fill=\"" << (x >= 0 ? kPalette[2] : kPalette[0]) << "\"><title>" << Number(x) << " to "
+                   << Number(x + w) << " s: " << bins[b] << "</title></rect>";
+        }
+        charts << "\n<line x1=\"" << plot.X(0) << "\" x2=\"" << plot.X(0) << "\" y1=\"" << plot.Y(0) << "\" y2=\"" << plot.Y(most * 1.05)
+               << "\" stroke=\"#c00\" stroke-width=\"1.5\"/>\n";
+        plot.End();
+    }
+    html << "</table>\n" << charts.str();
+    return html.str();
+}
+
+// Suite results of several runs side by side
+static string CompareSection(const vector<pair<string, string>> & runs) {
+    struct Result {
+        bool ok = false;
+        double sla[3] = {};
+        double energy = 0;
+    };
+    vector<map<string, Result>> results;
+    vector<string> tests;
+    for (auto & run : runs) {
+        ifstream in(run.second);
+        if (!in) throw runtime_error("could not read " + run.second);
+        map<string, Result> table;
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            istringstream fields(line);
+            string test, status;
+            Result r;
+            if (!(fields >> test >> status >> r.sla[0] >> r.sla[1] >> r.sla[2] >> r.energy)) continue;
+            r.ok = status == "ok";
+            table[test] = r;
+            if (find(tests.begin(), tests.end(), test) == tests.end()) tests.push_back(test);
+        }
+        results.push_back(table);
+    }
+
+    ostringstream html;
+    html << "<h2>Policy comparison</h2>\n<p>Energy per workload relative to the lowest of the runs (1 is the lowest); "
+         << "the table has the figures.</p>\n";
+    // Grouped horizontal bars, one group per workload
+    const int left = 130, bar = 10, group = bar * int(runs.size()) + 8, width = 900 - left - 60;
+    int height = 40 + group * int(tests.size()) + 20;
+    double most = 1;
+    vector<double> best(tests.size(), 0);
+    for (size_t t = 0; t < tests.size(); t++) {
+        for (auto & table : results) {
+            auto r = table.find(tests[t]);
+            if (r == table.end() || !r->second.ok || r->second.energy <= 0) continue;
+            if (best[t] == 0 || r->second.energy < best[t]) best[t] = r->second.energy;
+        }
+        for (auto & table : results) {
+            auto r = table.find(tests[t]);
+            if (r != table.end() && r->second.ok && best[t] > 0) most = max(most, r->second.energy / best[t]);
+        }
+    }
+    html << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"900\" height=\"" << height << "\" viewBox=\"0 0 900 " << height << "\">\n";
+    double x = left;
+    for (size_t i = 0; i < runs.size(); i++) {
+        html << "<rect x=\"" << x << "\" y=\"7\" width=\"10\" height=\"10\" fill=\"" << kPalette[i % kPaletteSize] << "\"/><text x=\""
+             << x + 14 << "\" y=\"16\" class=\"tick\">" << Escape(runs[i].first) << "</text>\n";
+        x += 24 + 7 * runs[i].first.size();
+    }
+    for (size_t t = 0; t < tests.size(); t++) {
+        int y = 32 + group * int(t);
+        html << "<text x=\"" << left - 6 << "\" y=\"" << y + group / 2 << "\" class=\"tick\" text-anchor=\"end\">" << Escape(tests[t]) << "</text>\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            auto r = results[i].find(tests[t]);
+            if (r == results[i].end()) continue;
+            int by = y + bar * int(i);
+            if (!r->second.ok || best[t] <= 0) {
+                html << "<text x=\"" << left + 4 << "\" y=\"" << by + bar - 1 << "\" class=\"tick\">failed</text>\n";
+                continue;
+            }
+            double ratio = r->second.energy / best[t];
+            html << "<rect x=\"" << left << "\" y=\"" << by << "\" width=\"" << Number(ratio / most * width, 6) << "\" height=\"" << bar - 1
+                 << "\" fill=\"" << kPalette[i % kPaletteSize] << "\"><title>" << Escape(runs[i].first) << ": " << r->second.energy
+                 << " KWh</title></rect><text x=\"" << Number(left + ratio / most * width + 4, 6) << "\" y=\"" << by + bar - 1
+                 << "\" class=\"tick\">" << Number(ratio) << "</text>\n";
+        }
+    }
+    html << "</svg>\n<table><tr><th>Workload</th>";
+    for (auto & run : runs) html << "<th>" << Escape(run.first) << " KWh</th><th>SLA0/1/2 %</th>";
+    html << "</tr>\n";
+    for (size_t t = 0; t < tests.size(); t++) {
+        html << "<tr><td>" << Escape(tests[t]) << "</td>";
+        for (auto & table : results) {
+            auto r = table.find(tests[t]);
+            if (r == table.end()) html << "<td></td><td></td>";
+            else if (!r->second.ok) html << "<td>failed</td><td></td>";
+            else {
+                html << "<td" << (r->second.energy == best[t] ? " class=\"best\"" : "") << ">" << Number(r->second.energy, 4) << "</td><td>"
+                     << Number(r->second.sla[0]) << " / " << Number(r->second.sla[1]) << " / " << Number(r->second.sla[2]) << "</td>";
+            }
+        }
+        html << "</tr>\n";
+    }
+    html << "</table>\n";
+    return html.str();
+}
+
+static ReportParams ParseArgs(int argc, char * argv[]) {
+    ReportParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-o") params.output = value();
+        else if (arg == "--title") params.title = value();
+        else if (arg == "--telemetry") params.telemetry = value();
+        else if (arg == "--trace") params.trace = value();
+        else if (arg == "--compare") {
+            string spec = value();
+            size_t equals = spec.find('=');
+            if (equals == string::npos || equals == 0) throw runtime_error("--compare takes label=file");
+            params.compare.push_back({spec.substr(0, equals), spec.substr(equals + 1)});
+        }
+        else throw runtime_error("unknown argument " + arg);
+    }
+    if (params.telemetry.empty() && params.trace.empty() && params.compare.empty()) {
+        throw runtime_error("usage: runreport [-o report.html] [--title text] [--telemetry run.tlm] [--trace run.trace] [--compare label=file ...]");
+    }
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        ReportParams params = ParseArgs(argc, argv);
+        string body;
+        if (!params.telemetry.empty()) body += TelemetrySection(params.telemetry);
+        if (!params.trace.empty()) body += LatenessSection(params.trace);
+        if (!params.compare.empty()) body += CompareSection(params.compare);
+
+        ofstream out(params.output);
+        if (!out) throw runtime_error("could not write " + params.output);
+        out << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>" << Escape(params.title) << "</title>\n<style>\n"
+            << "body { font: 14px sans-serif; margin: 24px; color: #222; max-width: 940px; }\n"
+            << "svg { display: block; margin: 12px 0; }\n"
+            << ".title { font-size: 13px; font-weight: bold; } .tick { font-size: 11px; fill: #444; } .label { font-size: 11px; fill: #666; }\n"
+            << ".grid { stroke: #e5e5e5; } .frame { fill: none; stroke: #999; }\n"
+            << "table { border-collapse: collapse; margin: 8px 0; } td, th { border: 1px solid #ccc; padding: 3px 8px; text-align: right; }\n"
+            << "td:first-child, th:first-child { text-align: left; } .best { font-weight: bold; background: #e8f4e8; }\n"
+            << "</style></head><body>\n<h1>" << Escape(params.title) << "</h1>\n" << body << "</body></html>\n";
+        out.close();
+        cout << "Wrote " << params.output << endl;
+        return 0;
+    } catch (const exception & e) {
+        cerr << "runreport: " << e.what() << endl;
+        return 2;
+    }
+}
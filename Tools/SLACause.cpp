@@ -0,0 +1,415 @@
+//
+//  SLACause.cpp
+//  CloudSim
+//
+//  Explains the SLA violations of a run. The input is a callback trace
+//  (CLOUDSIM_CAPTURE), replayed through ClusterMirror; from it the analyzer
+//  rebuilds, for every task, when it arrived and was placed, the machines it
+//  ran on, their S-states and P-states and how many tasks shared them, any
+//  wait for a machine to wake and any migration. A task is late when it
+//  completes after its target_completion, or never completes; SLA3 is best
+//  effort and never late.
+//
+//  Each task's time beyond running alone at P0 is split into causes:
+//      queueing        more tasks than cores on its machine, at the share it lost
+//      low P-state     the machine running below P0, at the speed it lost
+//      late wake-up    the machine not in S0 (asleep or changing state)
+//      migration       its VM being migrated
+//      placement delay from arrival until it first ran
+//      never placed    never added to a VM (all of its lateness)
+//  A late task's lateness is divided over its causes in proportion to the time
+//  each cost it; its main cause is the largest. The report ranks the causes by
+//  the lateness they account for, overall and per SLA.
+//
+//  The speed model is the one the scheduler uses: MIPS at the P-state over MIPS
+//  at P0, times cores over tasks when a machine has more tasks than cores.
+//
+//  Usage: slacause [--tasks n] [--task id] [--csv file] run.trace
+//      --tasks n   list the n latest tasks with their breakdown (default 10)
+//      --task id   print that task's history: placement and, while it ran, every
+//                  change of its machine's S-state, P-state and task count
+//      --csv file  one row per late task
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "ClusterMirror.hpp"
+
+typedef enum {
+    CAUSE_QUEUEING,
+    CAUSE_PSTATE,
+    CAUSE_WAKE,
+    CAUSE_MIGRATION,
+    CAUSE_PLACEMENT,
+    CAUSE_NEVER_PLACED
+} Cause_t;
+#define NUM_CAUSES 6
+
+static const char * kCauseNames[NUM_CAUSES] = {"queueing on an overloaded host", "low P-state", "late wake-up",
+                                               "migration delay", "placement delay", "never placed"};
+static const char * kCauseKeys[NUM_CAUSES] = {"queueing", "pstate", "wake", "migration", "placement", "never_placed"};
+
+struct CauseParams {
+    unsigned tasks = 10;
+    long watch = -1;
+    string csv;
+    string trace;
+};
+
+// Time each task on a machine has lost so far per cause, per task on it (seconds)
+struct Lost {
+    double queueing = 0, pstate = 0, wake = 0;
+};
+
+// Losses of the tasks on a machine, brought up to date on every change to it
+struct Meter {
+    Time_t since = 0;
+    Lost lost;
+};
+
+struct Job {
+    bool known = false;
+    SLAType_t sla = SLA3;
+    Time_t arrival = 0, target = 0, completion = 0;
+    bool completed = false;
+    bool placed = false;
+    Time_t placed_time = 0;
+    bool ran = false;
+    bool running = false;                   // On a machine
+    MachineId_t host = 0;
+    MachineId_t first_host = 0;
+    Lost at_join;                           // The host's Lost when the task joined it
+    bool waiting = false;                   // In a VM that is not attached
+    Time_t waiting_since = 0;
+    Time_t migrating_since = 0;
+    bool migrating = false;
+    unsigned most_sharing = 0;              // Most tasks on its machine while it ran
+    double lost[NUM_CAUSES] = {};           // Seconds
+};
+
+class Analyzer : public ClusterMirror {
+public:
+    Analyzer(const CauseParams & params) : params(params) {}
+
+    void Finish();
+
+protected:
+    void Before(const TraceEvent & e) override {
+        if (e.kind == TraceEvent::BEGIN && e.callback == CB_MIGRATION_DONE) {
+            if (!GetVM(e.subject).migrating) return;
+            for (TaskId_t task : GetVM(e.subject).tasks) {
+                Job & job = GetJob(task);
+                if (job.migrating) job.lost[CAUSE_MIGRATION] += Seconds(now - job.migrating_since);
+                job.migrating = false;
+            }
+        } else if (e.kind == TraceEvent::CALL && e.call == CALL_VM_ADD_TASK) {
+            const MirrorVM & vm = GetVM(e.args[0]);
+            TaskId_t task_id = e.args[1];
+            Job & job = GetJob(task_id);
+            if (!job.placed) {
+                job.placed = true;
+                job.placed_time = now;
+                if (job.known && now > job.arrival) job.lost[CAUSE_PLACEMENT] += Seconds(now - job.arrival);
+            }
+            Watch(task_id, "added to VM " + to_string(e.args[0]) + (vm.attached ? " on machine " + to_string(vm.machine) : ", not attached"));
+            if (vm.migrating) {
+                job.migrating = true;
+                job.migrating_since = now;
+            } else if (!vm.attached) {
+                job.waiting = true;
+                job.waiting_since = now;
+            }
+        }
+    }
+
+    void After(const TraceEvent & e) override {
+        if (e.kind == TraceEvent::BEGIN) {
+            if (e.callback != CB_TASK_COMPLETION) return;
+            Job & job = GetJob(e.subject);
+            job.completed = true;
+            job.completion = now;
+            Watch(e.subject, "completes" + (job.sla != SLA3 && now > job.target ? ", " + Format(Seconds(now - job.target)) + " s late" : string()));
+            return;
+        }
+        switch (e.call) {
+            case CALL_GET_TASK_INFO: {
+                Job & job = GetJob(e.task.task_id);
+                if (job.known) break;
+                job.known = true;
+                job.sla = e.task.required_sla;
+                job.arrival = e.task.arrival;
+                job.target = e.task.target_completion;
+                Watch(e.task.task_id, "arrives, " + SLAName(job.sla) + ", target " + Format(Seconds(job.target)) + " s");
+                break;
+            }
+            case CALL_VM_REMOVE_TASK:
+                Watch(e.args[1], "removed from VM " + to_string(e.args[0]));
+                break;
+            case CALL_VM_MIGRATE:
+                for (TaskId_t task : GetVM(e.args[0]).tasks) {
+                    Job & job = GetJob(task);
+                    job.migrating = true;
+                    job.migrating_since = now;
+                    Watch(task, "VM " + to_string(e.args[0]) + " migrates to machine " + to_string(e.args[1]));
+                }
+                break;
+            default: break;
+        }
+    }
+
+    void Changing(MachineId_t machine_id) override { Advance(machine_id); }
+
+    void Joined(TaskId_t task_id, MachineId_t machine_id) override {
+        Job & job = GetJob(task_id);
+        if (job.waiting) job.lost[CAUSE_PLACEMENT] += Seconds(now - job.waiting_since);
+        job.waiting = false;
+        if (!job.ran) job.first_host = machine_id;
+        job.ran = true;
+        job.running = true;
+        job.host = machine_id;
+        job.at_join = GetMeter(machine_id).lost;
+        const MirrorMachine & m = GetMachine(machine_id);
+        for (TaskId_t other : m.tasks) {
+            Job & o = GetJob(other);
+            o.most_sharing = max(o.most_sharing, unsigned(m.tasks.size()));
+        }
+        Watch(task_id, "runs on machine " + to_string(machine_id));
+    }
+
+    void Left(TaskId_t task_id, MachineId_t machine_id, const string &) override {
+        Job & job = GetJob(task_id);
+        const Lost & lost = GetMeter(machine_id).lost;
+        job.lost[CAUSE_QUEUEING] += lost.queueing - job.at_join.queueing;
+        job.lost[CAUSE_PSTATE] += lost.pstate - job.at_join.pstate;
+        job.lost[CAUSE_WAKE] += lost.wake - job.at_join.wake;
+        job.running = false;
+    }
+
+    // With --task, notes each change of the machine the watched task runs on
+    void Changed(MachineId_t machine_id) override {
+        if (params.watch < 0 || size_t(params.watch) >= jobs.size()) return;
+        const Job & job = jobs[params.watch];
+        if (!job.running || job.host != machine_id) return;
+        const MirrorMachine & m = GetMachine(machine_id);
+        string state = "S" + to_string(m.s_state) + (m.transition ? "->S" + to_string(m.pending) : "");
+        Watch(TaskId_t(params.watch), "machine " + to_string(machine_id) + ": " + state + ", P" + to_string(m.p_state) + ", " +
+              to_string(m.tasks.size()) + " tasks on " + to_string(max(1u, m.cores)) + " cores");
+    }
+
+private:
+    Job & GetJob(TaskId_t id) {
+        if (id >= jobs.size()) jobs.resize(id + 1);
+        return jobs[id];
+    }
+    Meter & GetMeter(MachineId_t id) {
+        if (id >= meters.size()) meters.resize(id + 1);
+        return meters[id];
+    }
+
+    static double Seconds(Time_t t) { return double(t) / 1e6; }
+    static string Format(double s) {
+        ostringstream out;
+        out << fixed << setprecision(3) << s;
+        return out.str();
+    }
+
+    // Brings the machine's per-task losses up to now under its current state
+    void Advance(MachineId_t machine_id) {
+        Meter & meter = GetMeter(machine_id);
+        const MirrorMachine & m = GetMachine(machine_id);
+        double dt = Seconds(now - meter.since);
+        meter.since = now;
+        if (dt <= 0 || m.tasks.empty()) return;
+        if (m.s_state != S0 || m.transition) {
+            meter.lost.wake += dt;
+            return;
+        }
+        unsigned cores = max(1u, m.cores);
+        double ratio = m.p_state < m.mips.size() && m.mips[0] ? double(m.mips[m.p_state]) / m.mips[0] : 1;
+        double share = m.tasks.size() > cores ? double(cores) / m.tasks.size() : 1;
+        meter.lost.pstate += dt * (1 - ratio);
+        meter.lost.queueing += dt * ratio * (1 - share);
+    }
+
+    void Watch(TaskId_t task_id, const string & what) {
+        if (params.watch < 0 || TaskId_t(params.watch) != task_id) return;
+        history.push_back(Format(Seconds(now)) + " s  " + what);
+    }
+
+    const CauseParams & params;
+    vector<Job> jobs;
+    vector<Meter> meters;
+    vector<string> history;
+};
+
+void Analyzer::Finish() {
+    StopAll();
+
+    // Per late task: lateness, its split over the causes, and the main cause
+    struct Late {
+        TaskId_t task;
+        double lateness;
+        double share[NUM_CAUSES];
+        Cause_t cause;
+    };
+    vector<Late> late;
+    unsigned tasks[NUM_SLAS] = {}, missed[NUM_SLAS] = {};
+    for (TaskId_t t = 0; t < jobs.size(); t++) {
+        Job & job = jobs[t];
+        if (!job.known) continue;
+        tasks[job.sla]++;
+        if (job.sla == SLA3) continue;
+        Time_t end = job.completed ? job.completion : now;
+        if (job.completed && end <= job.target) continue;
+        missed[job.sla]++;
+        Late l = {t, end > job.target ? Seconds(end - job.target) : 0, {}, CAUSE_NEVER_PLACED};
+        if (!job.placed) {
+            job.lost[CAUSE_NEVER_PLACED] = Seconds(end - job.arrival);
+        } else if (job.migrating) {
+            job.lost[CAUSE_MIGRATION] += Seconds(now - job.migrating_since);
+        }
+        double total = 0;
+        for (unsigned c = 0; c < NUM_CAUSES; c++) total += job.lost[c];
+        for (unsigned c = 0; c < NUM_CAUSES; c++) {
+            l.share[c] = total > 0 ? l.lateness * job.lost[c] / total : 0;
+            if (job.lost[c] > job.lost[l.cause]) l.cause = Cause_t(c);
+        }
+        // Late with no time lost in the model: its target was shorter than it takes alone at P0
+        if (total <= 0) l.cause = CAUSE_PLACEMENT, l.share[CAUSE_PLACEMENT] = 0;
+        late.push_back(l);
+    }
+
+    unsigned all = 0, all_missed = 0;
+    for (unsigned s = SLA0; s < SLA3; s++) all += tasks[s], all_missed += missed[s];
+    cout << params.trace << ": " << all << " tasks with an SLA, " << all_missed << " late";
+    for (unsigned s = SLA0; s < SLA3; s++) {
+        if (tasks[s] == 0) continue;
+        cout << "; " << SLAName(SLAType_t(s)) << " " << missed[s] << " of " << tasks[s] << " (" << fixed << setprecision(2)
+             << 100.0 * missed[s] / tasks[s] << "%)";
+        cout.unsetf(ios::fixed);
+    }
+    cout << endl;
+    if (late.empty()) return;
+
+    // Causes by the lateness they account for
+    double by_cause[NUM_CAUSES] = {}, by_sla[NUM_CAUSES][NUM_SLAS] = {}, sla_total[NUM_SLAS] = {}, total = 0;
+    unsigned main_cause[NUM_CAUSES] = {};
+    unsigned unexplained = 0;
+    for (auto & l : late) {
+        SLAType_t sla = jobs[l.task].sla;
+        double explained = 0;
+        for (unsigned c = 0; c < NUM_CAUSES; c++) {
+            by_cause[c] += l.share[c];
+            by_sla[c][sla] += l.share[c];
+            sla_total[sla] += l.share[c];
+            explained += l.share[c];
+        }
+        total += explained;
+        if (explained > 0) main_cause[l.cause]++;
+        else unexplained++;
+    }
+    vector<unsigned> order;
+    for (unsigned c = 0; c < NUM_CAUSES; c++) order.push_back(c);
+    stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return by_cause[a] > by_cause[b]; });
+
+    cout << endl << left << setw(32) << "Cause" << right << setw(8) << "Tasks" << setw(12) << "Late s" << setw(9) << "Share";
+    for (unsigned s = SLA0; s < SLA3; s++) if (missed[s]) cout << setw(8) << SLAName(SLAType_t(s));
+    cout << endl;
+    for (unsigned c : order) {
+        if (by_cause[c] <= 0 && main_cause[c] == 0) continue;
+        cout << left << setw(32) << kCauseNames[c] << right << setw(8) << main_cause[c] << fixed << setprecision(1) << setw(12)
+             << by_cause[c] << setw(8) << (total > 0 ? 100 * by_cause[c] / total : 0) << "%";
+        for (unsigned s = SLA0; s < SLA3; s++) {
+            if (missed[s]) cout << setw(7) << (sla_total[s] > 0 ? 100 * by_sla[c][s] / sla_total[s] : 0) << "%";
+        }
+        cout << endl;
+        cout.unsetf(ios::fixed);
+    }
+    if (unexplained) cout << unexplained << " late tasks lost no time in the model (their target is shorter than running alone at P0)" << endl;
+    cout << "Tasks: late tasks whose main cause it is. Late s: lateness it accounts for. Per SLA: share of that SLA's lateness." << endl;
+
+    sort(late.begin(), late.end(), [](const Late & a, const Late & b) { return a.lateness > b.lateness; });
+    if (params.tasks) {
+        cout << endl << "Latest tasks (seconds lost per cause)" << endl;
+        cout << right << setw(7) << "Task" << setw(6) << "SLA" << setw(9) << "Machine" << setw(10) << "Placed" << setw(9) << "Late"
+             << setw(10) << "Queueing" << setw(9) << "P-state" << setw(8) << "Wake" << setw(8) << "Migr" << setw(8) << "Place"
+             << setw(8) << "Shared" << "  Main cause" << endl;
+        for (size_t i = 0; i < late.size() && i < params.tasks; i++) {
+            const Late & l = late[i];
+            const Job & job = jobs[l.task];
+            cout << setw(7) << l.task << setw(6) << SLAName(job.sla);
+            if (job.ran) cout << setw(9) << job.first_host;
+            else cout << setw(9) << "-";
+            if (job.placed) cout << fixed << setprecision(3) << setw(10) << Seconds(job.placed_time);
+            else cout << setw(10) << "-";
+            cout << fixed << setprecision(3) << setw(9) << l.lateness;
+            for (unsigned c = CAUSE_QUEUEING; c <= CAUSE_PLACEMENT; c++) cout << setprecision(c == CAUSE_QUEUEING ? 3 : 2) << setw(c == CAUSE_QUEUEING ? 10 : c == CAUSE_PSTATE ? 9 : 8) << job.lost[c];
+            cout << setw(8) << job.most_sharing << "  " << kCauseNames[l.cause] << endl;
+            cout.unsetf(ios::fixed);
+        }
+    }
+
+    if (!params.csv.empty()) {
+        ofstream csv(params.csv);
+        if (!csv) throw runtime_error("could not write " + params.csv);
+        csv << "task,sla,arrival_s,target_s,end_s,completed,placed_s,first_machine,most_sharing,lateness_s,main_cause";
+        for (auto key : kCauseKeys) csv << ",lost_" << key << "_s";
+        for (auto key : kCauseKeys) csv << ",late_" << key << "_s";
+        csv << endl;
+        for (auto & l : late) {
+            const Job & job = jobs[l.task];
+            csv << l.task << "," << SLAName(job.sla) << "," << Seconds(job.arrival) << "," << Seconds(job.target) << ","
+                << Seconds(job.completed ? job.completion : now) << "," << job.completed << ",";
+            if (job.placed) csv << Seconds(job.placed_time);
+            csv << ",";
+            if (job.ran) csv << job.first_host;
+            csv << "," << job.most_sharing << "," << l.lateness << "," << kCauseKeys[l.cause];
+            for (unsigned c = 0; c < NUM_CAUSES; c++) csv << "," << job.lost[c];
+            for (unsigned c = 0; c < NUM_CAUSES; c++) csv << "," << l.share[c];
+            csv << endl;
+        }
+    }
+
+    if (params.watch >= 0) {
+        cout << endl << "Task " << params.watch << endl;
+        if (history.empty()) cout << "  not in the trace" << endl;
+        for (auto & line : history) cout << "  " << line << endl;
+    }
+}
+
+static CauseParams ParseArgs(int argc, char * argv[]) {
+    CauseParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--tasks") params.tasks = stoul(value());
+        else if (arg == "--task") params.watch = stol(value());
+        else if (arg == "--csv") params.csv = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (params.trace.empty()) params.trace = arg;
+        else throw runtime_error("one trace at a time");
+    }
+    if (params.trace.empty()) throw runtime_error("usage: slacause [--tasks n] [--task id] [--csv file] run.trace");
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        CauseParams params = ParseArgs(argc, argv);
+        Analyzer analyzer(params);
+        analyzer.Replay(params.trace);
+        analyzer.Finish();
+        return 0;
+    } catch (const exception & e) {
+        cerr << "slacause: " << e.what() << endl;
+        return 2;
+    }
+}
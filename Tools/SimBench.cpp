@@ -0,0 +1,204 @@
+//
+//  SimBench.cpp
+//  CloudSim
+//
+//  Measures how fast the simulator and scheduler run, as opposed to how good
+//  the schedule is. Each workload runs several times, one run at a time so the
+//  runs do not compete for cores, and the median run is reported:
+//      wall time, simulated seconds per wall second, events (callbacks delivered
+//      to the scheduler, from CLOUDSIM_STATS) per wall second, and peak RSS.
+//  Every workload's figures are appended as one JSON line to a history file,
+//  tagged with the commit and a label, and compared with the previous line for
+//  the same workload so slowdowns show up as they happen.
+//
+//  Usage: simbench [-n runs] [--history file] [--label text] [--threshold percent]
+//                  [--simulator path] [workload.md ...]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "SimRunner.hpp"
+
+struct BenchParams {
+    unsigned runs = 3;
+    string history = "bench_history.jsonl";
+    string label;
+    double threshold = 10;                  // Percent slower than the last entry worth flagging
+    string simulator = "./simulator";
+    vector<string> workloads;
+};
+
+struct BenchEntry {
+    string workload;
+    double wall_s;                          // Median run
+    double wall_min_s;
+    double wall_max_s;
+    double user_s;                          // Of the median run
+    double sim_s;
+    double events;
+    long max_rss_kb;                        // Largest over the runs
+};
+
+static string Escape(const string & text) {
+    string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+static string Command(const string & command) {
+    string out;
+    FILE * pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) return out;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe)) out += buffer;
+    pclose(pipe);
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) out.pop_back();
+    return out;
+}
+
+static string JsonLine(const BenchEntry & e, const string & commit, const string & label, unsigned runs) {
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    char timestamp[32];
+    time_t now = time(nullptr);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    ostringstream out;
+    out << setprecision(6)
+        << "{\"timestamp\":\"" << timestamp << "\",\"commit\":\"" << Escape(commit)
+        << "\",\"label\":\"" << Escape(label) << "\",\"host\":\"" << Escape(host)
+        << "\",\"workload\":\"" << Escape(e.workload) << "\",\"runs\":" << runs
+        << ",\"wall_s\":" << e.wall_s << ",\"wall_min_s\":" << e.wall_min_s << ",\"wall_max_s\":" << e.wall_max_s
+        << ",\"user_s\":" << e.user_s << ",\"sim_s\":" << e.sim_s
+        << ",\"sim_per_wall\":" << e.sim_s / e.wall_s << ",\"events\":" << setprecision(12) << e.events
+        << setprecision(6) << ",\"events_per_s\":" << e.events / e.wall_s << ",\"max_rss_kb\":" << e.max_rss_kb << "}";
+    return out.str();
+}
+
+// The value of a numeric field in one of our own JSON lines, -1 if absent
+static double Field(const string & line, const string & name) {
+    string key = "\"" + name + "\":";
+    size_t at = line.find(key);
+    return at == string::npos ? -1 : atof(line.c_str() + at + key.size());
+}
+
+static string StringField(const string & line, const string & name) {
+    string key = "\"" + name + "\":\"";
+    size_t at = line.find(key);
+    if (at == string::npos) return "";
+    size_t end = line.find('"', at + key.size());
+    return line.substr(at + key.size(), end - at - key.size());
+}
+
+// Last history line per workload
+static map<string, string> LastEntries(const string & filename) {
+    map<string, string> last;
+    ifstream in(filename);
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty()) last[StringField(line, "workload")] = line;
+    }
+    return last;
+}
+
+static BenchParams ParseArgs(int argc, char * argv[]) {
+    BenchParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-n") params.runs = unsigned(stoul(value()));
+        else if (arg == "--history") params.history = value();
+        else if (arg == "--label") params.label = value();
+        else if (arg == "--threshold") params.threshold = stod(value());
+        else if (arg == "--simulator") params.simulator = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.runs == 0) throw runtime_error("-n must be at least 1");
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        BenchParams params = ParseArgs(argc, argv);
+        map<string, string> previous = LastEntries(params.history);
+        string commit = Command("git rev-parse --short HEAD 2>/dev/null");
+
+        ofstream history(params.history, ios::app);
+        if (!history) throw runtime_error("could not append to " + params.history);
+
+        cout << left << setw(18) << "Workload" << right << setw(10) << "Wall s" << setw(10) << "+-"
+             << setw(12) << "Sim s/s" << setw(12) << "Events/s" << setw(11) << "RSS MB" << setw(10) << "vs last" << endl;
+        unsigned slower = 0;
+        for (auto & workload : params.workloads) {
+            vector<SimJob> jobs(params.runs);
+            for (auto & job : jobs) {
+                job.binary = params.simulator;
+                job.workload = workload;
+                job.collect_stats = true;
+            }
+            vector<SimResult> runs = RunJobs(jobs, 1);
+            for (auto & r : runs) {
+                if (!r.ok) throw runtime_error(workload + ": " + r.error);
+            }
+            sort(runs.begin(), runs.end(), [](const SimResult & a, const SimResult & b) { return a.wall_s < b.wall_s; });
+            const SimResult & median = runs[runs.size() / 2];
+
+            BenchEntry e;
+            e.workload = TestName(workload);
+            e.wall_s = median.wall_s;
+            e.wall_min_s = runs.front().wall_s;
+            e.wall_max_s = runs.back().wall_s;
+            e.user_s = median.user_s;
+            e.sim_s = median.runtime_s;
+            e.events = median.stats.count("callbacks") ? median.stats.at("callbacks") : 0;
+            e.max_rss_kb = 0;
+            for (auto & r : runs) e.max_rss_kb = max(e.max_rss_kb, r.max_rss_kb);
+
+            string versus = "-";
+            auto it = previous.find(e.workload);
+            if (it != previous.end() && Field(it->second, "wall_s") > 0) {
+                double delta = 100.0 * (e.wall_s - Field(it->second, "wall_s")) / Field(it->second, "wall_s");
+                ostringstream out;
+                out << fixed << setprecision(1) << showpos << delta << "%";
+                versus = out.str();
+                if (delta > params.threshold) {
+                    versus += " SLOWER";
+                    slower++;
+                }
+            }
+
+            cout << left << setw(18) << e.workload << right << fixed << setprecision(2)
+                 << setw(10) << e.wall_s << setw(10) << (e.wall_max_s - e.wall_min_s) / 2
+                 << setw(12) << setprecision(1) << e.sim_s / e.wall_s
+                 << setw(12) << setprecision(0) << e.events / e.wall_s
+                 << setw(11) << setprecision(1) << e.max_rss_kb / 1024.0 << setw(10) << versus << endl;
+            cout.unsetf(ios::fixed);
+            history << JsonLine(e, commit, params.label, params.runs) << endl;
+        }
+        cout << endl << "Appended " << params.workloads.size() << " entries to " << params.history;
+        if (slower) cout << "; " << slower << " workloads more than " << params.threshold << "% slower than their last entry";
+        cout << endl;
+        return 0;
+    } catch (const exception & e) {
+        cerr << "simbench: " << e.what() << endl;
+        return 2;
+    }
+}
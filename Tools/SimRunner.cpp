@@ -0,0 +1,168 @@
+//
+//  SimRunner.cpp
+//  CloudSim
+//
+
+#include "SimRunner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void ParseSimOutput(const string & output, SimResult & result) {
+    istringstream in(output);
+    string line;
+    while (getline(in, line)) {
+        double value;
+        int sla;
+        if (sscanf(line.c_str(), "SLA%d: %lf%%", &sla, &value) == 2 && sla >= 0 && sla < 3) {
+            result.sla[sla] = value;
+        } else if (sscanf(line.c_str(), "Total Energy %lf KW-Hour", &value) == 1) {
+            result.energy_kwh = value;
+        } else if (sscanf(line.c_str(), "Simulation run finished in %lf seconds", &value) == 1) {
+            result.runtime_s = value;
+        }
+    }
+}
+
+namespace {
+
+struct Running {
+    size_t job;
+    string output_file;
+    string stats_file;
+    chrono::steady_clock::time_point start;
+};
+
+}
+
+static pid_t Start(const SimJob & job, const string & output_file, const string & stats_file) {
+    pid_t pid = fork();
+    if (pid < 0) throw runtime_error(string("fork failed: ") + strerror(errno));
+    if (pid > 0) return pid;
+
+    FILE * out = fopen(output_file.c_str(), "w");
+    if (out == nullptr) _exit(127);
+    dup2(fileno(out), STDOUT_FILENO);
+    dup2(fileno(out), STDERR_FILENO);
+    for (auto & setting : job.env) putenv(const_cast<char *>(setting.c_str()));
+    if (!stats_file.empty()) setenv("CLOUDSIM_STATS", stats_file.c_str(), 1);
+    if (job.timeout_s) alarm(job.timeout_s);
+    execl(job.binary.c_str(), job.binary.c_str(), job.workload.c_str(), (char *) nullptr);
+    fprintf(stderr, "could not run %s: %s\n", job.binary.c_str(), strerror(errno));
+    _exit(127);
+}
+
+static string ReadFile(const string & filename) {
+    ifstream in(filename, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+vector<SimResult> RunJobs(const vector<SimJob> & jobs, unsigned parallel) {
+    if (parallel == 0) parallel = max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    vector<SimResult> results(jobs.size());
+    map<pid_t, Running> running;
+    string temp_dir = filesystem::temp_directory_path().string();
+    size_t next = 0;
+
+    while (next < jobs.size() || !running.empty()) {
+        while (next < jobs.size() && running.size() < parallel) {
+            string output_file = temp_dir + "/simrunner." + to_string(getpid()) + "." + to_string(next);
+            string stats_file = jobs[next].collect_stats ? output_file + ".stats" : "";
+            auto start = chrono::steady_clock::now();
+            pid_t pid = Start(jobs[next], output_file, stats_file);
+            running[pid] = {next, output_file, stats_file, start};
+            next++;
+        }
+
+        int status;
+        struct rusage usage;
+        pid_t pid = wait4(-1, &status, 0, &usage);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            throw runtime_error(string("wait4 failed: ") + strerror(errno));
+        }
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+
+        Running & r = it->second;
+        SimResult & result = results[r.job];
+        result.workload = jobs[r.job].workload;
+        result.wall_s = chrono::duration<double>(chrono::steady_clock::now() - r.start).count();
+        result.user_s = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        result.sys_s = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        result.max_rss_kb = usage.ru_maxrss;
+        result.output = ReadFile(r.output_file);
+        remove(r.output_file.c_str());
+        ParseSimOutput(result.output, result);
+        if (!r.stats_file.empty()) {
+            istringstream stats(ReadFile(r.stats_file));
+            remove(r.stats_file.c_str());
+            string name;
+            double value;
+            while (stats >> name >> value) result.stats[name] = value;
+        }
+
+        if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM && jobs[r.job].timeout_s) {
+            result.error = "timed out after " + to_string(jobs[r.job].timeout_s) + " s";
+        } else if (WIFSIGNALED(status)) {
+            result.error = string("killed by signal ") + strsignal(WTERMSIG(status));
+        } else if (WEXITSTATUS(status) != 0) {
+            result.error = "exit status " + to_string(WEXITSTATUS(status));
+        } else if (result.energy_kwh < 0 || result.runtime_s < 0) {
+            result.error = "no simulation report in the output";
+        }
+        result.ok = result.error.empty();
+        running.erase(it);
+    }
+    return results;
+}
+
+vector<string> ListWorkloads(const string & directory) {
+    vector<string> workloads;
+    for (auto & entry : filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".md") workloads.push_back(entry.path().string());
+    }
+    sort(workloads.begin(), workloads.end());
+    return workloads;
+}
+
+string TestName(const string & workload) {
+    return filesystem::path(workload).stem().string();
+}
+
+void SLALimits::Parse(const string & text) {
+    if (sscanf(text.c_str(), "%lf,%lf,%lf", &percent[0], &percent[1], &percent[2]) != 3) {
+        throw runtime_error("--sla-limits takes three comma-separated percentages");
+    }
+}
+
+bool SLALimits::Met(const SimResult & result) const {
+    for (int s = 0; s < 3; s++) {
+        if (result.sla[s] > percent[s]) return false;
+    }
+    return true;
+}
+
+string Figure(double value, int precision) {
+    if (value < 0) return "-";
+    ostringstream out;
+    out << setprecision(precision) << value;
+    return out.str();
+}
+
+double ParseFigure(const string & text) {
+    return text == "-" ? -1 : stod(text);
+}
@@ -0,0 +1,74 @@
+//
+//  SimRunner.hpp
+//  CloudSim
+//
+//  Runs simulator processes, several at a time, and turns their output into
+//  numbers: the SLA report, total energy and simulated runtime printed by
+//  SimulationComplete(), plus the wall time and resource usage of the process.
+//  Shared by the tools that drive the simulator over many workloads, with the
+//  SLA limits they judge runs by and the way they print and read figures.
+//
+
+#ifndef SimRunner_hpp
+#define SimRunner_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SimTypes.h"
+
+struct SimJob {
+    string binary = "./simulator";
+    string workload;
+    vector<string> env;                     // Extra NAME=value settings for this run
+    bool collect_stats = false;             // Fill SimResult::stats through CLOUDSIM_STATS
+    unsigned timeout_s = 0;                 // Kill the run after this many wall seconds; 0 for never
+};
+
+struct SimResult {
+    string workload;
+    bool ok = false;                        // Exited 0 and printed a complete report
+    string error;                           // Why not, when !ok
+    double sla[3] = {-1, -1, -1};           // SLA0..SLA2 violation %, -1 if not reported
+    double energy_kwh = -1;
+    double runtime_s = -1;                  // Simulated seconds
+    double wall_s = 0;
+    double user_s = 0;
+    double sys_s = 0;
+    long max_rss_kb = 0;
+    string output;                          // stdout and stderr, interleaved
+    map<string, double> stats;              // CLOUDSIM_STATS figures, e.g. "callbacks"
+};
+
+// Reads the report lines out of simulator output. Missing lines stay at -1.
+void ParseSimOutput(const string & output, SimResult & result);
+
+// Runs every job, at most 'parallel' at once (0 means one per core), and
+// returns the results in job order. Jobs are started in the order given, so
+// put the slowest first to finish soonest.
+vector<SimResult> RunJobs(const vector<SimJob> & jobs, unsigned parallel = 0);
+
+// Test_Cases/*.md (or another directory), sorted by name
+vector<string> ListWorkloads(const string & directory = "Test_Cases");
+
+// "hour" for "Test_Cases/hour.md"
+string TestName(const string & workload);
+
+// SLA0..SLA2 violation limits in percent (--sla-limits a,b,c)
+struct SLALimits {
+    double percent[3] = {5, 10, 20};
+
+    // Reads "a,b,c"; throws runtime_error if it is not three numbers
+    void Parse(const string & text);
+
+    // Whether every class the run reported is within its limit
+    bool Met(const SimResult & result) const;
+};
+
+// A figure to precision significant digits, "-" for a missing (negative) one;
+// ParseFigure reads it back
+string Figure(double value, int precision = 6);
+double ParseFigure(const string & text);
+
+#endif /* SimRunner_hpp */
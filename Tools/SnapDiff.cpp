@@ -0,0 +1,252 @@
+//
+//  SnapDiff.cpp
+//  CloudSim
+//
+//  Compares two cluster snapshots (CLOUDSIM_SNAPSHOT, see Snapshot.hpp), usually
+//  two moments of one run or the same moment of two policies. Prints the
+//  cluster totals side by side, then what changed:
+//      machines    S-state, P-state, memory in use, VMs and tasks gained and lost
+//      VMs         created, shut down, host, migration, tasks gained and lost
+//      tasks       arrived, completed, VM, priority, newly late, and the placed
+//                  tasks that made no progress between the two
+//  Each list shows its first --limit entries (default 20, 0 for all).
+//  Exits 0 if the snapshots hold the same cluster state, 1 if not.
+//
+//  Usage: snapdiff [--limit n] a.json b.json
+//
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "Snapshot.hpp"
+#include "Workload.hpp"
+
+struct SnapDiffParams {
+    unsigned limit = 20;
+    string files[2];
+};
+
+static string Id(unsigned id) {
+    return id == SNAPSHOT_NONE ? "none" : to_string(id);
+}
+
+// "+3 -1" for the ids in b but not a and in a but not b; both sorted
+template <typename T>
+static string Gained(vector<T> a, vector<T> b) {
+    sort(a.begin(), a.end());
+    sort(b.begin(), b.end());
+    vector<T> plus, minus;
+    set_difference(b.begin(), b.end(), a.begin(), a.end(), back_inserter(plus));
+    set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(minus));
+    if (plus.empty() && minus.empty()) return "";
+    return to_string(a.size()) + " -> " + to_string(b.size()) + " (+" + to_string(plus.size()) + " -" + to_string(minus.size()) + ")";
+}
+
+// Collects "field a -> b" changes of one entity
+class Changes {
+public:
+    template <typename T>
+    void Field(const string & name, const T & a, const T & b) {
+        if (a == b) return;
+        ostringstream out;
+        out << name << " " << a << " -> " << b;
+        list.push_back(out.str());
+    }
+    void Note(const string & note) {
+        if (!note.empty()) list.push_back(note);
+    }
+    bool Empty() const { return list.empty(); }
+    string Join() const {
+        string out;
+        for (size_t i = 0; i < list.size(); i++) out += (i ? ", " : "") + list[i];
+        return out;
+    }
+private:
+    vector<string> list;
+};
+
+// Prints a section's lines up to the limit: changes first, then additions, then removals
+typedef enum { LINE_CHANGED, LINE_ADDED, LINE_REMOVED } LineKind_t;
+
+class Section {
+public:
+    Section(const string & title, unsigned limit) : title(title), limit(limit) {}
+    void Add(const string & line, LineKind_t kind = LINE_CHANGED) { lines.push_back({kind, line}); }
+    size_t Size() const { return lines.size(); }
+    void Print(const string & counts) const {
+        vector<pair<LineKind_t, string>> sorted = lines;
+        stable_sort(sorted.begin(), sorted.end(), [](auto & a, auto & b) { return a.first < b.first; });
+        cout << endl << title << " (" << counts << ")" << endl;
+        size_t shown = limit ? min<size_t>(limit, sorted.size()) : sorted.size();
+        for (size_t i = 0; i < shown; i++) cout << "  " << sorted[i].second << endl;
+        if (shown < sorted.size()) cout << "  ... " << sorted.size() - shown << " more" << endl;
+    }
+private:
+    string title;
+    unsigned limit;
+    vector<pair<LineKind_t, string>> lines;
+};
+
+template <typename T>
+static map<unsigned, const T *> ById(const vector<T> & items) {
+    map<unsigned, const T *> index;
+    for (auto & item : items) index[item.id] = &item;
+    return index;
+}
+
+static SnapDiffParams ParseArgs(int argc, char * argv[]) {
+    SnapDiffParams params;
+    unsigned n = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--limit") params.limit = unsigned(stoul(value()));
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (n < 2) params.files[n++] = arg;
+        else n = 3;
+    }
+    if (n != 2) throw runtime_error("usage: snapdiff [--limit n] a.json b.json");
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        SnapDiffParams params = ParseArgs(argc, argv);
+        ClusterSnapshot s[2] = {ReadSnapshot(params.files[0]), ReadSnapshot(params.files[1])};
+
+        // Totals side by side
+        cout << "a: " << params.files[0] << " at " << s[0].time / 1e6 << " s (" << s[0].reason << ")" << endl
+             << "b: " << params.files[1] << " at " << s[1].time / 1e6 << " s (" << s[1].reason << ")" << endl << endl;
+        cout << left << setw(22) << "" << right << setw(12) << "a" << setw(12) << "b" << endl;
+        auto row = [](const string & name, double a, double b) {
+            cout << left << setw(22) << name << right << setw(12) << a << setw(12) << b << endl;
+        };
+        double awake[2] = {}, used[2] = {}, energy[2] = {}, unplaced[2] = {}, late[2] = {};
+        for (unsigned k = 0; k < 2; k++) {
+            for (auto & m : s[k].machines) {
+                awake[k] += m.s_state == S0;
+                used[k] += m.memory_used;
+                energy[k] += m.energy;
+            }
+            for (auto & t : s[k].tasks) {
+                unplaced[k] += t.vm == SNAPSHOT_NONE;
+                late[k] += t.late;
+            }
+        }
+        row("Machines", s[0].machines.size(), s[1].machines.size());
+        row("  in S0", awake[0], awake[1]);
+        row("  memory in use", used[0], used[1]);
+        row("  energy KWh", energy[0] / 3.6e12, energy[1] / 3.6e12);
+        row("VMs", s[0].vms.size(), s[1].vms.size());
+        row("Active tasks", s[0].tasks.size(), s[1].tasks.size());
+        row("  not placed", unplaced[0], unplaced[1]);
+        row("  past deadline", late[0], late[1]);
+
+        // Machines
+        Section machines("Machines", params.limit);
+        auto machines_a = ById(s[0].machines), machines_b = ById(s[1].machines);
+        for (auto & a : s[0].machines) {
+            auto found = machines_b.find(a.id);
+            if (found == machines_b.end()) {
+                machines.Add(to_string(a.id) + " only in a", LINE_REMOVED);
+                continue;
+            }
+            const SnapshotMachine & b = *found->second;
+            Changes c;
+            c.Field("state", SnapshotStateName(a.s_state), SnapshotStateName(b.s_state));
+            c.Field("p_state", SnapshotPStateName(a.p_state), SnapshotPStateName(b.p_state));
+            c.Field("memory", a.memory_used, b.memory_used);
+            string vms = Gained(a.vms, b.vms), tasks = Gained(a.tasks, b.tasks);
+            if (!vms.empty()) c.Note("vms " + vms);
+            if (!tasks.empty()) c.Note("tasks " + tasks);
+            if (!c.Empty()) machines.Add(to_string(a.id) + " " + CPUName(a.cpu) + ": " + c.Join());
+        }
+        for (auto & b : s[1].machines) {
+            if (!machines_a.count(b.id)) machines.Add(to_string(b.id) + " only in b", LINE_ADDED);
+        }
+
+        // VMs
+        Section vms("VMs", params.limit);
+        auto vms_a = ById(s[0].vms), vms_b = ById(s[1].vms);
+        unsigned created = 0, shut_down = 0, vms_changed = 0;
+        for (auto & b : s[1].vms) {
+            if (vms_a.count(b.id)) continue;
+            created++;
+            vms.Add("+ " + to_string(b.id) + " " + VMName(b.type) + " " + CPUName(b.cpu) + " on " + Id(b.host) + ", " +
+                    to_string(b.tasks.size()) + " tasks", LINE_ADDED);
+        }
+        for (auto & a : s[0].vms) {
+            auto found = vms_b.find(a.id);
+            if (found == vms_b.end()) {
+                shut_down++;
+                vms.Add("- " + to_string(a.id) + " " + VMName(a.type) + " " + CPUName(a.cpu) + " on " + Id(a.host), LINE_REMOVED);
+                continue;
+            }
+            const SnapshotVM & b = *found->second;
+            Changes c;
+            c.Field("host", Id(a.host), Id(b.host));
+            c.Field("migrating_to", Id(a.migrating_to), Id(b.migrating_to));
+            string tasks = Gained(a.tasks, b.tasks);
+            if (!tasks.empty()) c.Note("tasks " + tasks);
+            if (c.Empty()) continue;
+            vms_changed++;
+            vms.Add("  " + to_string(a.id) + ": " + c.Join());
+        }
+
+        // Tasks
+        Section tasks("Tasks", params.limit);
+        Section stalled("Placed in both and no progress", params.limit);
+        auto tasks_a = ById(s[0].tasks), tasks_b = ById(s[1].tasks);
+        unsigned arrived = 0, completed = 0, tasks_changed = 0;
+        for (auto & b : s[1].tasks) {
+            if (tasks_a.count(b.id)) continue;
+            arrived++;
+            tasks.Add("+ " + to_string(b.id) + " " + SLAName(b.sla) + " " + CPUName(b.cpu) + " on VM " + Id(b.vm) + ", " +
+                      SnapshotPriorityName(b.priority) + (b.late ? ", late" : ""), LINE_ADDED);
+        }
+        for (auto & a : s[0].tasks) {
+            auto found = tasks_b.find(a.id);
+            if (found == tasks_b.end()) {
+                completed++;
+                tasks.Add("- " + to_string(a.id) + " " + SLAName(a.sla) + ", deadline " + to_string(a.deadline / 1e6) + " s", LINE_REMOVED);
+                continue;
+            }
+            const SnapshotTask & b = *found->second;
+            Changes c;
+            c.Field("vm", Id(a.vm), Id(b.vm));
+            c.Field("priority", SnapshotPriorityName(a.priority), SnapshotPriorityName(b.priority));
+            if (!a.late && b.late) c.Note("now late");
+            if (!c.Empty()) {
+                tasks_changed++;
+                tasks.Add("  " + to_string(a.id) + ": " + c.Join());
+            }
+            if (a.vm != SNAPSHOT_NONE && b.vm != SNAPSHOT_NONE && a.remaining == b.remaining && s[0].time != s[1].time) {
+                stalled.Add(to_string(a.id) + " " + SLAName(a.sla) + " on VM " + Id(b.vm) + ", " + to_string(b.remaining) + " of " +
+                            to_string(b.total) + " instructions left" + (b.late ? ", late" : ""));
+            }
+        }
+
+        machines.Print(to_string(machines.Size()) + " changed");
+        vms.Print(to_string(created) + " created, " + to_string(shut_down) + " shut down, " + to_string(vms_changed) + " changed");
+        tasks.Print(to_string(arrived) + " arrived, " + to_string(completed) + " completed, " + to_string(tasks_changed) + " changed");
+        if (stalled.Size()) stalled.Print(to_string(stalled.Size()));
+
+        // Tasks that only progressed are not listed but still make the snapshots differ
+        bool same = machines.Size() == 0 && vms.Size() == 0 && tasks.Size() == 0;
+        for (auto & a : s[0].tasks) {
+            auto found = tasks_b.find(a.id);
+            if (found != tasks_b.end() && found->second->remaining != a.remaining) same = false;
+        }
+        return same ? 0 : 1;
+    } catch (const exception & e) {
+        cerr << "snapdiff: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  Stats.cpp
+//  CloudSim
+//
+
+#include "Stats.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+// Continued fraction for the regularized incomplete beta function (modified Lentz)
+static double BetaFraction(double a, double b, double x) {
+    const double tiny = 1e-300;
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    if (fabs(d) < tiny) d = tiny;
+    d = 1 / d;
+    double h = d;
+    for (int m = 1; m <= 300; m++) {
+        double m2 = 2 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+        d = 1 + aa * d;
+        if (fabs(d) < tiny) d = tiny;
+        c = 1 + aa / c;
+        if (fabs(c) < tiny) c = tiny;
+        d = 1 / d;
+        h *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+        d = 1 + aa * d;
+        if (fabs(d) < tiny) d = tiny;
+        c = 1 + aa / c;
+        if (fabs(c) < tiny) c = tiny;
+        d = 1 / d;
+        double delta = d * c;
+        h *= delta;
+        if (fabs(delta - 1) < 1e-14) break;
+    }
+    return h;
+}
+
+static double IncompleteBeta(double a, double b, double x) {
+    if (x <= 0) return 0;
+    if (x >= 1) return 1;
+    double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x));
+    if (x < (a + 1) / (a + b + 2)) return front * BetaFraction(a, b, x) / a;
+    return 1 - front * BetaFraction(b, a, 1 - x) / b;
+}
+
+double StudentTCdf(double t, double df) {
+    double tail = 0.5 * IncompleteBeta(df / 2, 0.5, df / (df + t * t));
+    return t >= 0 ? 1 - tail : tail;
+}
+
+double StudentTQuantile(double p, double df) {
+    if (p <= 0 || p >= 1) throw runtime_error("StudentTQuantile(): p must be in (0, 1)");
+    double lo = -1e3, hi = 1e3;
+    for (int i = 0; i < 200; i++) {
+        double mid = (lo + hi) / 2;
+        if (StudentTCdf(mid, df) < p) lo = mid;
+        else hi = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+Estimate EstimateMean(const vector<double> & samples, double confidence) {
+    Estimate e;
+    e.n = samples.size();
+    if (e.n == 0) return e;
+    for (double x : samples) e.mean += x;
+    e.mean /= e.n;
+    if (e.n < 2) return e;
+    double ss = 0;
+    for (double x : samples) ss += (x - e.mean) * (x - e.mean);
+    e.stddev = sqrt(ss / (e.n - 1));
+    e.half_width = StudentTQuantile(0.5 + confidence / 2, double(e.n - 1)) * e.stddev / sqrt(double(e.n));
+    return e;
+}
+
+PairedTest PairedTTest(const vector<double> & a, const vector<double> & b, double confidence) {
+    if (a.size() != b.size()) throw runtime_error("PairedTTest(): samples differ in length");
+    vector<double> differences;
+    for (size_t i = 0; i < a.size(); i++) differences.push_back(b[i] - a[i]);
+    PairedTest test;
+    test.difference = EstimateMean(differences, confidence);
+    if (test.difference.n < 2) return test;
+    if (test.difference.stddev == 0) {
+        test.p_value = test.difference.mean == 0 ? 1 : 0;
+        return test;
+    }
+    test.t = test.difference.mean / (test.difference.stddev / sqrt(double(test.difference.n)));
+    test.p_value = 2 * (1 - StudentTCdf(fabs(test.t), double(test.difference.n - 1)));
+    return test;
+}
@@ -0,0 +1,41 @@
+//
+//  Stats.hpp
+//  CloudSim
+//
+//  Small-sample statistics for the tools that compare repeated runs: means
+//  with Student-t confidence intervals and the paired t-test.
+//
+
+#ifndef Stats_hpp
+#define Stats_hpp
+
+#include <vector>
+
+#include "SimTypes.h"
+
+struct Estimate {
+    double mean = 0;
+    double stddev = 0;                      // Sample standard deviation
+    double half_width = 0;                  // Of the confidence interval; 0 with fewer than two samples
+    size_t n = 0;
+};
+
+// Mean and two-sided confidence interval at the given level
+Estimate EstimateMean(const vector<double> & samples, double confidence = 0.95);
+
+// P(T <= t) for Student's t with df degrees of freedom
+double StudentTCdf(double t, double df);
+
+// t such that StudentTCdf(t, df) = p
+double StudentTQuantile(double p, double df);
+
+struct PairedTest {
+    Estimate difference;                    // Of b - a, pair by pair
+    double t = 0;
+    double p_value = 1;                     // Two-sided; 1 when every difference is zero
+};
+
+// Paired t-test of b against a; the vectors must be the same length
+PairedTest PairedTTest(const vector<double> & a, const vector<double> & b, double confidence = 0.95);
+
+#endif /* Stats_hpp */
@@ -0,0 +1,188 @@
+//
+//  SuiteRunner.cpp
+//  CloudSim
+//
+//  Runs every Test_Cases workload in parallel, writes the SLA, energy and
+//  runtime figures to a results file and compares them with a stored baseline.
+//  Exits 1 if any test failed to run, used more energy than its baseline by more
+//  than the energy tolerance, or violated an SLA more often than the SLA
+//  tolerance allows. Simulated runtime changes are reported but do not fail.
+//
+//  Results and baseline files are tab-separated, one test per line:
+//      test  status  sla0  sla1  sla2  energy_kwh  runtime_s  wall_s
+//  with '-' for figures the simulator did not report. wall_s is only used to
+//  start the slowest tests first.
+//
+//  Usage: suiterunner [-j jobs] [--baseline file] [--results file] [--update-baseline]
+//                     [--energy-tol percent] [--sla-tol points] [--simulator path] [workload.md ...]
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "SimRunner.hpp"
+
+struct SuiteParams {
+    unsigned jobs = 0;
+    string baseline = "Test_Cases/baseline.tsv";
+    string results = "suite_results.tsv";
+    bool update_baseline = false;
+    double energy_tol = 0.1;                // Percent of the baseline energy
+    double sla_tol = 0.1;                   // Percentage points of violations
+    string simulator = "./simulator";
+    vector<string> workloads;
+};
+
+static void WriteResults(const string & filename, const vector<SimResult> & results) {
+    ofstream out(filename);
+    if (!out) throw runtime_error("could not write " + filename);
+    out << "# test\tstatus\tsla0\tsla1\tsla2\tenergy_kwh\truntime_s\twall_s" << endl;
+    for (auto & r : results) {
+        out << TestName(r.workload) << '\t' << (r.ok ? "ok" : "failed") << '\t'
+            << Figure(r.sla[0]) << '\t' << Figure(r.sla[1]) << '\t' << Figure(r.sla[2]) << '\t'
+            << Figure(r.energy_kwh) << '\t' << Figure(r.runtime_s) << '\t' << fixed << setprecision(2) << r.wall_s << endl;
+        out.unsetf(ios::fixed);
+    }
+}
+
+// Missing file: empty baseline
+static map<string, SimResult> ReadResults(const string & filename) {
+    map<string, SimResult> results;
+    ifstream in(filename);
+    string line;
+    unsigned number = 0;
+    while (getline(in, line)) {
+        number++;
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string test, status, sla[3], energy, runtime, wall;
+        if (!(fields >> test >> status >> sla[0] >> sla[1] >> sla[2] >> energy >> runtime >> wall)) {
+            throw runtime_error(filename + ":" + to_string(number) + ": expected 8 fields");
+        }
+        SimResult & r = results[test];
+        r.workload = test;
+        r.ok = status == "ok";
+        for (int i = 0; i < 3; i++) r.sla[i] = ParseFigure(sla[i]);
+        r.energy_kwh = ParseFigure(energy);
+        r.runtime_s = ParseFigure(runtime);
+        r.wall_s = ParseFigure(wall);
+    }
+    return results;
+}
+
+static SuiteParams ParseArgs(int argc, char * argv[]) {
+    SuiteParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--baseline") params.baseline = value();
+        else if (arg == "--results") params.results = value();
+        else if (arg == "--update-baseline") params.update_baseline = true;
+        else if (arg == "--energy-tol") params.energy_tol = stod(value());
+        else if (arg == "--sla-tol") params.sla_tol = stod(value());
+        else if (arg == "--simulator") params.simulator = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        SuiteParams params = ParseArgs(argc, argv);
+        map<string, SimResult> baseline = ReadResults(params.baseline);
+
+        // Slowest first, by the baseline's wall time; tests it does not know go first
+        vector<string> order = params.workloads;
+        auto wall = [&](const string & workload) {
+            auto it = baseline.find(TestName(workload));
+            return it == baseline.end() ? 1e300 : it->second.wall_s;
+        };
+        stable_sort(order.begin(), order.end(), [&](const string & a, const string & b) { return wall(a) > wall(b); });
+        vector<SimJob> jobs;
+        for (auto & workload : order) {
+            SimJob job;
+            job.binary = params.simulator;
+            job.workload = workload;
+            jobs.push_back(job);
+        }
+        vector<SimResult> results = RunJobs(jobs, params.jobs);
+        sort(results.begin(), results.end(), [](const SimResult & a, const SimResult & b) { return a.workload < b.workload; });
+        WriteResults(params.results, results);
+
+        unsigned failures = 0, regressions = 0;
+        cout << left << setw(18) << "Test" << right << setw(12) << "Energy" << setw(9) << "dE%"
+             << setw(10) << "SLA0" << setw(10) << "SLA1" << setw(10) << "SLA2" << setw(10) << "Sim s"
+             << setw(8) << "Wall s" << "  Verdict" << endl;
+        for (auto & r : results) {
+            string test = TestName(r.workload);
+            auto it = baseline.find(test);
+            const SimResult * base = it == baseline.end() ? nullptr : &it->second;
+            vector<string> notes;
+
+            string energy_delta = "";
+            if (!r.ok) {
+                failures++;
+                notes.push_back("FAILED: " + r.error);
+            } else if (base == nullptr || !base->ok) {
+                notes.push_back("no baseline");
+            } else {
+                if (base->energy_kwh > 0) {
+                    double delta = 100.0 * (r.energy_kwh - base->energy_kwh) / base->energy_kwh;
+                    ostringstream out;
+                    out << fixed << setprecision(2) << showpos << delta;
+                    energy_delta = out.str();
+                    if (delta > params.energy_tol) notes.push_back("ENERGY REGRESSION");
+                    else if (delta < -params.energy_tol) notes.push_back("energy improved");
+                }
+                for (int s = 0; s < 3; s++) {
+                    if (r.sla[s] < 0 || base->sla[s] < 0) continue;
+                    double delta = r.sla[s] - base->sla[s];
+                    if (delta > params.sla_tol) notes.push_back("SLA" + to_string(s) + " REGRESSION (" + Figure(base->sla[s]) + "%)");
+                    else if (delta < -params.sla_tol) notes.push_back("SLA" + to_string(s) + " improved");
+                }
+                if (base->runtime_s >= 0 && r.runtime_s != base->runtime_s) {
+                    notes.push_back("runtime " + Figure(base->runtime_s) + "s -> " + Figure(r.runtime_s) + "s");
+                }
+                for (auto & note : notes) {
+                    if (note.find("REGRESSION") != string::npos) regressions++;
+                }
+            }
+
+            string verdict;
+            for (auto & note : notes) verdict += (verdict.empty() ? "" : ", ") + note;
+            cout << left << setw(18) << test << right << setw(12) << Figure(r.energy_kwh) << setw(9) << energy_delta
+                 << setw(10) << Figure(r.sla[0]) << setw(10) << Figure(r.sla[1]) << setw(10) << Figure(r.sla[2])
+                 << setw(10) << Figure(r.runtime_s) << setw(8) << fixed << setprecision(1) << r.wall_s
+                 << "  " << (verdict.empty() ? "ok" : verdict) << endl;
+            cout.unsetf(ios::fixed);
+        }
+
+        cout << endl << results.size() << " tests, " << failures << " failed, " << regressions
+             << " regressions. Results in " << params.results << endl;
+        if (params.update_baseline) {
+            if (failures) throw runtime_error("not updating the baseline while tests fail");
+            // Tests that were not run keep their baseline
+            for (auto & r : results) baseline[TestName(r.workload)] = r;
+            vector<SimResult> merged;
+            for (auto & entry : baseline) merged.push_back(entry.second);
+            WriteResults(params.baseline, merged);
+            cout << "Baseline " << params.baseline << " updated" << endl;
+            return 0;
+        }
+        return failures || regressions ? 1 : 0;
+    } catch (const exception & e) {
+        cerr << "suiterunner: " << e.what() << endl;
+        return 2;
+    }
+}
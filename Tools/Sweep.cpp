@@ -0,0 +1,173 @@
+//
+//  Sweep.cpp
+//  CloudSim
+//
+//  Parameter sweep over the scheduler's knobs (SchedulerParams.hpp). Builds a
+//  set of settings, either a full grid with --grid steps per knob or --lhs
+//  Latin-hypercube samples (every knob's range cut into as many strata as
+//  samples, each stratum used once), runs every setting on every workload on
+//  all cores, and prints for each test the Pareto frontier: the settings no
+//  other setting beats on energy and on all three SLA violation rates at once.
+//  Knobs not swept keep the value from --base, or CLOUDSIM_PARAMS if set, or
+//  their default. Settings whose P-state thresholds do not fall from P0 to P2
+//  are reported as failed without running. Runs are cached (see
+//  ParamEval.hpp), so widening a sweep only runs the new settings.
+//
+//  Every result goes to a tab-separated file, one setting and test per line:
+//      test  params  status  sla0  sla1  sla2  energy_kwh  frontier
+//
+//  Usage: sweep --param name=lo:hi [--param ...] [--grid steps | --lhs samples] [--seed n]
+//               [-j jobs] [--base file] [--cache file] [--results file] [--simulator path]
+//               [workload.md ...]
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "ParamEval.hpp"
+
+struct SweepParams {
+    vector<ParamRange> ranges;
+    unsigned grid = 5;                      // Points per knob, ends included
+    unsigned lhs = 0;                       // Samples; 0 means grid
+    uint64_t seed = 1;
+    unsigned jobs = 0;
+    string base;
+    string cache = "sweep_cache.tsv";
+    string results = "sweep_results.tsv";
+    string simulator = "./simulator";
+    vector<string> workloads;
+};
+
+static vector<SchedulerParams> Grid(const SchedulerParams & base, const vector<ParamRange> & ranges, unsigned steps) {
+    vector<SchedulerParams> settings = {base};
+    for (auto & range : ranges) {
+        set<double> values;
+        for (unsigned s = 0; s < steps; s++) values.insert(RangeValue(range, steps == 1 ? 0.5 : double(s) / (steps - 1)));
+        vector<SchedulerParams> next;
+        for (auto & setting : settings) {
+            for (double value : values) {
+                next.push_back(setting);
+                next.back().*range.spec->field = value;
+            }
+        }
+        settings = next;
+    }
+    return settings;
+}
+
+// a is at least as good as b everywhere and better somewhere
+static bool Dominates(const SimResult & a, const SimResult & b) {
+    bool better = a.energy_kwh < b.energy_kwh;
+    if (a.energy_kwh > b.energy_kwh) return false;
+    for (int s = 0; s < 3; s++) {
+        if (a.sla[s] > b.sla[s]) return false;
+        if (a.sla[s] < b.sla[s]) better = true;
+    }
+    return better;
+}
+
+static SweepParams ParseArgs(int argc, char * argv[]) {
+    SweepParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--param") params.ranges.push_back(ParseParamRange(value()));
+        else if (arg == "--grid") params.grid = unsigned(stoul(value()));
+        else if (arg == "--lhs") params.lhs = unsigned(stoul(value()));
+        else if (arg == "--seed") params.seed = stoull(value());
+        else if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--base") params.base = value();
+        else if (arg == "--cache") params.cache = value();
+        else if (arg == "--results") params.results = value();
+        else if (arg == "--simulator") params.simulator = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.ranges.empty()) {
+        string names;
+        for (unsigned i = 0; i < kSchedulerParamCount; i++) names += string(" ") + kSchedulerParams[i].name;
+        throw runtime_error("nothing to sweep; give --param name=lo:hi for some of" + names);
+    }
+    if (params.grid == 0) throw runtime_error("--grid must be at least 1");
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        SweepParams params = ParseArgs(argc, argv);
+        if (params.base.empty()) params.base = SchedulerParamsFile();
+        SchedulerParams base = params.base.empty() ? SchedulerParams() : ReadSchedulerParams(params.base);
+
+        vector<SchedulerParams> settings;
+        if (params.lhs) {
+            for (auto & point : LatinHypercube(params.lhs, unsigned(params.ranges.size()), params.seed)) {
+                settings.push_back(AtPoint(base, params.ranges, point));
+            }
+        } else {
+            settings = Grid(base, params.ranges, params.grid);
+        }
+        ParamEvaluator evaluator(params.simulator, params.workloads, params.cache, params.jobs);
+        cout << settings.size() << " settings x " << params.workloads.size() << " workloads" << endl;
+        vector<vector<SimResult>> results = evaluator.Evaluate(settings);
+        cout << evaluator.Ran() << " runs, " << evaluator.Cached() << " from " << params.cache << endl;
+
+        ofstream out(params.results);
+        if (!out) throw runtime_error("could not write " + params.results);
+        out << "# test\tparams\tstatus\tsla0\tsla1\tsla2\tenergy_kwh\tfrontier" << endl;
+        unsigned failures = 0;
+        for (size_t w = 0; w < params.workloads.size(); w++) {
+            string test = TestName(params.workloads[w]);
+            vector<size_t> frontier;
+            for (size_t i = 0; i < settings.size(); i++) {
+                const SimResult & r = results[i][w];
+                if (!r.ok) {
+                    failures++;
+                    continue;
+                }
+                bool dominated = false;
+                for (size_t j = 0; j < settings.size() && !dominated; j++) {
+                    dominated = results[j][w].ok && Dominates(results[j][w], r);
+                }
+                // Equal results from different settings show once
+                for (size_t f : frontier) {
+                    const SimResult & other = results[f][w];
+                    if (other.energy_kwh == r.energy_kwh && equal(other.sla, other.sla + 3, r.sla)) dominated = true;
+                }
+                if (!dominated) frontier.push_back(i);
+            }
+            for (size_t i = 0; i < settings.size(); i++) {
+                const SimResult & r = results[i][w];
+                bool on_frontier = find(frontier.begin(), frontier.end(), i) != frontier.end();
+                out << test << '\t' << ParamsText(settings[i], params.ranges) << '\t' << (r.ok ? "ok" : "failed") << '\t'
+                    << Figure(r.sla[0]) << '\t' << Figure(r.sla[1]) << '\t' << Figure(r.sla[2]) << '\t'
+                    << Figure(r.energy_kwh) << '\t' << (on_frontier ? "yes" : "no") << endl;
+            }
+
+            sort(frontier.begin(), frontier.end(), [&](size_t a, size_t b) { return results[a][w].energy_kwh < results[b][w].energy_kwh; });
+            cout << endl << test << ": " << frontier.size() << " of " << settings.size() << " settings on the frontier" << endl;
+            cout << right << setw(12) << "Energy" << setw(10) << "SLA0" << setw(10) << "SLA1" << setw(10) << "SLA2" << "  Setting" << endl;
+            for (size_t i : frontier) {
+                const SimResult & r = results[i][w];
+                cout << setw(12) << Figure(r.energy_kwh) << setw(10) << Figure(r.sla[0]) << setw(10) << Figure(r.sla[1])
+                     << setw(10) << Figure(r.sla[2]) << "  " << ParamsText(settings[i], params.ranges) << endl;
+            }
+        }
+        cout << endl << "All results in " << params.results;
+        if (failures) cout << "; " << failures << " runs failed";
+        cout << endl;
+        return failures ? 1 : 0;
+    } catch (const exception & e) {
+        cerr << "sweep: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,203 @@
+//
+//  TelemetryQuery.cpp
+//  CloudSim
+//
+//  Aggregates a telemetry series (CLOUDSIM_TELEMETRY, Telemetry.hpp) over
+//  groups of machines and, with --interval, over time windows. Groups are CPU
+//  types (--by cpu, the default), machine classes (--by class) or single
+//  machines (--by machine). Classes come from --workload, whose machine classes
+//  number the machines in file order; without it machines with the same CPU,
+//  cores, memory and GPU flag form a class.
+//
+//  Per group and window: machines, mean awake (S0) machines, mean utilization
+//  of the awake ones (tasks over cores, capped at 1), mean P-state of the awake
+//  ones, memory in use, mean and peak queue (tasks beyond the core count),
+//  mean power and energy. Power and energy come from the change in each
+//  machine's energy counter between samples; the state figures are the mean of
+//  the samples in the window.
+//
+//  Usage: telemetry [--by cpu|class|machine] [--interval s] [--workload file.md]
+//                   [--csv file] run.tlm
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "Telemetry.hpp"
+#include "Workload.hpp"
+
+struct QueryParams {
+    string by = "cpu";
+    double interval_s = 0;              // 0: the whole run
+    string workload;
+    string csv;
+    string file;
+};
+
+struct GroupWindow {
+    unsigned machines = 0;
+    uint64_t samples = 0;
+    double awake = 0;
+    double utilization = 0;             // Sum over awake machine samples
+    double p_state = 0;
+    uint64_t awake_samples = 0;
+    double memory_used = 0, memory_size = 0;
+    double queue = 0;
+    int64_t queue_max = 0;
+    double energy_uj = 0;
+};
+
+static QueryParams ParseArgs(int argc, char * argv[]) {
+    QueryParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--by") params.by = value();
+        else if (arg == "--interval") params.interval_s = stod(value());
+        else if (arg == "--workload") params.workload = value();
+        else if (arg == "--csv") params.csv = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (params.file.empty()) params.file = arg;
+        else throw runtime_error("one telemetry file at a time");
+    }
+    if (params.file.empty()) throw runtime_error("usage: telemetry [--by cpu|class|machine] [--interval s] [--workload file.md] [--csv file] run.tlm");
+    if (params.by != "cpu" && params.by != "class" && params.by != "machine") throw runtime_error("--by takes cpu, class or machine");
+    return params;
+}
+
+// Group name of every machine
+static vector<string> Groups(const QueryParams & params, const vector<TelemetryMachine> & machines) {
+    vector<string> groups(machines.size());
+    if (params.by == "cpu") {
+        for (size_t m = 0; m < machines.size(); m++) groups[m] = CPUName(machines[m].cpu);
+    } else if (params.by == "machine") {
+        for (size_t m = 0; m < machines.size(); m++) groups[m] = "machine " + to_string(m);
+    } else if (!params.workload.empty()) {
+        Workload workload = ReadWorkload(params.workload);
+        size_t m = 0;
+        for (size_t c = 0; c < workload.machines.size(); c++) {
+            const MachineClass & mc = workload.machines[c];
+            string name = "class " + to_string(c + 1) + " (" + CPUName(mc.cpu) + (mc.gpus ? ", GPU" : "") + ")";
+            for (unsigned i = 0; i < mc.count && m < groups.size(); i++) groups[m++] = name;
+        }
+        if (m != machines.size()) throw runtime_error(params.workload + " has " + to_string(m) + " machines, the series " + to_string(machines.size()));
+    } else {
+        map<tuple<unsigned, unsigned, unsigned, bool>, string> classes;
+        for (size_t m = 0; m < machines.size(); m++) {
+            const TelemetryMachine & tm = machines[m];
+            auto key = make_tuple(unsigned(tm.cpu), tm.cores, tm.memory_size, tm.gpus);
+            if (!classes.count(key)) {
+                classes[key] = "class " + to_string(classes.size() + 1) + " (" + CPUName(tm.cpu) + ", " + to_string(tm.cores) +
+                               " cores" + (tm.gpus ? ", GPU" : "") + ")";
+            }
+            groups[m] = classes[key];
+        }
+    }
+    return groups;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        QueryParams params = ParseArgs(argc, argv);
+        TelemetryReader reader;
+        reader.Open(params.file);
+        const vector<TelemetryMachine> & machines = reader.Machines();
+        vector<string> groups = Groups(params, machines);
+
+        // (window, group) in first-seen group order
+        vector<string> order;
+        for (auto & g : groups) {
+            if (find(order.begin(), order.end(), g) == order.end()) order.push_back(g);
+        }
+        map<pair<uint64_t, string>, GroupWindow> windows;
+        map<uint64_t, Time_t> spans;            // Time each window's energy covers
+        Time_t interval = Time_t(params.interval_s * 1e6);
+
+        TelemetrySample sample, previous;
+        bool first = true;
+        while (reader.Next(sample)) {
+            uint64_t window = interval ? sample.time / interval : 0;
+            if (!first) spans[window] += sample.time - previous.time;
+            for (size_t m = 0; m < machines.size(); m++) {
+                GroupWindow & w = windows[{window, groups[m]}];
+                const auto & v = sample.values[m];
+                const TelemetryMachine & tm = machines[m];
+                if (!first) w.energy_uj += v[TM_ENERGY] - previous.values[m][TM_ENERGY];
+                w.samples++;
+                w.memory_used += v[TM_MEMORY_USED];
+                w.memory_size += tm.memory_size;
+                int64_t queue = max<int64_t>(0, v[TM_TASKS] - int64_t(tm.cores));
+                w.queue += queue;
+                w.queue_max = max(w.queue_max, queue);
+                if (v[TM_S_STATE] == S0) {
+                    w.awake++;
+                    w.awake_samples++;
+                    w.utilization += tm.cores ? min(1.0, double(v[TM_TASKS]) / tm.cores) : 0;
+                    w.p_state += v[TM_P_STATE];
+                }
+            }
+            previous = sample;
+            first = false;
+        }
+        for (size_t m = 0; m < machines.size(); m++) {
+            for (auto & entry : windows) {
+                if (entry.first.second == groups[m]) entry.second.machines++;
+            }
+        }
+
+        cout << params.file << ": " << machines.size() << " machines, " << reader.Samples() << " samples (every "
+             << reader.Stride() << " SchedulerCheck" << (reader.Stride() > 1 ? "s" : "") << ")" << endl;
+        ofstream csv;
+        if (!params.csv.empty()) {
+            csv.open(params.csv);
+            if (!csv) throw runtime_error("could not write " + params.csv);
+            csv << "window_start_s,group,machines,awake,utilization,p_state,memory_used_pct,queue_mean,queue_max,power_w,energy_kwh" << endl;
+        }
+        uint64_t last_window = windows.empty() ? 0 : windows.rbegin()->first.first;
+        for (uint64_t window = 0; window <= last_window; window++) {
+            bool header = false;
+            for (auto & group : order) {
+                auto found = windows.find({window, group});
+                if (found == windows.end()) continue;
+                const GroupWindow & w = found->second;
+                if (!header) {
+                    header = true;
+                    cout << endl;
+                    if (interval) cout << "From " << window * params.interval_s << " s" << endl;
+                    cout << left << setw(28) << "Group" << right << setw(9) << "Machines" << setw(8) << "Awake" << setw(8) << "Util"
+                         << setw(8) << "P-state" << setw(8) << "Mem %" << setw(8) << "Queue" << setw(10) << "Max queue"
+                         << setw(10) << "Power W" << setw(13) << "Energy KWh" << endl;
+                }
+                double per_machine = w.machines ? double(w.samples) / w.machines : 1;
+                double awake = w.awake / per_machine;
+                double utilization = w.awake_samples ? w.utilization / w.awake_samples : 0;
+                double p_state = w.awake_samples ? w.p_state / w.awake_samples : 0;
+                double memory = w.memory_size ? 100 * w.memory_used / w.memory_size : 0;
+                double queue = w.queue / per_machine;
+                Time_t span = spans[window];
+                double watts = span ? w.energy_uj / span : 0;
+                double kwh = w.energy_uj / 3.6e12;
+                cout << left << setw(28) << group << right << setw(9) << w.machines << fixed << setprecision(1) << setw(8) << awake
+                     << setprecision(2) << setw(8) << utilization << setw(8) << p_state << setprecision(1) << setw(8) << memory
+                     << setw(8) << queue << setw(10) << w.queue_max << setprecision(0) << setw(10) << watts
+                     << setprecision(6) << setw(13) << kwh << endl;
+                cout.unsetf(ios::fixed);
+                if (csv.is_open()) {
+                    csv << window * params.interval_s << "," << group << "," << w.machines << "," << awake << "," << utilization << ","
+                        << p_state << "," << memory << "," << queue << "," << w.queue_max << "," << watts << "," << kwh << endl;
+                }
+            }
+        }
+        return 0;
+    } catch (const exception & e) {
+        cerr << "telemetry: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,307 @@
+//
+//  Timeline.cpp
+//  CloudSim
+//
+//  Exports a run as a Chrome trace-event JSON file, to open in Perfetto
+//  (ui.perfetto.dev) or chrome://tracing, on the simulated time axis (1 us of
+//  simulated time is 1 us in the viewer). The input is a callback trace
+//  (CLOUDSIM_CAPTURE), replayed through the ClusterMirror that energyshare and
+//  slacause use.
+//
+//  One process per machine holds its tasks (one async slice per run of a task
+//  on it, until completion, removal or the start of a migration), a thread
+//  with its S-state (and the transition to it), a thread of instants (VM
+//  attach and shutdown, migrations, SLA and memory warnings) and a P-state
+//  counter. A "Cluster" process has counters for active tasks, awake machines
+//  and modelled power (ClusterMirror::Power). The simulator leaves s_states
+//  empty in Machine_GetInfo answers, so the power counter needs the run's
+//  workload (--workload) for the ladders; machines are numbered in the order
+//  of the file's machine classes. Slices still open when the trace ends are
+//  closed at its last timestamp.
+//
+//  The file is streamed. Once it reaches --max-mb, per-machine events stop
+//  and the cluster counters are written at most once per simulated second, so
+//  even hour-long traces stay loadable; --from/--to select a window instead.
+//
+//  Usage: timeline [-o file.json] [--workload file.md] [--max-mb n] [--from s] [--to s] run.trace
+//
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "ClusterMirror.hpp"
+
+struct TimelineParams {
+    string output = "timeline.json";
+    double max_mb = 256;
+    Time_t from = 0;
+    Time_t to = ~Time_t(0);
+    string workload;
+    string trace;
+};
+
+// The JSON stream written from the cluster mirror
+class Timeline : public ClusterMirror {
+public:
+    Timeline(const TimelineParams & params) : ClusterMirror(params.workload), params(params) {
+        out.open(params.output);
+        if (!out) throw runtime_error("could not write " + params.output);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        Raw("{\"ph\":\"M\",\"pid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"Cluster\"}}");
+        Raw("{\"ph\":\"M\",\"pid\":0,\"name\":\"process_sort_index\",\"args\":{\"sort_index\":-1}}");
+    }
+
+    void Finish() {
+        Counters(true);
+        // Slices still open end with the trace
+        for (auto & m : machines) {
+            if (m.second.slice.empty()) continue;
+            Thread(m.first, 'E', 1, "");
+            m.second.slice.clear();
+        }
+        while (!open.empty()) {
+            OpenAsync a = open.begin()->second;
+            Async('e', a.machine_id, a.cat, a.id, a.name, "end of trace");
+        }
+        out << "\n],\"otherData\":{\"truncated\":" << (capped ? "true" : "false") << "}}\n";
+        out.close();
+        cout << "Wrote " << params.output << ": " << events << " events, " << bytes / 1048576 << " MB"
+             << (capped ? ", per-machine events stopped at the size cap" : "") << endl;
+    }
+
+protected:
+    void TimeChanging(Time_t) override { Counters(false); }
+
+    void Before(const TraceEvent & e) override {
+        if (e.kind == TraceEvent::BEGIN) {
+            MachineId_t machine_id;
+            switch (e.callback) {
+                case CB_MIGRATION_DONE: {
+                    const MirrorVM & vm = GetVM(e.subject);
+                    if (vm.migrating) Async('e', vm.target, "migration", "m" + to_string(e.subject), "Incoming VM " + to_string(e.subject));
+                    break;
+                }
+                case CB_MEMORY_WARNING:
+                    Instant(e.subject, "Memory warning");
+                    break;
+                case CB_SLA_WARNING:
+                    if (TaskMachine(e.subject, machine_id)) Instant(machine_id, "SLA warning, task " + to_string(e.subject));
+                    break;
+                default: break;
+            }
+        } else if (e.kind == TraceEvent::CALL && e.call == CALL_VM_SHUTDOWN) {
+            const MirrorVM & vm = GetVM(e.args[0]);
+            if (vm.attached) Instant(vm.machine, "Shutdown VM " + to_string(e.args[0]));
+        }
+    }
+
+    void After(const TraceEvent & e) override {
+        if (e.kind != TraceEvent::CALL) return;
+        switch (e.call) {
+            case CALL_MACHINE_GET_INFO: {
+                const MachineInfo_t & info = e.machine;
+                Machine & m = Get(info.machine_id);
+                m.cpu = info.cpu;
+                m.gpus = info.gpus;
+                if (!m.known) {
+                    m.known = true;
+                    Name(info.machine_id);
+                }
+                Draw(info.machine_id);
+                break;
+            }
+            case CALL_GET_TASK_INFO:
+                task_sla[e.task.task_id] = e.task.required_sla;
+                break;
+            case CALL_VM_ATTACH:
+                Instant(e.args[1], "Attach VM " + to_string(e.args[0]) + " (" + VMName(GetVM(e.args[0]).type) + ")");
+                break;
+            case CALL_VM_MIGRATE: {
+                const MirrorVM & vm = GetVM(e.args[0]);
+                Instant(vm.machine, "Migrate VM " + to_string(e.args[0]) + " to machine " + to_string(e.args[1]));
+                Async('b', e.args[1], "migration", "m" + to_string(e.args[0]), "Incoming VM " + to_string(e.args[0]));
+                break;
+            }
+            default: break;
+        }
+    }
+
+    void Changed(MachineId_t machine_id) override {
+        dirty = true;
+        Draw(machine_id);
+    }
+
+    void Joined(TaskId_t task_id, MachineId_t machine_id) override {
+        string name = "Task " + to_string(task_id);
+        auto sla = task_sla.find(task_id);
+        if (sla != task_sla.end()) name += " (" + SLAName(sla->second) + ")";
+        Async('b', machine_id, "task", "t" + to_string(task_id), name);
+    }
+
+    void Left(TaskId_t task_id, MachineId_t machine_id, const string & how) override {
+        Async('e', machine_id, "task", "t" + to_string(task_id), "Task " + to_string(task_id), how);
+    }
+
+private:
+    struct OpenAsync {
+        MachineId_t machine_id;
+        string cat, id, name;
+    };
+
+    // What has been written for a machine
+    struct Machine {
+        bool known = false;                 // Seen in a Machine_GetInfo answer
+        bool named = false;                 // Process metadata written
+        CPUType_t cpu = X86;
+        bool gpus = false;
+        string slice;                       // Name of the S-state slice open on thread 1, if any
+        int p_state = -1;                   // Last P-state counter value
+    };
+
+    static string StateName(MachineState_t s) {
+        static const char * names[] = {"0", "0i1", "1", "2", "3", "4", "5"};
+        return s < S_STATES ? names[s] : to_string(s);
+    }
+
+    Machine & Get(MachineId_t machine_id) {
+        Machine & m = machines[machine_id];
+        if (!m.named && Detail()) {
+            m.named = true;
+            // pid 0 is the cluster, so machine i is process i + 1
+            string pid = to_string(machine_id + 1);
+            Raw("{\"ph\":\"M\",\"pid\":" + pid + ",\"name\":\"process_sort_index\",\"args\":{\"sort_index\":" + pid + "}}");
+            Raw("{\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"S-state\"}}");
+            Raw("{\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":2,\"name\":\"thread_name\",\"args\":{\"name\":\"Events\"}}");
+        }
+        return m;
+    }
+
+    void Name(MachineId_t machine_id) {
+        Machine & m = machines[machine_id];
+        if (!m.known || !Detail()) return;
+        Raw("{\"ph\":\"M\",\"pid\":" + to_string(machine_id + 1) + ",\"name\":\"process_name\",\"args\":{\"name\":\"Machine " +
+            to_string(machine_id) + " (" + CPUName(m.cpu) + (m.gpus ? ", GPU" : "") + ")\"}}");
+    }
+
+    // Brings the machine's S-state slice and P-state counter up to the mirror
+    void Draw(MachineId_t machine_id) {
+        if (!Detail()) return;
+        Machine & m = Get(machine_id);
+        const MirrorMachine & mirror = GetMachine(machine_id);
+        string slice = "S" + StateName(mirror.s_state) + (mirror.transition ? " -> S" + StateName(mirror.pending) : "");
+        if (slice != m.slice) {
+            if (!m.slice.empty()) Thread(machine_id, 'E', 1, "");
+            Thread(machine_id, 'B', 1, slice);
+            m.slice = slice;
+        }
+        if (int(mirror.p_state) != m.p_state) {
+            m.p_state = int(mirror.p_state);
+            Raw("{\"ph\":\"C\",\"pid\":" + to_string(machine_id + 1) + ",\"ts\":" + to_string(now) +
+                ",\"name\":\"P-state\",\"args\":{\"P\":" + to_string(mirror.p_state) + "}}");
+        }
+    }
+
+    // Cluster counters, when anything they show changed; once the cap is hit, at most once per second
+    void Counters(bool force) {
+        if (!dirty || now < params.from || now > params.to) return;
+        if (capped && !force && now < last_counter + 1000000) return;
+        double watts = 0;
+        unsigned awake = 0, active = 0;
+        for (MachineId_t machine_id = 0; machine_id < MachineCount(); machine_id++) {
+            const MirrorMachine & m = GetMachine(machine_id);
+            if (m.s_state == S0) awake++;
+            active += unsigned(m.tasks.size());
+            MachinePower power = Power(machine_id);
+            watts += power.idle + power.dynamic;
+        }
+        string ts = to_string(now);
+        Raw("{\"ph\":\"C\",\"pid\":0,\"ts\":" + ts + ",\"name\":\"Active tasks\",\"args\":{\"tasks\":" + to_string(active) + "}}");
+        Raw("{\"ph\":\"C\",\"pid\":0,\"ts\":" + ts + ",\"name\":\"Awake machines\",\"args\":{\"S0\":" + to_string(awake) + "}}");
+        if (HasWorkload()) Raw("{\"ph\":\"C\",\"pid\":0,\"ts\":" + ts + ",\"name\":\"Power (model, W)\",\"args\":{\"W\":" + to_string(unsigned(watts)) + "}}");
+        last_counter = now;
+        dirty = false;
+    }
+
+    bool Detail() const { return !capped && now >= params.from && now <= params.to; }
+
+    void Instant(MachineId_t machine_id, const string & name) {
+        if (!Detail()) return;
+        Get(machine_id);
+        Raw("{\"ph\":\"i\",\"s\":\"t\",\"pid\":" + to_string(machine_id + 1) + ",\"tid\":2,\"ts\":" + to_string(now) + ",\"name\":\"" + name + "\"}");
+    }
+
+    void Thread(MachineId_t machine_id, char phase, unsigned tid, const string & name) {
+        Raw(string("{\"ph\":\"") + phase + "\",\"pid\":" + to_string(machine_id + 1) + ",\"tid\":" + to_string(tid) +
+            ",\"ts\":" + to_string(now) + (name.empty() ? "" : ",\"name\":\"" + name + "\"") + "}");
+    }
+
+    // Async slices; an end is only written for a begin that was
+    void Async(char phase, MachineId_t machine_id, const string & cat, const string & id, const string & name, const string & how = "") {
+        string key = to_string(machine_id) + "/" + id;
+        if (phase == 'b') {
+            if (!Detail()) return;
+            Get(machine_id);
+            open[key] = {machine_id, cat, id, name};
+        } else {
+            if (!open.erase(key)) return;
+        }
+        Raw(string("{\"ph\":\"") + phase + "\",\"cat\":\"" + cat + "\",\"id\":\"" + id + "\",\"pid\":" + to_string(machine_id + 1) +
+            ",\"ts\":" + to_string(now) + ",\"name\":\"" + name + "\"" + (how.empty() ? "" : ",\"args\":{\"end\":\"" + how + "\"}") + "}");
+    }
+
+    void Raw(const string & event) {
+        if (events) out << ",\n";
+        out << event;
+        bytes += event.size() + 2;
+        events++;
+        if (!capped && bytes > params.max_mb * 1048576) capped = true;
+    }
+
+    const TimelineParams & params;
+    ofstream out;
+    uint64_t bytes = 0, events = 0;
+    bool capped = false;
+    Time_t last_counter = 0;
+    bool dirty = true;
+
+    map<MachineId_t, Machine> machines;
+    map<TaskId_t, SLAType_t> task_sla;
+    map<string, OpenAsync> open;            // Async slices begun and not yet ended
+};
+
+static TimelineParams ParseArgs(int argc, char * argv[]) {
+    TimelineParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "-o") params.output = value();
+        else if (arg == "--workload") params.workload = value();
+        else if (arg == "--max-mb") params.max_mb = stod(value());
+        else if (arg == "--from") params.from = Time_t(stod(value()) * 1e6);
+        else if (arg == "--to") params.to = Time_t(stod(value()) * 1e6);
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else if (params.trace.empty()) params.trace = arg;
+        else throw runtime_error("one trace at a time");
+    }
+    if (params.trace.empty()) throw runtime_error("usage: timeline [-o file.json] [--workload file.md] [--max-mb n] [--from s] [--to s] run.trace");
+    return params;
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        TimelineParams params = ParseArgs(argc, argv);
+        Timeline timeline(params);
+        timeline.Replay(params.trace);
+        timeline.Finish();
+        return 0;
+    } catch (const exception & e) {
+        cerr << "timeline: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,531 @@
+//
+//  TraceBench.cpp
+//  CloudSim
+//
+//  Replays a callback trace (CLOUDSIM_CAPTURE) against a scheduler build without
+//  the simulator, and reports how long the scheduler spends per callback. This
+//  file implements every Interfaces.h function the scheduler calls, answering
+//  queries from the trace:
+//      strict   the next traced call is the same call with the same arguments
+//      loose    the same call and arguments appear later in the current callback,
+//               or earlier in the trace (the last answer before the replay's
+//               position is reused, found in an index built when loading)
+//      default  never seen; an empty answer is made up
+//  A scheduler that makes the same decisions as the one that was captured gets
+//  only strict answers. Callbacks the simulator delivered from inside a command
+//  are delivered when the scheduler issues that command. Only top-level
+//  callbacks are timed, so a nested callback's time counts toward its parent.
+//
+//  The Scheduler keeps its state in a static object, so each repetition runs in
+//  a forked child. Links whatever BENCH_SCHEDULER names (Scheduler.o by default).
+//
+//  Usage: tracebench run.trace [-r repeats] [-c] [-v]
+//      -c  print per-callback count, mean and p50/p90/p99/max ns as CSV
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "CallbackTrace.hpp"
+#include "Interfaces.h"
+
+// One trace event. Struct answers live in pools and are shared by consecutive
+// identical answers for the same id.
+struct Entry {
+    TraceEvent::Kind kind;
+    uint8_t type;               // SchedulerCallback_t or InterfaceCall_t
+    unsigned args[3];           // BEGIN: args[0] is the subject
+    uint64_t value;             // BEGIN: time; END: unused; CALL: value or pool index
+    size_t match;               // BEGIN: index of its END
+};
+
+static vector<Entry> trace;
+static vector<double> reals;
+static vector<MachineInfo_t> machines;
+static vector<VMInfo_t> vms;
+static vector<TaskInfo_t> tasks;
+static map<tuple<unsigned, unsigned, unsigned, unsigned>, vector<size_t>> occurrences;    // (call, args) -> CALL entries, in order
+
+static tuple<unsigned, unsigned, unsigned, unsigned> Key(InterfaceCall_t call, const unsigned * args) {
+    return make_tuple(unsigned(call), args[0], args[1], args[2]);
+}
+
+static void Load(const string & filename) {
+    TraceReader reader;
+    reader.Open(filename);
+    vector<size_t> open;
+    map<unsigned, size_t> last_machine, last_vm, last_task;     // id -> pool index
+
+    // Reuses the last pool entry for this id unless the answer changed
+    auto pool = [](auto & items, map<unsigned, size_t> & last, unsigned id, bool changed, const auto & item) {
+        auto it = last.find(id);
+        if (it != last.end() && !changed) return uint64_t(it->second);
+        items.push_back(item);
+        last[id] = items.size() - 1;
+        return uint64_t(items.size() - 1);
+    };
+
+    TraceEvent e;
+    while (reader.Next(e)) {
+        Entry entry = {e.kind, 0, {0, 0, 0}, 0, 0};
+        switch (e.kind) {
+            case TraceEvent::BEGIN:
+                entry.type = e.callback;
+                entry.args[0] = e.subject;
+                entry.value = e.time;
+                open.push_back(trace.size());
+                break;
+            case TraceEvent::END:
+                if (open.empty()) throw runtime_error("unbalanced callback end in " + filename);
+                trace[open.back()].match = trace.size();
+                open.pop_back();
+                break;
+            case TraceEvent::CALL:
+                entry.type = e.call;
+                memcpy(entry.args, e.args, sizeof(entry.args));
+                switch (ResponseKind(e.call)) {
+                    case RESPONSE_NONE:     break;
+                    case RESPONSE_VALUE:    entry.value = e.value; break;
+                    case RESPONSE_REAL:     reals.push_back(e.real); entry.value = reals.size() - 1; break;
+                    case RESPONSE_MACHINE:  entry.value = pool(machines, last_machine, e.args[0], e.changed, e.machine); break;
+                    case RESPONSE_VM:       entry.value = pool(vms, last_vm, e.args[0], e.changed, e.vm); break;
+                    case RESPONSE_TASK:     entry.value = pool(tasks, last_task, e.args[0], e.changed, e.task); break;
+                }
+                occurrences[Key(e.call, e.args)].push_back(trace.size());
+                break;
+        }
+        trace.push_back(entry);
+    }
+    // A trace cut short (a crashed run) is closed at its end
+    while (!open.empty()) {
+        trace.push_back({TraceEvent::END, 0, {0, 0, 0}, 0, 0});
+        trace[open.back()].match = trace.size() - 1;
+        open.pop_back();
+    }
+}
+
+// Replay state
+
+struct Results {
+    uint64_t callbacks[NUM_CALLBACKS];
+    uint64_t ns[NUM_CALLBACKS];
+    uint64_t p50[NUM_CALLBACKS], p90[NUM_CALLBACKS], p99[NUM_CALLBACKS], max[NUM_CALLBACKS];
+    uint64_t nested;
+    uint64_t strict, loose, defaults;
+    uint64_t skipped_calls;             // Traced calls the scheduler did not make
+    uint64_t skipped_callbacks;         // Nested callbacks not delivered because their command was not issued
+    uint64_t errors;                    // Callbacks that ended in ThrowException
+    uint64_t wall_ns;
+};
+
+static Results results;
+static size_t cursor;
+static vector<size_t> open_callbacks;   // BEGIN indices of the callbacks being delivered
+static Time_t current_time;
+static VMId_t next_vm_id;
+static bool strict_match;                // Whether the last Match() consumed the next traced call
+
+static void Deliver(size_t begin);
+
+// Finds the entry answering 'call'. Returns trace.size() if it was never answered.
+static size_t Match(InterfaceCall_t call, unsigned a0, unsigned a1, unsigned a2) {
+    unsigned args[3] = {a0, a1, a2};
+    strict_match = false;
+    size_t end = open_callbacks.empty() ? trace.size() : trace[open_callbacks.back()].match;
+    if (cursor < end && trace[cursor].kind == TraceEvent::CALL && trace[cursor].type == call &&
+        memcmp(trace[cursor].args, args, sizeof(args)) == 0) {
+        results.strict++;
+        strict_match = true;
+        return cursor++;
+    }
+
+    // Later in this callback, skipping callbacks nested in it
+    for (size_t i = cursor; i < end; i++) {
+        if (trace[i].kind == TraceEvent::BEGIN) i = trace[i].match;
+        else if (trace[i].kind == TraceEvent::CALL && trace[i].type == call &&
+                 memcmp(trace[i].args, args, sizeof(args)) == 0) {
+            results.loose++;
+            return i;
+        }
+    }
+    // Earlier in the trace
+    auto it = occurrences.find(Key(call, args));
+    if (it != occurrences.end()) {
+        auto later = lower_bound(it->second.begin(), it->second.end(), cursor);
+        if (later != it->second.begin()) {
+            results.loose++;
+            return *(later - 1);
+        }
+    }
+    results.defaults++;
+    return trace.size();
+}
+
+// Delivers the callbacks traced right after a command the scheduler just issued
+static void Command(InterfaceCall_t call, unsigned a0 = 0, unsigned a1 = 0, unsigned a2 = 0) {
+    Match(call, a0, a1, a2);
+    if (!strict_match) return;
+    while (cursor < trace.size() && trace[cursor].kind == TraceEvent::BEGIN) {
+        results.nested++;
+        Deliver(cursor);
+    }
+}
+
+static void Dispatch(SchedulerCallback_t callback, Time_t time, unsigned subject) {
+    switch (callback) {
+        case CB_INIT:                   InitScheduler(); break;
+        case CB_NEW_TASK:               HandleNewTask(time, subject); break;
+        case CB_TASK_COMPLETION:        HandleTaskCompletion(time, subject); break;
+        case CB_MEMORY_WARNING:         MemoryWarning(time, subject); break;
+        case CB_MIGRATION_DONE:         MigrationDone(time, subject); break;
+        case CB_SCHEDULER_CHECK:        SchedulerCheck(time); break;
+        case CB_SIMULATION_COMPLETE:    SimulationComplete(time); break;
+        case CB_SLA_WARNING:            SLAWarning(time, subject); break;
+        case CB_STATE_CHANGE_COMPLETE:  StateChangeComplete(time, subject); break;
+    }
+}
+
+static void Deliver(size_t begin) {
+    const Entry & e = trace[begin];
+    Time_t outer_time = current_time;
+    open_callbacks.push_back(begin);
+    current_time = e.value;
+    cursor = begin + 1;
+    Dispatch(SchedulerCallback_t(e.type), e.value, e.args[0]);
+
+    // Whatever the scheduler did not ask for is skipped
+    for (size_t i = cursor; i < e.match; i++) {
+        if (trace[i].kind == TraceEvent::CALL) results.skipped_calls++;
+        else if (trace[i].kind == TraceEvent::BEGIN) results.skipped_callbacks++;
+    }
+    cursor = e.match + 1;
+    open_callbacks.pop_back();
+    current_time = outer_time;
+}
+
+// Nearest-rank percentile of sorted durations
+static uint64_t Percentile(const vector<uint64_t> & sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = size_t(p / 100.0 * sorted.size() + 0.5);
+    return sorted[min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+static void Run() {
+    memset(&results, 0, sizeof(results));
+    vector<uint64_t> durations[NUM_CALLBACKS];
+    auto start = chrono::steady_clock::now();
+    cursor = 0;
+    while (cursor < trace.size()) {
+        size_t begin = cursor;
+        const Entry & e = trace[begin];
+        if (e.kind != TraceEvent::BEGIN) {
+            cursor++;
+            continue;
+        }
+        auto t0 = chrono::steady_clock::now();
+        try {
+            Deliver(begin);
+        } catch (const exception & ex) {
+            results.errors++;
+            open_callbacks.clear();
+            cursor = e.match + 1;
+        }
+        auto t1 = chrono::steady_clock::now();
+        uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+        results.callbacks[e.type]++;
+        results.ns[e.type] += ns;
+        durations[e.type].push_back(ns);
+    }
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        sort(durations[c].begin(), durations[c].end());
+        results.p50[c] = Percentile(durations[c], 50);
+        results.p90[c] = Percentile(durations[c], 90);
+        results.p99[c] = Percentile(durations[c], 99);
+        results.max[c] = durations[c].empty() ? 0 : durations[c].back();
+    }
+    results.wall_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
+// Interfaces.h, answered from the trace
+
+static bool verbose = false;
+
+void SimOutput(string msg, unsigned verbose_level) {
+    if (verbose) cerr << msg << endl;
+}
+
+void ThrowException(string err_msg) {
+    throw runtime_error(err_msg);
+}
+
+void ThrowException(string err_msg, string further_input) {
+    throw runtime_error(err_msg + further_input);
+}
+
+void ThrowException(string err_msg, unsigned further_input) {
+    throw runtime_error(err_msg + to_string(further_input));
+}
+
+static uint64_t Value(InterfaceCall_t call, unsigned a0 = 0, uint64_t fallback = 0) {
+    size_t at = Match(call, a0, 0, 0);
+    return at < trace.size() ? trace[at].value : fallback;
+}
+
+CPUType_t Machine_GetCPUType(MachineId_t machine_id) {
+    return CPUType_t(Value(CALL_MACHINE_GET_CPU_TYPE, machine_id));
+}
+
+uint64_t Machine_GetEnergy(MachineId_t machine_id) {
+    return Value(CALL_MACHINE_GET_ENERGY, machine_id);
+}
+
+double Machine_GetClusterEnergy() {
+    size_t at = Match(CALL_MACHINE_GET_CLUSTER_ENERGY, 0, 0, 0);
+    return at < trace.size() ? reals[trace[at].value] : 0.0;
+}
+
+MachineInfo_t Machine_GetInfo(MachineId_t machine_id) {
+    size_t at = Match(CALL_MACHINE_GET_INFO, machine_id, 0, 0);
+    if (at < trace.size()) return machines[trace[at].value];
+    MachineInfo_t info = {};
+    info.machine_id = machine_id;
+    return info;
+}
+
+unsigned Machine_GetTotal() {
+    return unsigned(Value(CALL_MACHINE_GET_TOTAL));
+}
+
+void Machine_SetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state) {
+    Command(CALL_MACHINE_SET_CORE_PERFORMANCE, machine_id, core_id, p_state);
+}
+
+void Machine_SetState(MachineId_t machine_id, MachineState_t s_state) {
+    Command(CALL_MACHINE_SET_STATE, machine_id, s_state);
+}
+
+double GetSLAReport(SLAType_t sla) {
+    size_t at = Match(CALL_GET_SLA_REPORT, sla, 0, 0);
+    return at < trace.size() ? reals[trace[at].value] : 0.0;
+}
+
+// Within a callback the simulator's clock is the callback's time, so an
+// untraced Now() (InitScheduler asks before the trace is open) is not a miss.
+Time_t Now() {
+    if (cursor < trace.size() && trace[cursor].kind == TraceEvent::CALL && trace[cursor].type == CALL_NOW) {
+        results.strict++;
+        return trace[cursor++].value;
+    }
+    return current_time;
+}
+
+unsigned GetNumTasks() {
+    return unsigned(Value(CALL_GET_NUM_TASKS));
+}
+
+TaskInfo_t GetTaskInfo(TaskId_t task_id) {
+    size_t at = Match(CALL_GET_TASK_INFO, task_id, 0, 0);
+    if (at < trace.size()) return tasks[trace[at].value];
+    TaskInfo_t info = {};
+    info.task_id = task_id;
+    return info;
+}
+
+unsigned GetTaskMemory(TaskId_t task_id) {
+    return unsigned(Value(CALL_GET_TASK_MEMORY, task_id));
+}
+
+unsigned GetTaskPriority(TaskId_t task_id) {
+    return unsigned(Value(CALL_GET_TASK_PRIORITY, task_id, MID_PRIORITY));
+}
+
+bool IsSLAViolated(TaskId_t task_id) {
+    return Value(CALL_IS_SLA_VIOLATED, task_id) != 0;
+}
+
+bool IsTaskCompleted(TaskId_t task_id) {
+    return Value(CALL_IS_TASK_COMPLETED, task_id) != 0;
+}
+
+bool IsTaskGPUCapable(TaskId_t task_id) {
+    return Value(CALL_IS_TASK_GPU_CAPABLE, task_id) != 0;
+}
+
+CPUType_t RequiredCPUType(TaskId_t task_id) {
+    return CPUType_t(Value(CALL_REQUIRED_CPU_TYPE, task_id));
+}
+
+SLAType_t RequiredSLA(TaskId_t task_id) {
+    return SLAType_t(Value(CALL_REQUIRED_SLA, task_id, SLA3));
+}
+
+VMType_t RequiredVMType(TaskId_t task_id) {
+    return VMType_t(Value(CALL_REQUIRED_VM_TYPE, task_id));
+}
+
+void SetTaskPriority(TaskId_t task_id, Priority_t priority) {
+    Command(CALL_SET_TASK_PRIORITY, task_id, priority);
+}
+
+void VM_Attach(VMId_t vm_id, MachineId_t machine_id) {
+    Command(CALL_VM_ATTACH, vm_id, machine_id);
+}
+
+void VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    Command(CALL_VM_ADD_TASK, vm_id, task_id, priority);
+}
+
+// Matched creations return the traced id; others get ids past every traced one
+VMId_t VM_Create(VMType_t vm_type, CPUType_t cpu) {
+    size_t at = Match(CALL_VM_CREATE, vm_type, cpu, 0);
+    if (strict_match) return VMId_t(trace[at].value);
+    return next_vm_id++;
+}
+
+VMInfo_t VM_GetInfo(VMId_t vm_id) {
+    size_t at = Match(CALL_VM_GET_INFO, vm_id, 0, 0);
+    if (at < trace.size()) return vms[trace[at].value];
+    VMInfo_t info = {};
+    info.vm_id = vm_id;
+    return info;
+}
+
+void VM_Migrate(VMId_t vm_id, MachineId_t machine_id) {
+    Command(CALL_VM_MIGRATE, vm_id, machine_id);
+}
+
+void VM_RemoveTask(VMId_t vm_id, TaskId_t task_id) {
+    Command(CALL_VM_REMOVE_TASK, vm_id, task_id);
+}
+
+void VM_Shutdown(VMId_t vm_id) {
+    Command(CALL_VM_SHUTDOWN, vm_id);
+}
+
+// Driver
+
+// Per-callback figures come from the fastest repetition
+static const Results & Best(const vector<Results> & runs) {
+    const Results * best = &runs[0];
+    for (auto & r : runs) {
+        if (r.wall_ns < best->wall_ns) best = &r;
+    }
+    return *best;
+}
+
+// One line per callback type, for scripts (Tools/scaling_bench.sh)
+static void ReportCSV(const vector<Results> & runs) {
+    const Results & best = Best(runs);
+    cout << "callback,count,mean_ns,p50_ns,p90_ns,p99_ns,max_ns" << endl;
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        if (best.callbacks[c] == 0) continue;
+        cout << CallbackName(SchedulerCallback_t(c)) << ',' << best.callbacks[c] << ','
+             << best.ns[c] / best.callbacks[c] << ',' << best.p50[c] << ',' << best.p90[c] << ','
+             << best.p99[c] << ',' << best.max[c] << endl;
+    }
+}
+
+static void Report(const vector<Results> & runs, const string & filename) {
+    const Results * best = &Best(runs);
+    uint64_t total_wall = 0;
+    for (auto & r : runs) total_wall += r.wall_ns;
+    uint64_t callbacks = 0, ns = 0;
+    cout << "Trace " << filename << ": " << trace.size() << " events" << endl << endl;
+    cout << left << setw(24) << "Callback" << right << setw(10) << "Count" << setw(12) << "Total ms"
+         << setw(13) << "ns/callback" << setw(11) << "p50" << setw(11) << "p99" << setw(12) << "max" << endl;
+    for (unsigned c = 0; c < NUM_CALLBACKS; c++) {
+        callbacks += best->callbacks[c];
+        ns += best->ns[c];
+        if (best->callbacks[c] == 0) continue;
+        cout << left << setw(24) << CallbackName(SchedulerCallback_t(c)) << right
+             << setw(10) << best->callbacks[c]
+             << setw(12) << fixed << setprecision(2) << best->ns[c] / 1e6
+             << setw(13) << setprecision(0) << double(best->ns[c]) / best->callbacks[c]
+             << setw(11) << best->p50[c] << setw(11) << best->p99[c] << setw(12) << best->max[c] << endl;
+    }
+    cout << left << setw(24) << "All" << right << setw(10) << callbacks
+         << setw(12) << setprecision(2) << ns / 1e6
+         << setw(13) << setprecision(0) << (callbacks ? double(ns) / callbacks : 0.0) << endl << endl;
+
+    cout << setprecision(0);
+    cout << "Nested callbacks delivered: " << best->nested << endl;
+    cout << "Throughput: " << (ns ? callbacks * 1e9 / ns : 0.0) << " callbacks/s in the scheduler" << endl;
+    if (runs.size() > 1) {
+        cout << setprecision(2) << "Wall time: best " << best->wall_ns / 1e6 << " ms, mean "
+             << total_wall / 1e6 / runs.size() << " ms over " << runs.size() << " repetitions" << endl;
+    }
+    uint64_t answers = best->strict + best->loose + best->defaults;
+    cout << setprecision(2) << "Answers: " << best->strict << " strict ("
+         << (answers ? 100.0 * best->strict / answers : 100.0) << "%), "
+         << best->loose << " loose, " << best->defaults << " default" << endl;
+    if (best->skipped_calls || best->skipped_callbacks) {
+        cout << "Skipped: " << best->skipped_calls << " traced calls, "
+             << best->skipped_callbacks << " nested callbacks (the scheduler diverged from the trace)" << endl;
+    }
+    if (best->errors) cout << "Errors: " << best->errors << " callbacks ended in an exception" << endl;
+}
+
+int main(int argc, char * argv[]) {
+    string filename;
+    unsigned repeats = 1;
+    bool csv = false;
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) repeats = unsigned(stoul(argv[++i]));
+        else if (arg == "-v") verbose = true;
+        else if (arg == "-c") csv = true;
+        else if (filename.empty() && arg[0] != '-') filename = arg;
+        else usage = true;
+    }
+    if (usage || filename.empty() || repeats == 0) {
+        cerr << "Usage: tracebench run.trace [-r repeats] [-c] [-v]" << endl;
+        return 2;
+    }
+
+    vector<Results> runs;
+    try {
+        Load(filename);
+        for (auto & e : trace) {
+            if (e.kind == TraceEvent::CALL && e.type == CALL_VM_CREATE) next_vm_id = max(next_vm_id, VMId_t(e.value + 1));
+        }
+        cout.flush();
+        for (unsigned r = 0; r < repeats; r++) {
+            int fds[2];
+            if (pipe(fds) != 0) throw runtime_error("pipe failed");
+            pid_t pid = fork();
+            if (pid < 0) throw runtime_error("fork failed");
+            if (pid == 0) {
+                close(fds[0]);
+                // The scheduler's own report (SimulationComplete) is not wanted here
+                if (!verbose && freopen("/dev/null", "w", stdout) == nullptr) _exit(1);
+                Run();
+                bool ok = write(fds[1], &results, sizeof(results)) == ssize_t(sizeof(results));
+                _exit(ok ? 0 : 1);
+            }
+            close(fds[1]);
+            Results result;
+            bool ok = read(fds[0], &result, sizeof(result)) == ssize_t(sizeof(result));
+            close(fds[0]);
+            int status;
+            waitpid(pid, &status, 0);
+            if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                throw runtime_error("repetition " + to_string(r + 1) + " failed");
+            }
+            runs.push_back(result);
+        }
+        if (csv) ReportCSV(runs);
+        else Report(runs, filename);
+        return 0;
+    } catch (const exception & e) {
+        cerr << "tracebench: " << e.what() << endl;
+        return 2;
+    }
+}
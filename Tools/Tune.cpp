@@ -0,0 +1,269 @@
+//
+//  Tune.cpp
+//  CloudSim
+//
+//  Offline autotuner for the scheduler's knobs (SchedulerParams.hpp). Treats a
+//  full run over the workloads as a black box and minimizes
+//      objective = mean over workloads of energy / base energy
+//                + penalty * total SLA overshoot
+//  where the overshoot of a run is how many percentage points each SLA class's
+//  violation rate exceeds its limit (--sla-limits, default 5,10,20 for
+//  SLA0..SLA2), summed. The base setting (--base, CLOUDSIM_PARAMS or the
+//  defaults) is evaluated first and normalizes the energy, so it scores 1 plus
+//  its own overshoot penalty.
+//
+//  Search: a Latin-hypercube start (--init points), then rounds of Bayesian
+//  optimization: a Gaussian process fitted to every result so far, and a batch
+//  of --batch candidates (default one per core) that maximize expected
+//  improvement, picked one after another with the earlier picks assumed to
+//  score their predicted mean. Every batch runs in parallel. Runs share the
+//  sweep's cache (ParamEval.hpp), so a sweep's results seed the tuner for free.
+//
+//  The best setting is written to -o (default scheduler.params; run with
+//  CLOUDSIM_PARAMS=scheduler.params to use it) unless it does not beat the base.
+//  --update-defaults also writes it over the defaults in SchedulerParams.hpp,
+//  so the next make simulator runs it without CLOUDSIM_PARAMS.
+//  Settings whose P-state thresholds do not fall from P0 to P2 fail without
+//  running and score worst.
+//
+//  Usage: tune --param name=lo:hi [--param ...] [--budget runs] [--init points] [--batch n]
+//              [--penalty weight] [--sla-limits a,b,c] [--seed n] [-j jobs] [--base file]
+//              [--cache file] [-o file] [--update-defaults] [--simulator path] [workload.md ...]
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "GaussianProcess.hpp"
+#include "ParamEval.hpp"
+#include "Random.hpp"
+
+struct TuneParams {
+    vector<ParamRange> ranges;
+    unsigned budget = 40;                   // Settings to evaluate, base and initial design included
+    unsigned init = 0;                      // 0: twice the number of knobs, at least 4
+    unsigned batch = 0;                     // 0: one per core
+    double penalty = 0.1;                   // Objective per SLA percentage point over the limit
+    SLALimits sla_limits;
+    uint64_t seed = 1;
+    unsigned jobs = 0;
+    string base;
+    string cache = "sweep_cache.tsv";
+    string output = "scheduler.params";
+    bool update_defaults = false;
+    string simulator = "./simulator";
+    vector<string> workloads;
+};
+
+struct Trial {
+    SchedulerParams setting;
+    vector<double> point;                   // In the unit cube, after rounding
+    double objective;
+    double energy;                          // Mean of energy / base energy
+    double overshoot;
+    bool ok;
+};
+
+static Trial Score(const TuneParams & params, const SchedulerParams & setting, const vector<SimResult> & runs,
+                   const vector<double> & base_energy) {
+    Trial trial;
+    trial.setting = setting;
+    for (auto & range : params.ranges) {
+        trial.point.push_back(range.hi > range.lo ? (setting.*range.spec->field - range.lo) / (range.hi - range.lo) : 0.5);
+    }
+    trial.ok = true;
+    trial.energy = trial.overshoot = 0;
+    for (size_t w = 0; w < runs.size(); w++) {
+        if (!runs[w].ok) {
+            trial.ok = false;
+            continue;
+        }
+        trial.energy += base_energy.empty() ? 1 : runs[w].energy_kwh / base_energy[w];
+        for (int s = 0; s < 3; s++) trial.overshoot += max(0.0, runs[w].sla[s] - params.sla_limits.percent[s]);
+    }
+    trial.energy /= runs.size();
+    trial.objective = trial.ok ? trial.energy + params.penalty * trial.overshoot : INFINITY;
+    return trial;
+}
+
+static TuneParams ParseArgs(int argc, char * argv[]) {
+    TuneParams params;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--param") params.ranges.push_back(ParseParamRange(value()));
+        else if (arg == "--budget") params.budget = unsigned(stoul(value()));
+        else if (arg == "--init") params.init = unsigned(stoul(value()));
+        else if (arg == "--batch") params.batch = unsigned(stoul(value()));
+        else if (arg == "--penalty") params.penalty = stod(value());
+        else if (arg == "--sla-limits") params.sla_limits.Parse(value());
+        else if (arg == "--seed") params.seed = stoull(value());
+        else if (arg == "-j") params.jobs = unsigned(stoul(value()));
+        else if (arg == "--base") params.base = value();
+        else if (arg == "--cache") params.cache = value();
+        else if (arg == "-o") params.output = value();
+        else if (arg == "--update-defaults") params.update_defaults = true;
+        else if (arg == "--simulator") params.simulator = value();
+        else if (!arg.empty() && arg[0] == '-') throw runtime_error("unknown option " + arg);
+        else params.workloads.push_back(arg);
+    }
+    if (params.ranges.empty()) {
+        string names;
+        for (unsigned i = 0; i < kSchedulerParamCount; i++) names += string(" ") + kSchedulerParams[i].name;
+        throw runtime_error("nothing to tune; give --param name=lo:hi for some of" + names);
+    }
+    if (params.init == 0) params.init = max(4u, 2 * unsigned(params.ranges.size()));
+    if (params.batch == 0) params.batch = unsigned(max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+    if (params.budget < params.init + 1) throw runtime_error("--budget must leave room for the base and --init points");
+    if (params.workloads.empty()) params.workloads = ListWorkloads();
+    return params;
+}
+
+// Rewrites the "double name = value;" defaults of SchedulerParams.hpp, keeping
+// the comments where they were
+static void UpdateDefaults(const string & header, const SchedulerParams & setting) {
+    ifstream in(header);
+    if (!in) throw runtime_error("could not read " + header);
+    ostringstream text;
+    text << in.rdbuf();
+    string source = text.str();
+    for (unsigned i = 0; i < kSchedulerParamCount; i++) {
+        regex line(string("(double ") + kSchedulerParams[i].name + " = )([^;]*;)( *)");
+        smatch match;
+        if (!regex_search(source, match, line)) throw runtime_error(header + ": no default for " + kSchedulerParams[i].name);
+        ostringstream value;
+        value << setprecision(10) << setting.*kSchedulerParams[i].field << ';';
+        size_t width = match[2].length() + match[3].length();
+        string padded = value.str() + string(value.str().size() < width ? width - value.str().size() : 1, ' ');
+        source.replace(match.position(2), width, padded);
+    }
+    ofstream out(header);
+    if (!out) throw runtime_error("could not write " + header);
+    out << source;
+}
+
+static void Report(const string & what, const Trial & trial, const vector<ParamRange> & ranges) {
+    cout << left << setw(10) << what << right << fixed << setprecision(4) << setw(10) << trial.objective
+         << setw(10) << trial.energy << setw(10) << setprecision(2) << trial.overshoot << "  "
+         << ParamsText(trial.setting, ranges) << endl;
+    cout.unsetf(ios::fixed);
+}
+
+int main(int argc, char * argv[]) {
+    try {
+        TuneParams params = ParseArgs(argc, argv);
+        if (params.base.empty()) params.base = SchedulerParamsFile();
+        SchedulerParams base = params.base.empty() ? SchedulerParams() : ReadSchedulerParams(params.base);
+        ParamEvaluator evaluator(params.simulator, params.workloads, params.cache, params.jobs);
+        unsigned dims = unsigned(params.ranges.size());
+
+        vector<SimResult> base_runs = evaluator.Evaluate({base})[0];
+        vector<double> base_energy;
+        for (auto & r : base_runs) {
+            if (!r.ok) throw runtime_error("base setting failed on " + r.workload + ": " + r.error);
+            base_energy.push_back(r.energy_kwh);
+        }
+        Trial base_trial = Score(params, base, base_runs, base_energy);
+        cout << left << setw(10) << "" << right << setw(10) << "Objective" << setw(10) << "Energy" << setw(10) << "Overshoot" << endl;
+        Report("base", base_trial, params.ranges);
+
+        vector<Trial> trials;
+        set<string> seen = {ParamsText(base)};
+        Trial best = base_trial;
+        auto evaluate = [&](const vector<SchedulerParams> & settings, const string & what) {
+            vector<vector<SimResult>> runs = evaluator.Evaluate(settings);
+            for (size_t i = 0; i < settings.size(); i++) {
+                trials.push_back(Score(params, settings[i], runs[i], base_energy));
+                if (trials.back().objective < best.objective) best = trials.back();
+            }
+            Report(what, best, params.ranges);
+        };
+
+        vector<SchedulerParams> initial;
+        for (auto & point : LatinHypercube(params.init, dims, params.seed)) {
+            SchedulerParams setting = AtPoint(base, params.ranges, point);
+            if (seen.insert(ParamsText(setting)).second) initial.push_back(setting);
+        }
+        evaluate(initial, "init");
+
+        Rng rng(DeriveSeed(params.seed, 1));
+        unsigned round = 0;
+        while (trials.size() + 1 < params.budget) {
+            // Failed runs count as the worst result seen, so the search steers away from them
+            double worst = base_trial.objective;
+            for (auto & t : trials) {
+                if (t.ok) worst = max(worst, t.objective);
+            }
+            vector<vector<double>> x = {base_trial.point};
+            vector<double> y = {base_trial.objective};
+            for (auto & t : trials) {
+                x.push_back(t.point);
+                y.push_back(t.ok ? t.objective : worst);
+            }
+            GaussianProcess gp;
+            gp.Fit(x, y);
+            double scale = gp.LengthScale();
+
+            vector<SchedulerParams> batch;
+            unsigned want = min(params.batch, params.budget - 1 - unsigned(trials.size()));
+            for (unsigned attempts = 0; batch.size() < want && attempts < 20 * want; attempts++) {
+                double incumbent = *min_element(y.begin(), y.end());
+                double best_ei = -1;
+                vector<double> best_point;
+                for (unsigned c = 0; c < 2000; c++) {
+                    vector<double> point(dims);
+                    for (unsigned d = 0; d < dims; d++) {
+                        // A quarter of the candidates stay near the incumbent
+                        point[d] = c % 4 == 0 && best.ok ? best.point[d] + rng.Uniform(-0.1, 0.1) : rng.Uniform();
+                        point[d] = min(1.0, max(0.0, point[d]));
+                    }
+                    auto [mean, sd] = gp.Predict(point);
+                    double ei = ExpectedImprovement(mean, sd, incumbent);
+                    if (ei > best_ei) {
+                        best_ei = ei;
+                        best_point = point;
+                    }
+                }
+                SchedulerParams setting = AtPoint(base, params.ranges, best_point);
+                x.push_back(best_point);
+                y.push_back(gp.Predict(best_point).first);
+                gp.Fit(x, y, scale);
+                if (seen.insert(ParamsText(setting)).second) batch.push_back(setting);
+            }
+            if (batch.empty()) break;           // Every candidate rounds to a setting already tried
+            evaluate(batch, "round " + to_string(++round));
+        }
+
+        cout << endl << trials.size() + 1 << " settings evaluated, " << evaluator.Ran() << " runs, "
+             << evaluator.Cached() << " from " << params.cache << endl;
+        if (!(best.objective < base_trial.objective)) {
+            cout << "Nothing beat the base setting; " << params.output << " left alone" << endl;
+            return 0;
+        }
+        ofstream out(params.output);
+        if (!out) throw runtime_error("could not write " + params.output);
+        out << "# Written by tune: objective " << best.objective << " against " << base_trial.objective
+            << " for the base, over " << params.workloads.size() << " workloads" << endl;
+        WriteSchedulerParams(out, best.setting);
+        cout << "Best setting written to " << params.output << endl;
+        if (params.update_defaults) {
+            UpdateDefaults("SchedulerParams.hpp", best.setting);
+            cout << "Defaults in SchedulerParams.hpp updated; make simulator to build them in" << endl;
+        }
+        return 0;
+    } catch (const exception & e) {
+        cerr << "tune: " << e.what() << endl;
+        return 2;
+    }
+}
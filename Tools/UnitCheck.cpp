@@ -0,0 +1,495 @@
+//
+//  UnitCheck.cpp
+//  CloudSim
+//
+//  Round-trip and known-value checks of the pieces a whole simulator run cannot
+//  see into: the expansion of extended task classes (each task arrives where it
+//  was sampled), varint and zigzag coding, the callback trace (CSCT) and
+//  telemetry (CSTM) formats including telemetry downsampling, Student-t
+//  quantiles, the Gaussian process posterior on a toy function and the latency
+//  histogram's bucket edges. make check runs it.
+//
+//  With --simulator, an expanded workload is also run through that simulator
+//  at -v 3 and the arrivals it reports must be the expected ones.
+//
+//  Prints each failed check and exits 1 if any failed.
+//
+//  Usage: unitcheck [--simulator ./simulator]
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "Arrivals.hpp"
+#include "CallbackTrace.hpp"
+#include "GaussianProcess.hpp"
+#include "LatencyHistogram.hpp"
+#include "Stats.hpp"
+#include "Telemetry.hpp"
+#include "Varint.hpp"
+
+static unsigned checks = 0, failures = 0;
+
+static void Check(bool ok, const string & what) {
+    checks++;
+    if (ok) return;
+    failures++;
+    cerr << "unitcheck: FAILED " << what << endl;
+}
+
+static void Near(double got, double want, double tolerance, const string & what) {
+    ostringstream text;
+    text.precision(10);
+    text << what << ": got " << got << ", expected " << want;
+    Check(fabs(got - want) <= tolerance, text.str());
+}
+
+// A file in the temporary directory, removed when it goes out of scope
+class TempFile {
+public:
+    explicit TempFile(const string & suffix)
+        : path((filesystem::temp_directory_path() / ("unitcheck." + to_string(getpid()) + suffix)).string()) {}
+    ~TempFile() { remove(path.c_str()); }
+    const string path;
+};
+
+static TaskClass TestTaskClass(const string & process, const string & runtime, uint64_t seed) {
+    TaskClass tc;
+    tc.start = 1000000;
+    tc.end = 61000000;
+    tc.inter_arrival = 200000;
+    tc.expected_runtime = 100000;
+    tc.memory = 8;
+    tc.vm = LINUX;
+    tc.gpu = false;
+    tc.sla = SLA2;
+    tc.cpu = X86;
+    tc.task_type = "WEB";
+    tc.seed = seed;
+    if (process != "constant") tc.extra["Arrival process"] = process;
+    if (runtime != "constant") tc.extra["Runtime distribution"] = runtime;
+    if (process == "mmpp") {
+        tc.extra["On period"] = "5000000";
+        tc.extra["Off period"] = "10000000";
+    }
+    return tc;
+}
+
+// The simulator's arrivals for the expanded classes, in order
+static vector<Time_t> ExpandedArrivals(const vector<TaskClass> & classes) {
+    vector<Time_t> arrivals;
+    for (auto & tc : classes) {
+        vector<Time_t> some = PlainArrivals(tc);
+        arrivals.insert(arrivals.end(), some.begin(), some.end());
+    }
+    sort(arrivals.begin(), arrivals.end());
+    return arrivals;
+}
+
+static void CheckArrivals() {
+    // What the simulator reports for Seed 7, Inter arrival 1 from 0 ("added at")
+    TaskClass known = TestTaskClass("constant", "constant", 7);
+    known.start = 0;
+    known.end = 6;
+    known.inter_arrival = 1;
+    Check(PlainArrivals(known) == vector<Time_t>({0, 3, 3, 3, 3, 5, 5, 6}), "simulator arrivals of a plain class");
+
+    // One class per arrival, each with exactly one task where it was sampled
+    for (auto kind : {make_pair("constant", "lognormal"), make_pair("diurnal", "pareto"), make_pair("poisson", "pareto")}) {
+        string what = string(kind.first) + " arrivals with " + kind.second + " runtimes";
+        TaskClass tc = TestTaskClass(kind.first, kind.second, 520230);
+        vector<TaskClass> classes = ExpandTaskClass(tc);
+        bool single = true;
+        for (auto & c : classes) single = single && PlainArrivals(c).size() == 1 && !IsExtendedTaskClass(c);
+        Check(!classes.empty() && single, what + ": one plain class per task");
+        Check(ExpandedArrivals(classes) == SampleArrivals(tc), what + ": tasks arrive where they were sampled");
+    }
+    TaskClass from_zero = TestTaskClass("constant", "pareto", 1);
+    from_zero.start = 0;
+    vector<Time_t> arrivals = ExpandedArrivals(ExpandTaskClass(from_zero));
+    Check(!arrivals.empty() && arrivals[0] == 1 && arrivals.size() == SampleArrivals(from_zero).size(), "an arrival sampled at 0 arrives at 1");
+
+    // A poisson class stays one class and an mmpp class becomes one per on phase,
+    // with every task inside the class window and the expected count on average
+    for (auto process : {"poisson", "mmpp"}) {
+        bool inside = true, one_class = true;
+        double tasks = 0, expected = 0;
+        for (uint64_t seed = 1; seed <= 50; seed++) {
+            // Long enough that starting in an on phase hardly matters
+            TaskClass tc = TestTaskClass(process, "constant", seed);
+            tc.end = 601000000;
+            vector<TaskClass> classes = ExpandTaskClass(tc);
+            arrivals = ExpandedArrivals(classes);
+            inside = inside && (arrivals.empty() || (arrivals.front() >= tc.start && arrivals.back() < tc.end));
+            one_class = one_class && classes.size() <= 1;
+            tasks += arrivals.size();
+            expected += Workload{{}, {tc}}.EstimatedTasks();
+        }
+        Check(inside, string(process) + ": every task within the class window");
+        Near(tasks / expected, 1, 0.05, string(process) + ": tasks over the expected count");
+        if (string(process) == "poisson") Check(one_class, "poisson: one class");
+    }
+}
+
+// Runs an expanded workload through the simulator and compares the arrivals it reports
+static void CheckSimulatorArrivals(const string & simulator) {
+    Workload w;
+    w.machines.push_back({4, X86, 8, 16384, {120, 100, 100, 80, 40, 10, 0}, {12, 8, 6, 4}, {12, 3, 1, 0}, {1000, 800, 600, 400}, false});
+    w.tasks = {TestTaskClass("diurnal", "pareto", 11), TestTaskClass("mmpp", "constant", 12), TestTaskClass("poisson", "constant", 13)};
+    ExpandWorkload(w);
+    TempFile file(".md");
+    {
+        ofstream out(file.path);
+        WriteWorkload(out, w);
+    }
+    FILE * run = popen((simulator + " -v 3 " + file.path + " 2>&1").c_str(), "r");
+    if (!run) throw runtime_error("could not run " + simulator);
+    vector<Time_t> reported;
+    char line[4096];
+    while (fgets(line, sizeof(line), run)) {
+        const char * added = strstr(line, " added at ");
+        if (added) reported.push_back(stoull(added + 10));
+    }
+    int status = pclose(run);
+    Check(status == 0, simulator + " runs the expanded workload");
+    sort(reported.begin(), reported.end());
+    Check(!reported.empty() && reported == ExpandedArrivals(w.tasks), simulator + " arrivals match the expansion");
+}
+
+static void CheckVarint() {
+    const uint64_t values[] = {0, 1, 127, 128, 300, 16383, 16384, uint64_t(1) << 32, ~uint64_t(0)};
+    const size_t sizes[] = {1, 1, 1, 2, 2, 2, 3, 5, 10};
+    string buffer;
+    for (unsigned i = 0; i < 9; i++) {
+        string one;
+        PutVarint(one, values[i]);
+        Check(one.size() == sizes[i], "varint size of " + to_string(values[i]));
+        buffer += one;
+    }
+    size_t at = 0;
+    istringstream stream(buffer);
+    for (uint64_t want : values) {
+        uint64_t got = 0, streamed = 0;
+        Check(GetVarint(buffer, at, got) && got == want, "varint round trip of " + to_string(want));
+        Check(GetVarint(stream, streamed) && streamed == want, "streamed varint round trip of " + to_string(want));
+    }
+    uint64_t rest;
+    Check(!GetVarint(buffer, at, rest), "varint read past the end");
+    string truncated = buffer.substr(0, buffer.size() - 1);
+    at = truncated.size() - 9;
+    Check(!GetVarint(truncated, at, rest), "truncated varint");
+
+    // Zigzag: 0, -1, 1, -2, 2 ... map to 0, 1, 2, 3, 4 ...
+    const int64_t signed_values[] = {0, -1, 1, -2, 2, -64, 63, -65, 64, INT64_MIN, INT64_MAX};
+    const uint64_t zigzag[] = {0, 1, 2, 3, 4, 127, 126, 129, 128, ~uint64_t(0), ~uint64_t(0) - 1};
+    for (unsigned i = 0; i < 11; i++) {
+        string one;
+        PutSignedVarint(one, signed_values[i]);
+        uint64_t raw = 0;
+        int64_t got = 0;
+        at = 0;
+        Check(GetVarint(one, at, raw) && raw == zigzag[i], "zigzag code of " + to_string(signed_values[i]));
+        at = 0;
+        Check(GetSignedVarint(one, at, got) && got == signed_values[i], "zigzag round trip of " + to_string(signed_values[i]));
+    }
+}
+
+static MachineInfo_t TestMachine(MachineId_t id, unsigned tasks) {
+    MachineInfo_t info = {};
+    info.machine_id = id;
+    info.num_cpus = 8;
+    info.cpu = ARM;
+    info.memory_size = 16384;
+    info.memory_used = 1000 + tasks * 8;
+    info.active_tasks = tasks;
+    info.active_vms = 1;
+    info.gpus = true;
+    info.energy_consumed = 123456789012ull + tasks;
+    info.performance = {1000, 800, 600, 400};
+    info.p_states = {120, 100, 80, 40};
+    info.s_states = {300, 250, 200, 150, 100, 50, 0};
+    info.s_state = S0;
+    info.p_state = P1;
+    return info;
+}
+
+static bool SameMachine(const MachineInfo_t & a, const MachineInfo_t & b) {
+    return a.machine_id == b.machine_id && a.num_cpus == b.num_cpus && a.cpu == b.cpu && a.memory_size == b.memory_size &&
+           a.memory_used == b.memory_used && a.active_tasks == b.active_tasks && a.active_vms == b.active_vms &&
+           a.gpus == b.gpus && a.energy_consumed == b.energy_consumed && a.performance == b.performance &&
+           a.c_states == b.c_states && a.p_states == b.p_states && a.s_states == b.s_states && a.s_state == b.s_state &&
+           a.p_state == b.p_state;
+}
+
+static void CheckTrace() {
+    TempFile file(".trace");
+    MachineInfo_t first = TestMachine(3, 2), second = TestMachine(3, 5);
+    VMInfo_t vm = {};
+    vm.vm_id = 7;
+    vm.machine_id = 3;
+    vm.cpu = ARM;
+    vm.vm_type = LINUX_RT;
+    vm.active_tasks = {5, 9};
+    TaskInfo_t task = {};
+    task.task_id = 5;
+    task.total_instructions = 5000000000ull;
+    task.remaining_instructions = 4000000000ull;
+    task.arrival = 1000;
+    task.target_completion = 9000000;
+    task.priority = HIGH_PRIORITY;
+    task.required_cpu = ARM;
+    task.required_memory = 512;
+    task.required_sla = SLA1;
+    task.required_vm = LINUX_RT;
+
+    TraceWriter writer;
+    Check(writer.Open(file.path), "open the trace for writing");
+    writer.Begin(CB_NEW_TASK, 5000000, 5);
+    writer.Call(CALL_MACHINE_GET_INFO, 3);
+    writer.Machine(first);
+    writer.Call(CALL_MACHINE_GET_INFO, 3);
+    writer.Machine(first);
+    writer.Call(CALL_MACHINE_GET_INFO, 3);
+    writer.Machine(second);
+    writer.Call(CALL_NOW);
+    writer.Value(5000000);
+    writer.Call(CALL_MACHINE_GET_CLUSTER_ENERGY);
+    writer.Real(0.125);
+    writer.Call(CALL_VM_CREATE, LINUX_RT, ARM);
+    writer.Value(7);
+    writer.Call(CALL_VM_ADD_TASK, 7, 5, HIGH_PRIORITY);
+    // A callback delivered from inside a command, at an earlier time than the outer one
+    writer.Begin(CB_STATE_CHANGE_COMPLETE, 4000000, 3);
+    writer.End();
+    writer.Call(CALL_VM_GET_INFO, 7);
+    writer.VM(vm);
+    writer.Call(CALL_GET_TASK_INFO, 5);
+    writer.Task(task);
+    writer.End();
+    writer.Close();
+
+    TraceReader reader;
+    reader.Open(file.path);
+    TraceEvent e;
+    auto next = [&](TraceEvent::Kind kind, const string & what) {
+        bool ok = reader.Next(e) && e.kind == kind;
+        Check(ok, "trace event: " + what);
+        return ok;
+    };
+    if (next(TraceEvent::BEGIN, "begin")) {
+        Check(e.callback == CB_NEW_TASK && e.time == 5000000 && e.subject == 5, "trace begin fields");
+    }
+    if (next(TraceEvent::CALL, "machine info")) {
+        Check(e.call == CALL_MACHINE_GET_INFO && e.args[0] == 3 && SameMachine(e.machine, first) && e.changed, "trace machine info");
+    }
+    if (next(TraceEvent::CALL, "repeated machine info")) {
+        Check(SameMachine(e.machine, first) && !e.changed, "trace repeated machine info is unchanged");
+    }
+    if (next(TraceEvent::CALL, "changed machine info")) {
+        Check(SameMachine(e.machine, second) && e.changed, "trace machine info delta");
+    }
+    if (next(TraceEvent::CALL, "now")) Check(e.call == CALL_NOW && e.value == 5000000, "trace value answer");
+    if (next(TraceEvent::CALL, "cluster energy")) Check(e.real == 0.125, "trace real answer");
+    if (next(TraceEvent::CALL, "vm create")) {
+        Check(e.call == CALL_VM_CREATE && e.args[0] == LINUX_RT && e.args[1] == ARM && e.value == 7, "trace VM_Create");
+    }
+    if (next(TraceEvent::CALL, "add task")) {
+        Check(e.call == CALL_VM_ADD_TASK && e.args[0] == 7 && e.args[1] == 5 && e.args[2] == HIGH_PRIORITY, "trace command arguments");
+    }
+    if (next(TraceEvent::BEGIN, "nested begin")) {
+        Check(e.callback == CB_STATE_CHANGE_COMPLETE && e.time == 4000000 && e.subject == 3, "trace nested begin going back in time");
+    }
+    next(TraceEvent::END, "nested end");
+    if (next(TraceEvent::CALL, "vm info")) {
+        Check(e.vm.vm_id == 7 && e.vm.machine_id == 3 && e.vm.cpu == ARM && e.vm.vm_type == LINUX_RT &&
+              e.vm.active_tasks == vm.active_tasks, "trace VM info");
+    }
+    if (next(TraceEvent::CALL, "task info")) {
+        const TaskInfo_t & t = e.task;
+        Check(t.task_id == 5 && t.total_instructions == task.total_instructions &&
+              t.remaining_instructions == task.remaining_instructions && t.arrival == task.arrival &&
+              t.target_completion == task.target_completion && t.priority == task.priority && t.required_cpu == ARM &&
+              t.required_memory == 512 && t.required_sla == SLA1 && t.required_vm == LINUX_RT, "trace task info");
+    }
+    next(TraceEvent::END, "end");
+    Check(!reader.Next(e), "trace ends after the last event");
+}
+
+// Machine m's value of column c at the check-th SchedulerCheck
+static int64_t TelemetryValue(uint64_t check, unsigned m, unsigned c) {
+    switch (c) {
+        case TM_S_STATE:        return (check / 3 + m) % 2 ? S3 : S0;
+        case TM_P_STATE:        return check % P_STATES;
+        case TM_TASKS:          return (check * 7 + m) % 11;
+        case TM_VMS:            return m;
+        case TM_MEMORY_USED:    return 1000 + (check * 13 + m) % 97;
+        default:                return int64_t(check * 1000000 * (m + 1));
+    }
+}
+
+// Records checks SchedulerChecks 10 us apart on three machines and reads them back
+static void CheckTelemetry(const string & what, uint64_t checks, size_t budget) {
+    TempFile file(".telemetry");
+    TelemetryRecorder recorder;
+    recorder.Open(file.path, budget);
+    for (uint64_t check = 0; check < checks; check++) {
+        if (!recorder.Begin(10 * check)) continue;
+        for (unsigned m = 0; m < 3; m++) {
+            MachineInfo_t info = TestMachine(m, 0);
+            info.s_state = MachineState_t(TelemetryValue(check, m, TM_S_STATE));
+            info.p_state = CPUPerformance_t(TelemetryValue(check, m, TM_P_STATE));
+            info.active_tasks = unsigned(TelemetryValue(check, m, TM_TASKS));
+            info.active_vms = unsigned(TelemetryValue(check, m, TM_VMS));
+            info.memory_used = unsigned(TelemetryValue(check, m, TM_MEMORY_USED));
+            info.energy_consumed = uint64_t(TelemetryValue(check, m, TM_ENERGY));
+            recorder.Add(info);
+        }
+        recorder.End();
+    }
+    recorder.Close();
+
+    TelemetryReader reader;
+    reader.Open(file.path);
+    unsigned stride = reader.Stride();
+    Check(reader.Machines().size() == 3 && reader.Machines()[1].cpu == ARM && reader.Machines()[1].cores == 8 &&
+          reader.Machines()[1].memory_size == 16384 && reader.Machines()[1].gpus, what + ": machine header");
+    Check(reader.Samples() == (checks + stride - 1) / stride, what + ": one sample per " + to_string(stride) + " checks");
+    TelemetrySample sample;
+    uint64_t read = 0;
+    bool same = true;
+    while (reader.Next(sample)) {
+        uint64_t check = read++ * stride;
+        same = same && sample.time == 10 * check && sample.values.size() == 3;
+        for (unsigned m = 0; same && m < 3; m++) {
+            for (unsigned c = 0; c < NUM_TELEMETRY_COLUMNS; c++) same = same && sample.values[m][c] == TelemetryValue(check, m, c);
+        }
+    }
+    Check(same && read == reader.Samples(), what + ": samples read back");
+    if (budget) Check(stride > 1, what + ": downsampled within the budget");
+}
+
+static void CheckStudentT() {
+    // Two-sided 95% and one-sided 95% critical values from the standard tables
+    const double df[] = {1, 2, 5, 10, 30};
+    const double t975[] = {12.7062, 4.3027, 2.5706, 2.2281, 2.0423};
+    const double t95[] = {6.3138, 2.9200, 2.0150, 1.8125, 1.6973};
+    for (unsigned i = 0; i < 5; i++) {
+        string name = "t quantile, df " + to_string(int(df[i]));
+        Near(StudentTQuantile(0.975, df[i]), t975[i], 1e-3, name + ", p 0.975");
+        Near(StudentTQuantile(0.95, df[i]), t95[i], 1e-3, name + ", p 0.95");
+        Near(StudentTQuantile(0.025, df[i]), -t975[i], 1e-3, name + ", p 0.025");
+        Near(StudentTCdf(t975[i], df[i]), 0.975, 1e-5, "t cdf, df " + to_string(int(df[i])));
+        Near(StudentTCdf(0, df[i]), 0.5, 1e-12, "t cdf at 0, df " + to_string(int(df[i])));
+    }
+    Estimate e = EstimateMean({1, 2, 3, 4, 5});
+    Near(e.mean, 3, 1e-12, "mean of 1..5");
+    Near(e.stddev, sqrt(2.5), 1e-12, "sample standard deviation of 1..5");
+    Near(e.half_width, 2.7764 * sqrt(2.5) / sqrt(5.0), 1e-3, "95% half width of 1..5");
+}
+
+static void CheckGaussianProcess() {
+    // sin(2 pi x) from eight points on [0, 1]
+    auto f = [](double x) { return sin(2 * M_PI * x); };
+    vector<vector<double>> x;
+    vector<double> y;
+    for (unsigned i = 0; i < 8; i++) {
+        x.push_back({i / 7.0});
+        y.push_back(f(i / 7.0));
+    }
+    GaussianProcess gp;
+    gp.Fit(x, y);
+    for (unsigned i = 0; i < 8; i++) {
+        auto posterior = gp.Predict(x[i]);
+        Near(posterior.first, y[i], 1e-3, "GP mean at training point " + to_string(i));
+        Check(posterior.second < 1e-2, "GP standard deviation at training point " + to_string(i));
+    }
+    for (double at : {0.2, 0.45, 0.8}) {
+        auto posterior = gp.Predict({at});
+        Near(posterior.first, f(at), 0.1, "GP mean between training points at " + to_string(at));
+    }
+    // Fitted to the first half only, the far end is back at the prior: the mean of y, and uncertain
+    GaussianProcess half;
+    vector<vector<double>> x_half(x.begin(), x.begin() + 4);
+    vector<double> y_half(y.begin(), y.begin() + 4);
+    half.Fit(x_half, y_half);
+    auto far = half.Predict({0.95});
+    Near(far.first, (y_half[0] + y_half[1] + y_half[2] + y_half[3]) / 4, 1e-3, "GP mean far from the data");
+    Check(far.second > 100 * half.Predict(x_half[1]).second, "GP is uncertain far from the data");
+    // Expected improvement: with no uncertainty it is the gap, at the best value it is sd * pdf(0)
+    Near(ExpectedImprovement(0, 0, 1), 1, 1e-12, "expected improvement without uncertainty");
+    Near(ExpectedImprovement(1, 1, 1), 1 / sqrt(2 * M_PI), 1e-9, "expected improvement at the best value");
+}
+
+static void CheckHistogram() {
+    // Below 64 every value has its own bucket
+    for (uint64_t v : {0, 1, 31, 63}) {
+        LatencyHistogram h;
+        h.Record(v);
+        h.Record(uint64_t(1) << 39);
+        Check(h.Percentile(0.5) == v, "histogram exact bucket for " + to_string(v));
+    }
+    // Above, the percentile is the upper edge of the value's bucket: 64 and 65 share one,
+    // 100 is in [100, 101], 1000 in [992, 1007]
+    const uint64_t values[] = {64, 65, 66, 100, 1000, 1000000};
+    const uint64_t edges[] = {65, 65, 67, 101, 1007, 1015807};
+    for (unsigned i = 0; i < 6; i++) {
+        LatencyHistogram h;
+        h.Record(values[i]);
+        h.Record(uint64_t(1) << 39);
+        Check(h.Percentile(0.5) == edges[i], "histogram bucket edge for " + to_string(values[i]) + ": " + to_string(h.Percentile(0.5)));
+    }
+    // Within 1/32 of the value everywhere up to 2^40
+    bool within = true;
+    for (uint64_t v = 1; v < (uint64_t(1) << 40); v = v * 3 / 2 + 1) {
+        LatencyHistogram h;
+        h.Record(v);
+        h.Record(uint64_t(1) << 41);
+        uint64_t edge = h.Percentile(0.5);
+        within = within && edge >= v && edge <= v + v / 32;
+    }
+    Check(within, "histogram percentiles within 1/32 of the value");
+    // The percentile never exceeds the largest value; past 2^40 values share the last bucket
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100; v++) h.Record(v);
+    Check(h.Count() == 100 && h.Max() == 100 && h.Mean() == 50.5, "histogram count, max and mean");
+    Check(h.Percentile(0.5) == 50 && h.Percentile(0.99) == 99 && h.Percentile(1) == 100, "histogram percentiles of 1..100");
+    LatencyHistogram huge;
+    huge.Record(uint64_t(1) << 45);
+    Check(huge.Percentile(0.5) == uint64_t(1) << 45, "histogram percentile past the last bucket is the maximum");
+}
+
+int main(int argc, char * argv[]) {
+    string simulator;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--simulator" && i + 1 < argc) simulator = argv[++i];
+        else {
+            cerr << "Usage: unitcheck [--simulator ./simulator]" << endl;
+            return 2;
+        }
+    }
+    try {
+        CheckArrivals();
+        if (!simulator.empty()) CheckSimulatorArrivals(simulator);
+        CheckVarint();
+        CheckTrace();
+        CheckTelemetry("telemetry", 50, 0);
+        CheckTelemetry("telemetry downsampled", 1000, 2000);
+        CheckStudentT();
+        CheckGaussianProcess();
+        CheckHistogram();
+    } catch (const exception & e) {
+        cerr << "unitcheck: " << e.what() << endl;
+        return 2;
+    }
+    cout << "unitcheck: " << checks - failures << " of " << checks << " checks passed" << endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+//
+//  Workload.cpp
+//  CloudSim
+//
+
+#include "Workload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static string Trim(const string & s) {
+    size_t first = s.find_first_not_of(" \t\r");
+    if (first == string::npos) return "";
+    size_t last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+static vector<unsigned> ParseVector(const string & value, const string & where) {
+    if (value.size() < 2 || value.front() != '[' || value.back() != ']') {
+        throw runtime_error(where + ": expected [a, b, ...] but found '" + value + "'");
+    }
+    vector<unsigned> result;
+    stringstream ss(value.substr(1, value.size() - 2));
+    string item;
+    while (getline(ss, item, ',')) {
+        result.push_back(unsigned(stoul(Trim(item))));
+    }
+    return result;
+}
+
+static string FormatVector(const vector<unsigned> & values) {
+    string s = "[";
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i) s += ", ";
+        s += to_string(values[i]);
+    }
+    return s + "]";
+}
+
+static const string & Require(map<string, string> & fields, const string & key, const string & where) {
+    auto it = fields.find(key);
+    if (it == fields.end()) {
+        throw runtime_error(where + ": missing '" + key + "'");
+    }
+    return it->second;
+}
+
+static bool ParseYesNo(const string & value, const string & where) {
+    if (value == "yes") return true;
+    if (value == "no") return false;
+    throw runtime_error(where + ": expected yes or no but found '" + value + "'");
+}
+
+bool IsVMCompatible(VMType_t vm, CPUType_t cpu) {
+    switch (vm) {
+        case AIX: return cpu == POWER;
+        case WIN: return cpu == X86 || cpu == ARM;
+        default:  return true;
+    }
+}
+
+unsigned Workload::TotalMachines() const {
+    unsigned total = 0;
+    for (auto & mc : machines) total += mc.count;
+    return total;
+}
+
+static double ExtraNumber(const TaskClass & tc, const string & key, double fallback) {
+    auto it = tc.extra.find(key);
+    return it == tc.extra.end() ? fallback : stod(it->second);
+}
+
+uint64_t Workload::EstimatedTasks() const {
+    double total = 0;
+    for (auto & tc : tasks) {
+        if (tc.end <= tc.start || tc.inter_arrival == 0) continue;
+        double arrivals = double(tc.end - tc.start) / double(tc.inter_arrival);
+        auto process = tc.extra.find("Arrival process");
+        if (process == tc.extra.end() || process->second == "constant") {
+            arrivals = ceil(arrivals);
+        } else if (process->second == "mmpp") {
+            // The inter arrival rate only holds while on; Off rate scales it while off
+            double on = ExtraNumber(tc, "On period", 0), off = ExtraNumber(tc, "Off period", 0);
+            if (on + off > 0) arrivals *= (on + off * ExtraNumber(tc, "Off rate", 0)) / (on + off);
+        }
+        total += arrivals;
+    }
+    return uint64_t(total + 0.5);
+}
+
+Time_t Workload::Horizon() const {
+    Time_t horizon = 0;
+    for (auto & tc : tasks) horizon = max(horizon, tc.end);
+    return horizon;
+}
+
+static MachineClass MakeMachineClass(map<string, string> & f, const string & where) {
+    MachineClass mc;
+    mc.count    = unsigned(stoul(Require(f, "Number of machines", where)));
+    mc.cpu      = ParseCPU(Require(f, "CPU type", where));
+    mc.cores    = unsigned(stoul(Require(f, "Number of cores", where)));
+    mc.memory   = unsigned(stoul(Require(f, "Memory", where)));
+    mc.s_states = ParseVector(Require(f, "S-States", where), where);
+    mc.p_states = ParseVector(Require(f, "P-States", where), where);
+    mc.c_states = ParseVector(Require(f, "C-States", where), where);
+    mc.mips     = ParseVector(Require(f, "MIPS", where), where);
+    mc.gpus     = ParseYesNo(Require(f, "GPUs", where), where);
+    if (mc.s_states.size() != S_STATES || mc.p_states.size() != P_STATES ||
+        mc.c_states.size() != C_STATES || mc.mips.size() != P_STATES) {
+        throw runtime_error(where + ": power or MIPS ladder has the wrong number of entries");
+    }
+    return mc;
+}
+
+static TaskClass MakeTaskClass(map<string, string> & f, const string & where) {
+    static const char * known[] = {
+        "Start time", "End time", "Inter arrival", "Expected runtime", "Memory", "VM type",
+        "GPU enabled", "SLA type", "CPU type", "Task type", "Seed"
+    };
+    TaskClass tc;
+    tc.start            = stoull(Require(f, "Start time", where));
+    tc.end              = stoull(Require(f, "End time", where));
+    tc.inter_arrival    = stoull(Require(f, "Inter arrival", where));
+    tc.expected_runtime = stoull(Require(f, "Expected runtime", where));
+    tc.memory           = unsigned(stoul(Require(f, "Memory", where)));
+    tc.vm               = ParseVM(Require(f, "VM type", where));
+    tc.gpu              = ParseYesNo(Require(f, "GPU enabled", where), where);
+    tc.sla              = ParseSLA(Require(f, "SLA type", where));
+    tc.cpu              = ParseCPU(Require(f, "CPU type", where));
+    tc.task_type        = Require(f, "Task type", where);
+    tc.seed             = stoull(Require(f, "Seed", where));
+    for (auto & kv : f) {
+        if (find(begin(known), end(known), kv.first) == end(known)) {
+            tc.extra[kv.first] = kv.second;
+        }
+    }
+    return tc;
+}
+
+Workload ParseWorkload(istream & in, const string & name) {
+    Workload workload;
+    string line;
+    unsigned line_no = 0;
+
+    auto next_line = [&](string & out) {
+        while (getline(in, line)) {
+            line_no++;
+            out = Trim(line);
+            if (!out.empty() && out[0] != '#') return true;
+        }
+        return false;
+    };
+
+    string header;
+    while (next_line(header)) {
+        string where = name + ":" + to_string(line_no);
+        bool is_machine = header == "machine class:";
+        if (!is_machine && header != "task class:") {
+            throw runtime_error(where + ": expected 'machine class:' or 'task class:' but found '" + header + "'");
+        }
+        string text;
+        if (!next_line(text) || text != "{") {
+            throw runtime_error(where + ": expected {");
+        }
+        map<string, string> fields;
+        while (true) {
+            if (!next_line(text)) throw runtime_error(where + ": unterminated class");
+            if (text == "}") break;
+            size_t colon = text.find(':');
+            if (colon == string::npos) {
+                throw runtime_error(name + ":" + to_string(line_no) + ": expected 'keyword: value' but found '" + text + "'");
+            }
+            fields[Trim(text.substr(0, colon))] = Trim(text.substr(colon + 1));
+        }
+        if (is_machine) workload.machines.push_back(MakeMachineClass(fields, where));
+        else            workload.tasks.push_back(MakeTaskClass(fields, where));
+    }
+    return workload;
+}
+
+Workload ReadWorkload(const string & filename) {
+    ifstream in(filename);
+    if (!in) {
+        throw runtime_error("ReadWorkload(): could not open " + filename);
+    }
+    return ParseWorkload(in, filename);
+}
+
+void WriteMachineClass(ostream & out, const MachineClass & mc) {
+    out << "machine class:\n{\n"
+        << "        Number of machines: " << mc.count << "\n"
+        << "        CPU type: " << CPUName(mc.cpu) << "\n"
+        << "        Number of cores: " << mc.cores << "\n"
+        << "        Memory: " << mc.memory << "\n"
+        << "        S-States: " << FormatVector(mc.s_states) << "\n"
+        << "        P-States: " << FormatVector(mc.p_states) << "\n"
+        << "        C-States: " << FormatVector(mc.c_states) << "\n"
+        << "        MIPS: " << FormatVector(mc.mips) << "\n"
+        << "        GPUs: " << (mc.gpus ? "yes" : "no") << "\n"
+        << "}\n";
+}
+
+void WriteTaskClass(ostream & out, const TaskClass & tc) {
+    out << "task class:\n{\n"
+        << "        Start time: " << tc.start << "\n"
+        << "        End time : " << tc.end << "\n"
+        << "        Inter arrival: " << tc.inter_arrival << "\n"
+        << "        Expected runtime: " << tc.expected_runtime << "\n"
+        << "        Memory: " << tc.memory << "\n"
+        << "        VM type: " << VMName(tc.vm) << "\n"
+        << "        GPU enabled: " << (tc.gpu ? "yes" : "no") << "\n"
+        << "        SLA type: " << SLAName(tc.sla) << "\n"
+        << "        CPU type: " << CPUName(tc.cpu) << "\n"
+        << "        Task type: " << tc.task_type << "\n"
+        << "        Seed: " << tc.seed << "\n";
+    for (auto & kv : tc.extra) {
+        out << "        " << kv.first << ": " << kv.second << "\n";
+    }
+    out << "}\n";
+}
+
+void WriteWorkload(ostream & out, const Workload & workload) {
+    for (auto & mc : workload.machines) {
+        WriteMachineClass(out, mc);
+        out << "\n";
+    }
+    for (auto & tc : workload.tasks) {
+        WriteTaskClass(out, tc);
+        out << "\n";
+    }
+}
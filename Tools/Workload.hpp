@@ -0,0 +1,66 @@
+//
+//  Workload.hpp
+//  CloudSim
+//
+//  In-memory model of a workload file (the machine class / task class format
+//  read by Init()). The tools use it to read, generate and rewrite workloads.
+//
+
+#ifndef Workload_hpp
+#define Workload_hpp
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "SimTypes.h"
+#include "TypeNames.hpp"
+
+struct MachineClass {
+    unsigned count;                         // Number of machines
+    CPUType_t cpu;
+    unsigned cores;
+    unsigned memory;
+    vector<unsigned> s_states;              // Power per S-state, S0..S5
+    vector<unsigned> p_states;              // Per-core power per P-state, P0..P3
+    vector<unsigned> c_states;              // Per-core power per C-state
+    vector<unsigned> mips;                  // MIPS per P-state
+    bool gpus;
+};
+
+struct TaskClass {
+    Time_t start;
+    Time_t end;
+    Time_t inter_arrival;
+    Time_t expected_runtime;
+    unsigned memory;
+    VMType_t vm;
+    bool gpu;
+    SLAType_t sla;
+    CPUType_t cpu;
+    string task_type;                       // WEB, AI, HPC, CRYPTO or STREAM
+    uint64_t seed;
+    map<string, string> extra;              // Keys the simulator does not know about, kept verbatim
+};
+
+struct Workload {
+    vector<MachineClass> machines;
+    vector<TaskClass> tasks;
+
+    unsigned TotalMachines() const;
+    uint64_t EstimatedTasks() const;        // Expected arrivals, including the mmpp duty cycle (Arrivals.hpp)
+    Time_t Horizon() const;                 // Latest task class end time
+};
+
+// Parsing and printing. Read errors throw runtime_error with the offending line.
+Workload ReadWorkload(const string & filename);
+Workload ParseWorkload(istream & in, const string & name = "<stream>");
+void WriteWorkload(ostream & out, const Workload & workload);
+void WriteMachineClass(ostream & out, const MachineClass & mc);
+void WriteTaskClass(ostream & out, const TaskClass & tc);
+
+// True if the simulator accepts a VM of this type on this CPU
+bool IsVMCompatible(VMType_t vm, CPUType_t cpu);
+
+#endif /* Workload_hpp */
@@ -0,0 +1,51 @@
+//
+//  WorkloadExpand.cpp
+//  CloudSim
+//
+//  Rewrites a workload that uses the extended task class keys (Arrival process,
+//  Runtime distribution, ...; see Arrivals.hpp) into the plain format the
+//  simulator reads. Plain classes pass through unchanged.
+//
+//  Usage: workloadexpand input.md [-o output.md]
+//
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "Arrivals.hpp"
+
+int main(int argc, char * argv[]) {
+    string input, output;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (input.empty() && arg[0] != '-') input = arg;
+        else {
+            cerr << "Usage: workloadexpand input.md [-o output.md]" << endl;
+            return 1;
+        }
+    }
+    if (input.empty()) {
+        cerr << "Usage: workloadexpand input.md [-o output.md]" << endl;
+        return 1;
+    }
+
+    try {
+        Workload w = ReadWorkload(input);
+        size_t classes = w.tasks.size();
+        ExpandWorkload(w);
+        if (output.empty()) {
+            WriteWorkload(cout, w);
+        } else {
+            ofstream out(output);
+            if (!out) throw runtime_error("could not write " + output);
+            WriteWorkload(out, w);
+        }
+        cerr << "workloadexpand: " << classes << " task classes expanded to " << w.tasks.size() << endl;
+    } catch (const exception & e) {
+        cerr << "workloadexpand: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
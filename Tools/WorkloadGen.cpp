@@ -0,0 +1,268 @@
+//
+//  WorkloadGen.cpp
+//  CloudSim
+//
+//  Generates synthetic workload files at sizes well beyond Test_Cases, for
+//  stressing the scheduler's per-VM and per-task loops. Output depends only on
+//  the parameters and the seed.
+//
+//  Usage: workloadgen [--preset name | --machines N --tasks N] [options] [-o file]
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "Arrivals.hpp"
+#include "Random.hpp"
+
+struct GenParams {
+    unsigned machines = 1000;
+    uint64_t tasks = 100000;
+    double horizon_s = 1800;                // Simulated seconds covered by arrivals
+    double utilization = 0.4;               // Offered load as a fraction of cluster core capacity
+    double gpu_ratio = 0.3;                 // Fraction of machines and tasks with GPUs
+    vector<double> cpu_mix = {0.4, 0.3, 0.1, 0.2};      // ARM, POWER, RISCV, X86 -- indexed by CPUType_t
+    vector<double> sla_mix = {0.2, 0.3, 0.3, 0.2};      // SLA0..SLA3
+    vector<double> vm_mix = {0.7, 0.1, 0.1, 0.1};       // LINUX, LINUX_RT, WIN, AIX
+    unsigned task_classes = 0;              // 0 picks a count from the size
+    string arrival = "constant";            // Arrival process written into each class (Arrivals.hpp)
+    string runtime = "constant";            // Runtime distribution written into each class
+    bool expand = false;                    // Emit plain one-task classes instead of extended ones
+    uint64_t seed = 520230;
+};
+
+// The preset ladder, smallest to largest. Tools/scaling_bench.sh -p walks it.
+struct Preset {
+    const char * name;
+    unsigned machines;
+    uint64_t tasks;
+    double horizon_s;
+};
+
+static const Preset presets[] = {
+    {"xs",   128,      10000,   600},
+    {"s",    1000,     100000,  1800},
+    {"m",    10000,    500000,  3600},
+    {"l",    50000,    1000000, 3600},
+    {"xl",   100000,   2000000, 3600},
+};
+
+// Hardware profiles per CPU type, modelled on the classes in Test_Cases
+struct Profile {
+    unsigned cores;
+    unsigned memory;
+    vector<unsigned> s_states, p_states, c_states, mips;
+};
+
+static vector<Profile> ProfilesFor(CPUType_t cpu) {
+    switch (cpu) {
+        case X86:
+            return {
+                {8,  16384,  {120, 100, 100, 80, 40, 10, 0}, {12, 8, 6, 4}, {12, 3, 1, 0}, {3000, 2400, 2000, 1500}},
+                {4,  8192,   {40, 20, 16, 12, 10, 4, 0},     {4, 2, 2, 1},  {4, 1, 1, 0},  {1500, 1200, 1000, 600}},
+            };
+        case ARM:
+            return {
+                {8,  16384,  {80, 40, 28, 20, 12, 8, 0},     {8, 4, 2, 1},  {8, 2, 1, 0},  {2000, 1500, 1200, 800}},
+                {16, 16384,  {120, 100, 100, 80, 40, 10, 0}, {12, 8, 6, 4}, {12, 3, 1, 0}, {1000, 800, 600, 400}},
+            };
+        case POWER:
+            return {
+                {32, 131072, {120, 60, 30, 15, 8, 4, 0},     {8, 4, 2, 1},  {8, 2, 1, 0},  {1500, 1200, 1000, 800}},
+            };
+        case RISCV:
+            return {
+                {8,  8192,   {40, 20, 16, 12, 10, 4, 0},     {4, 2, 2, 1},  {4, 1, 1, 0},  {1200, 1000, 800, 500}},
+            };
+    }
+    throw runtime_error("ProfilesFor(): unknown CPU type");
+}
+
+static const char * task_types[] = {"WEB", "AI", "HPC", "CRYPTO", "STREAM"};
+
+static vector<double> ParseMix(const string & arg, size_t n, const string & flag) {
+    vector<double> mix;
+    stringstream ss(arg);
+    string item;
+    while (getline(ss, item, ',')) mix.push_back(stod(item));
+    if (mix.size() != n) {
+        throw runtime_error(flag + " expects " + to_string(n) + " comma separated weights");
+    }
+    return mix;
+}
+
+static Workload Generate(const GenParams & p) {
+    Rng rng(p.seed);
+    Workload w;
+
+    // Machines: split the fleet across CPU types, then across profiles with and without GPUs
+    vector<unsigned> cores_per_cpu(4, 0);
+    unsigned assigned = 0;
+    for (unsigned c = 0; c < 4; c++) {
+        CPUType_t cpu = CPUType_t(c);
+        double share = p.cpu_mix[c] / (p.cpu_mix[0] + p.cpu_mix[1] + p.cpu_mix[2] + p.cpu_mix[3]);
+        unsigned count = (c == 3) ? p.machines - assigned : unsigned(p.machines * share);
+        assigned += count;
+        vector<Profile> profiles = ProfilesFor(cpu);
+        unsigned left = count;
+        for (size_t i = 0; i < profiles.size() && left > 0; i++) {
+            unsigned profile_count = (i + 1 == profiles.size()) ? left : left / unsigned(profiles.size() - i);
+            left -= profile_count;
+            unsigned gpu_count = unsigned(profile_count * p.gpu_ratio);
+            for (int gpu = 1; gpu >= 0; gpu--) {
+                unsigned n = gpu ? gpu_count : profile_count - gpu_count;
+                if (n == 0) continue;
+                const Profile & pr = profiles[i];
+                w.machines.push_back({n, cpu, pr.cores, pr.memory, pr.s_states, pr.p_states, pr.c_states, pr.mips, gpu == 1});
+                cores_per_cpu[c] += n * pr.cores;
+            }
+        }
+    }
+
+    // Tasks: route load to CPU types in proportion to their cores, so no type is starved or swamped
+    unsigned total_cores = 0;
+    for (unsigned c : cores_per_cpu) total_cores += c;
+    vector<double> cpu_weights(cores_per_cpu.begin(), cores_per_cpu.end());
+
+    unsigned classes = p.task_classes;
+    if (classes == 0) {
+        classes = unsigned(min<uint64_t>(256, max<uint64_t>(8, p.tasks / 5000)));
+    }
+    Time_t horizon = Time_t(p.horizon_s * 1000000);
+    double mean_runtime_us = p.utilization * total_cores * double(horizon) / double(max<uint64_t>(1, p.tasks));
+
+    uint64_t tasks_left = p.tasks;
+    for (unsigned i = 0; i < classes; i++) {
+        uint64_t class_tasks = tasks_left / (classes - i);
+        tasks_left -= class_tasks;
+        if (class_tasks == 0) continue;
+
+        TaskClass tc;
+        tc.cpu = CPUType_t(rng.Pick(cpu_weights));
+
+        vector<double> vm_weights = p.vm_mix;
+        for (unsigned v = 0; v < 4; v++) {
+            if (!IsVMCompatible(VMType_t(v), tc.cpu)) vm_weights[v] = 0;
+        }
+        if (vm_weights[LINUX] + vm_weights[LINUX_RT] + vm_weights[WIN] + vm_weights[AIX] <= 0) {
+            vm_weights[LINUX] = 1;
+        }
+        tc.vm  = VMType_t(rng.Pick(vm_weights));
+        tc.sla = SLAType_t(rng.Pick(p.sla_mix));
+        tc.gpu = rng.Uniform() < p.gpu_ratio;
+        tc.task_type = task_types[tc.gpu ? rng.Range(1, 2) : (rng.Next() % 2 ? 0 : rng.Range(3, 4))];
+
+        // Half the classes span the horizon, the others are bursts somewhere inside it
+        if (i % 2 == 0) {
+            tc.start = 60000;
+            tc.end = horizon;
+        } else {
+            Time_t len = Time_t(horizon * rng.Uniform(0.05, 0.3));
+            tc.start = 60000 + Time_t(rng.Uniform() * double(horizon - len));
+            tc.end = tc.start + len;
+        }
+        tc.inter_arrival = max<Time_t>(1, (tc.end - tc.start) / class_tasks);
+        tc.expected_runtime = Time_t(min(1.8e9, max(1e5, mean_runtime_us * rng.Uniform(0.5, 1.5))));
+        tc.memory = (tc.task_type == "HPC") ? 1024 : 8;
+        tc.seed = rng.Next() % 1000000000;
+
+        if (p.arrival != "constant") {
+            tc.extra["Arrival process"] = p.arrival;
+            if (p.arrival == "mmpp") {
+                // Bursts at four times the mean rate, a quarter of the time
+                tc.inter_arrival = max<Time_t>(1, tc.inter_arrival / 4);
+                tc.extra["On period"] = to_string(max<Time_t>(1, (tc.end - tc.start) / 40));
+                tc.extra["Off period"] = to_string(max<Time_t>(1, 3 * (tc.end - tc.start) / 40));
+            } else if (p.arrival == "diurnal") {
+                tc.extra["Diurnal period"] = to_string(horizon);
+            }
+        }
+        if (p.runtime != "constant") {
+            tc.extra["Runtime distribution"] = p.runtime;
+            tc.extra["Runtime cap"] = "1800000000";
+        }
+        w.tasks.push_back(tc);
+    }
+    if (p.expand) ExpandWorkload(w);
+    return w;
+}
+
+static void Usage() {
+    cerr << "Usage: workloadgen [--preset name | --machines N --tasks N] [options] [-o file]" << endl
+         << "  --horizon S        seconds of arrivals (default 1800)" << endl
+         << "  --utilization F    offered load / core capacity (default 0.4)" << endl
+         << "  --gpu-ratio F      share of GPU machines and GPU tasks (default 0.3)" << endl
+         << "  --cpu-mix a,p,r,x  weights for ARM, POWER, RISCV, X86" << endl
+         << "  --sla-mix a,b,c,d  weights for SLA0..SLA3" << endl
+         << "  --vm-mix l,r,w,a   weights for LINUX, LINUX_RT, WIN, AIX" << endl
+         << "  --classes N        number of task classes (default from size)" << endl
+         << "  --arrival P        constant, poisson, mmpp or diurnal (default constant)" << endl
+         << "  --runtime D        constant, pareto or lognormal (default constant)" << endl
+         << "  --expand           write one plain class per task (what the simulator reads)" << endl
+         << "  --seed N           generator seed (default 520230)" << endl
+         << "  --list-presets     print the preset ladder" << endl;
+}
+
+int main(int argc, char * argv[]) {
+    GenParams params;
+    string output;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            auto value = [&]() -> string {
+                if (i + 1 >= argc) throw runtime_error(arg + " needs a value");
+                return argv[++i];
+            };
+            if (arg == "--list-presets") {
+                for (auto & pr : presets) {
+                    cout << pr.name << " " << pr.machines << " " << pr.tasks << " " << pr.horizon_s << endl;
+                }
+                return 0;
+            } else if (arg == "--preset") {
+                string name = value();
+                auto it = find_if(begin(presets), end(presets), [&](const Preset & pr) { return name == pr.name; });
+                if (it == end(presets)) throw runtime_error("unknown preset " + name);
+                params.machines = it->machines;
+                params.tasks = it->tasks;
+                params.horizon_s = it->horizon_s;
+            }
+            else if (arg == "--machines")    params.machines = unsigned(stoul(value()));
+            else if (arg == "--tasks")       params.tasks = stoull(value());
+            else if (arg == "--horizon")     params.horizon_s = stod(value());
+            else if (arg == "--utilization") params.utilization = stod(value());
+            else if (arg == "--gpu-ratio")   params.gpu_ratio = stod(value());
+            else if (arg == "--cpu-mix")     params.cpu_mix = ParseMix(value(), 4, arg);
+            else if (arg == "--sla-mix")     params.sla_mix = ParseMix(value(), NUM_SLAS, arg);
+            else if (arg == "--vm-mix")      params.vm_mix = ParseMix(value(), 4, arg);
+            else if (arg == "--classes")     params.task_classes = unsigned(stoul(value()));
+            else if (arg == "--arrival")     params.arrival = value();
+            else if (arg == "--runtime")     params.runtime = value();
+            else if (arg == "--expand")      params.expand = true;
+            else if (arg == "--seed")        params.seed = stoull(value());
+            else if (arg == "-o")            output = value();
+            else {
+                Usage();
+                return 1;
+            }
+        }
+
+        Workload w = Generate(params);
+        if (output.empty()) {
+            WriteWorkload(cout, w);
+        } else {
+            ofstream out(output);
+            if (!out) throw runtime_error("could not write " + output);
+            WriteWorkload(out, w);
+        }
+        cerr << "workloadgen: " << w.TotalMachines() << " machines, " << w.machines.size() << " machine classes, "
+             << w.EstimatedTasks() << " tasks in " << w.tasks.size() << " task classes" << endl;
+    } catch (const exception & e) {
+        cerr << "workloadgen: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#!/bin/bash
+#
+#  scaling_bench.sh
+#  CloudSim
+#
+#  Measures how the scheduler's per-callback cost grows with cluster size and
+#  with concurrency. For every point it generates a workload with workloadgen,
+#  captures a callback trace from the simulator (CLOUDSIM_CAPTURE) and replays
+#  it with tracebench for p50/p90/p99 latencies per callback type. It then fits
+#  cost ~ x^k on a log-log scale for each callback, where x is what the sweep
+#  varies, and flags every callback whose exponent k exceeds 1 + tolerance.
+#  Points where a callback ran fewer than -n times are left out of its fit, so
+#  one-shot callbacks (InitScheduler, SimulationComplete) are never fitted.
+#
+#  Two sweeps:
+#      size         machines (tasks grow with them) at utilization -U; x is machines
+#      concurrency  utilization (tasks in flight) at the largest size; x is utilization
+#
+#  Usage: Tools/scaling_bench.sh [-m "64 128 256 512"] [-p "xs s"] [-u "0.2 0.4 0.8"]
+#                                [-U 0.4] [-k 80] [-n 20] [-t 0.15] [-o dir]
+#      -m  machine counts for the size sweep, with -k tasks per machine over 600 s
+#      -p  workloadgen presets for the size sweep instead of -m (see --list-presets)
+#      -n  calls of a callback a point needs to count in its fit
+#      -t  exponent tolerance above linear before a callback is flagged
+#      -o  directory for the workloads and results.csv (default: a temporary one)
+#
+
+SIZES="64 128 256 512"
+PRESETS=""
+UTILIZATIONS="0.2 0.4 0.8"
+SIZE_UTILIZATION=0.4
+TASKS_PER_MACHINE=80
+MIN_CALLS=20
+TOLERANCE=0.15
+OUT_DIR=""
+
+while getopts "m:p:u:U:k:n:t:o:" opt; do
+    case $opt in
+        m) SIZES="$OPTARG" ;;
+        p) PRESETS="$OPTARG" ;;
+        u) UTILIZATIONS="$OPTARG" ;;
+        U) SIZE_UTILIZATION="$OPTARG" ;;
+        k) TASKS_PER_MACHINE="$OPTARG" ;;
+        n) MIN_CALLS="$OPTARG" ;;
+        t) TOLERANCE="$OPTARG" ;;
+        o) OUT_DIR="$OPTARG" ;;
+        *)
+            sed -n '/^#  Usage/,/^#$/p' "$0" | sed 's/^#//'
+            exit 2
+            ;;
+    esac
+done
+
+make simulator tools > /dev/null || { echo "Error: build failed."; exit 1; }
+
+if [ -z "$OUT_DIR" ]; then
+    OUT_DIR=$(mktemp -d)
+else
+    mkdir -p "$OUT_DIR"
+fi
+RESULTS="$OUT_DIR/results.csv"
+echo "sweep,size,machines,tasks,utilization,callback,count,mean_ns,p50_ns,p90_ns,p99_ns,max_ns" > "$RESULTS"
+
+# measure SWEEP LABEL UTILIZATION workloadgen-size-arguments...
+measure() {
+    local sweep=$1 label=$2 utilization=$3
+    shift 3
+    local workload="$OUT_DIR/$label-u$utilization.md"
+    local trace="$OUT_DIR/$label-u$utilization.trace"
+    local summary
+    summary=$(Tools/bin/workloadgen "$@" --utilization "$utilization" -o "$workload" 2>&1) || { echo "$summary"; exit 1; }
+    local machines tasks
+    machines=$(echo "$summary" | sed -n 's/^workloadgen: \([0-9]*\) machines.*/\1/p')
+    tasks=$(echo "$summary" | sed -n 's/.* \([0-9]*\) tasks in.*/\1/p')
+    echo "$sweep: $label, $machines machines, $tasks tasks, utilization $utilization" >&2
+
+    CLOUDSIM_CAPTURE="$trace" ./simulator "$workload" > /dev/null 2>&1 || { echo "Error: simulator failed on $workload"; exit 1; }
+    Tools/bin/tracebench -c "$trace" | tail -n +2 | sed "s/^/$sweep,$label,$machines,$tasks,$utilization,/" >> "$RESULTS"
+    rm -f "$trace"
+}
+
+LARGEST=""
+if [ -n "$PRESETS" ]; then
+    for preset in $PRESETS; do
+        measure size "$preset" "$SIZE_UTILIZATION" --preset "$preset"
+        LARGEST="--preset $preset"
+    done
+else
+    for machines in $SIZES; do
+        measure size "$machines" "$SIZE_UTILIZATION" --machines "$machines" --tasks $((machines * TASKS_PER_MACHINE)) --horizon 600
+        LARGEST="--machines $machines --tasks $((machines * TASKS_PER_MACHINE)) --horizon 600"
+    done
+fi
+LARGEST_LABEL=$(echo "$LARGEST" | awk '{ print $2 }')
+for utilization in $UTILIZATIONS; do
+    measure concurrency "$LARGEST_LABEL" "$utilization" $LARGEST
+done
+
+# Least-squares slope of ln(ns) on ln(x) per sweep and callback, where x is
+# the machine count for the size sweep and the utilization for the concurrency
+# sweep, over the points with at least MIN_CALLS calls
+FITS=$(awk -F, -v tolerance="$TOLERANCE" -v min_calls="$MIN_CALLS" '
+    NR == 1 { next }
+    {
+        key = $1 SUBSEP $6
+        x = ($1 == "size") ? $3 : $5
+        if ($7 < min_calls || $9 <= 0 || x <= 0) next
+        n[key]++
+        lx = log(x)
+        for (i = 0; i < 2; i++) {
+            ly = log(i == 0 ? $9 : $11)
+            sx[key, i] += lx; sy[key, i] += ly; sxx[key, i] += lx * lx; sxy[key, i] += lx * ly
+        }
+    }
+    function slope(key, i,    d) {
+        d = n[key] * sxx[key, i] - sx[key, i] * sx[key, i]
+        return d == 0 ? 0 : (n[key] * sxy[key, i] - sx[key, i] * sy[key, i]) / d
+    }
+    END {
+        for (key in n) {
+            if (n[key] < 2) continue
+            split(key, part, SUBSEP)
+            k50 = slope(key, 0); k99 = slope(key, 1)
+            printf "%-12s %-12s %-24s %6d %10.2f %10.2f%s\n", part[1], (part[1] == "size") ? "machines" : "utilization",
+                   part[2], n[key], k50, k99, (k50 > 1 + tolerance) ? "  SUPER-LINEAR" : ""
+        }
+    }' "$RESULTS" | sort)
+
+echo
+printf "%-12s %-12s %-24s %6s %10s %10s\n" "Sweep" "Against" "Callback" "Points" "k (p50)" "k (p99)"
+echo "$FITS"
+echo
+echo "$(echo "$FITS" | grep -c SUPER-LINEAR) callbacks grow faster than linearly (k > 1 + $TOLERANCE); points with fewer than $MIN_CALLS calls left out"
+echo "Raw results: $RESULTS"
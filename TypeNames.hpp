@@ -0,0 +1,66 @@
+//
+//  TypeNames.hpp
+//  CloudSim
+//
+//  Names of the CPU, VM and SLA types as they appear in workload files and
+//  snapshots, shared by the simulator (Snapshot.cpp) and the tools
+//  (Tools/Workload.cpp). The Parse functions throw runtime_error on an
+//  unknown name.
+//
+
+#ifndef TypeNames_hpp
+#define TypeNames_hpp
+
+#include <stdexcept>
+#include <string>
+
+#include "SimTypes.h"
+
+inline string CPUName(CPUType_t cpu) {
+    switch (cpu) {
+        case ARM:   return "ARM";
+        case POWER: return "POWER";
+        case RISCV: return "RISCV";
+        case X86:   return "X86";
+    }
+    throw runtime_error("CPUName(): unknown CPU type " + to_string(cpu));
+}
+
+inline string SLAName(SLAType_t sla) {
+    return "SLA" + to_string(unsigned(sla));
+}
+
+inline string VMName(VMType_t vm) {
+    switch (vm) {
+        case LINUX:    return "LINUX";
+        case LINUX_RT: return "LINUX_RT";
+        case WIN:      return "WIN";
+        case AIX:      return "AIX";
+    }
+    throw runtime_error("VMName(): unknown VM type " + to_string(vm));
+}
+
+inline CPUType_t ParseCPU(const string & name) {
+    if (name == "ARM")   return ARM;
+    if (name == "POWER") return POWER;
+    if (name == "RISCV") return RISCV;
+    if (name == "X86")   return X86;
+    throw runtime_error("ParseCPU(): unknown CPU type '" + name + "'");
+}
+
+inline SLAType_t ParseSLA(const string & name) {
+    for (unsigned i = 0; i < NUM_SLAS; i++) {
+        if (name == SLAName(SLAType_t(i))) return SLAType_t(i);
+    }
+    throw runtime_error("ParseSLA(): unknown SLA '" + name + "'");
+}
+
+inline VMType_t ParseVM(const string & name) {
+    if (name == "LINUX")    return LINUX;
+    if (name == "LINUX_RT") return LINUX_RT;
+    if (name == "WIN")      return WIN;
+    if (name == "AIX")      return AIX;
+    throw runtime_error("ParseVM(): unknown VM type '" + name + "'");
+}
+
+#endif /* TypeNames_hpp */
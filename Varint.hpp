@@ -0,0 +1,65 @@
+//
+//  Varint.hpp
+//  CloudSim
+//
+//  LEB128 variable length integers, shared by the binary logs written during a
+//  run (decision logs, callback traces) and the tools that read them.
+//
+
+#ifndef Varint_hpp
+#define Varint_hpp
+
+#include <cstdint>
+#include <istream>
+#include <string>
+
+inline void PutVarint(std::string & out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+// Zigzag keeps small negative deltas small
+inline void PutSignedVarint(std::string & out, int64_t value) {
+    PutVarint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+inline bool GetVarint(std::istream & in, uint64_t & value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == EOF) return false;
+        value |= uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+inline bool GetSignedVarint(std::istream & in, int64_t & value) {
+    uint64_t raw;
+    if (!GetVarint(in, raw)) return false;
+    value = int64_t(raw >> 1) ^ -int64_t(raw & 1);
+    return true;
+}
+
+// The same from an in-memory buffer, advancing 'at'
+inline bool GetVarint(const std::string & in, size_t & at, uint64_t & value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && at < in.size(); shift += 7) {
+        unsigned char c = in[at++];
+        value |= uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+inline bool GetSignedVarint(const std::string & in, size_t & at, int64_t & value) {
+    uint64_t raw;
+    if (!GetVarint(in, at, raw)) return false;
+    value = int64_t(raw >> 1) ^ -int64_t(raw & 1);
+    return true;
+}
+
+#endif /* Varint_hpp */